@@ -0,0 +1,227 @@
+/*
+ * Allocation accounting for the instrumentation build (-DSEVENS_ALLOC_TRACKING).
+ *
+ * Every block handed out by operator new carries a 16-byte header (size, owner tag, thread)
+ * so that operator delete can give the bytes back to the strategy callback and the thread
+ * that allocated them, even when the block is freed from another callback or thread.
+ * Nothing in here may allocate with new.
+ */
+#ifdef SEVENS_ALLOC_TRACKING
+
+#include "AllocTracker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace sevens {
+
+namespace {
+
+constexpr uint32_t kMaxStrategies = 64;
+constexpr uint32_t kCallbacks = static_cast<uint32_t>(StrategyCallback::Count);
+constexpr uint32_t kMaxThreads = 1024;
+
+const char* const kCallbackNames[kCallbacks] = {
+    "(outside callbacks)", "initialize", "selectCardToPlay", "observeMove", "observePass"
+};
+
+struct Counter {
+    uint64_t count;
+    uint64_t bytes;
+    std::atomic<int64_t> live;   // also decremented by the threads freeing the blocks
+    int64_t peak;
+};
+
+struct ThreadCounters {
+    Counter c[kMaxStrategies][kCallbacks];
+};
+
+struct alignas(16) Header {
+    uint64_t size;
+    uint16_t tag;      // strategyId * kCallbacks + callback
+    uint16_t thread;   // slot of the allocating thread in threadBlocks (kNoSlot: none)
+    uint32_t offset;   // distance from the start of the raw block
+};
+static_assert(sizeof(Header) == 16, "allocation header must keep 16-byte alignment");
+static_assert(kMaxStrategies * kCallbacks <= 0xFFFF && kMaxThreads < 0xFFFF, "header fields too small");
+
+constexpr uint16_t kNoSlot = 0xFFFF;
+
+// Per-thread state: trivially initialized so it is usable from any allocation
+thread_local uint32_t currentTag = 0;
+thread_local ThreadCounters* localCounters = nullptr;
+thread_local uint16_t localSlot = kNoSlot;
+
+// Blocks of all threads that ever allocated (kept after thread exit for the report)
+std::atomic<ThreadCounters*> threadBlocks[kMaxThreads];
+std::atomic<uint32_t> threadCount{0};
+
+// Strategy names, id 0 is the engine itself
+std::mutex namesMutex;
+char strategyNames[kMaxStrategies][64] = {"(engine)"};
+std::atomic<uint32_t> strategyCount{1};
+
+ThreadCounters* counters() {
+    if (!localCounters) {
+        void* mem = std::calloc(1, sizeof(ThreadCounters));
+        if (!mem) return nullptr;
+        localCounters = new (mem) ThreadCounters;   // zeroed by calloc
+        uint32_t slot = threadCount.fetch_add(1);
+        if (slot < kMaxThreads) {
+            threadBlocks[slot].store(localCounters);
+            localSlot = static_cast<uint16_t>(slot);
+        }
+    }
+    return localCounters;
+}
+
+void recordAlloc(uint32_t tag, uint64_t size) {
+    ThreadCounters* tc = counters();
+    if (!tc) return;
+    Counter& c = tc->c[tag / kCallbacks][tag % kCallbacks];
+    c.count++;
+    c.bytes += size;
+    const int64_t live = c.live.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) +
+                         static_cast<int64_t>(size);
+    c.peak = std::max(c.peak, live);
+}
+
+// Gives the bytes back to the counters of the thread that allocated them
+void recordFree(uint32_t tag, uint16_t thread, uint64_t size) {
+    ThreadCounters* tc = thread == kNoSlot ? counters() : threadBlocks[thread].load();
+    if (!tc) return;
+    tc->c[tag / kCallbacks][tag % kCallbacks].live.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+}
+
+void* trackedAlloc(std::size_t size, std::size_t align) {
+    const std::size_t headerSpace = std::max<std::size_t>(sizeof(Header), align);
+    void* raw;
+    if (align <= alignof(std::max_align_t)) {
+        raw = std::malloc(size + headerSpace);
+    } else {
+        std::size_t total = (size + headerSpace + align - 1) / align * align;
+        raw = std::aligned_alloc(align, total);
+    }
+    if (!raw) return nullptr;
+
+    char* p = static_cast<char*>(raw) + headerSpace;
+    Header* h = reinterpret_cast<Header*>(p - sizeof(Header));
+    h->size = size;
+    h->tag = static_cast<uint16_t>(currentTag);
+    h->offset = static_cast<uint32_t>(headerSpace);
+    recordAlloc(h->tag, size);
+    h->thread = localSlot;   // set by counters()
+    return p;
+}
+
+void trackedFree(void* p) {
+    if (!p) return;
+    Header* h = reinterpret_cast<Header*>(static_cast<char*>(p) - sizeof(Header));
+    recordFree(h->tag, h->thread, h->size);
+    std::free(static_cast<char*>(p) - h->offset);
+}
+
+void* trackedNew(std::size_t size, std::size_t align) {
+    void* p = trackedAlloc(size, align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+// Prints the report when the program ends
+struct ReportAtExit {
+    ~ReportAtExit() { AllocTracker::report(); }
+} reportAtExit;
+
+} // namespace
+
+uint32_t AllocTracker::strategyId(const std::string& name) {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    uint32_t n = strategyCount.load();
+    for (uint32_t i = 1; i < n; ++i) {
+        if (name == strategyNames[i]) return i;
+    }
+    if (n == kMaxStrategies) return 0;   // table full: counted as engine
+    std::strncpy(strategyNames[n], name.c_str(), sizeof(strategyNames[n]) - 1);
+    strategyCount.store(n + 1);
+    return n;
+}
+
+void AllocTracker::report() {
+    static Counter total[kMaxStrategies][kCallbacks];
+    std::memset(total, 0, sizeof(total));
+
+    uint32_t threads = std::min(threadCount.load(), kMaxThreads);
+    for (uint32_t t = 0; t < threads; ++t) {
+        ThreadCounters* tc = threadBlocks[t].load();
+        if (!tc) continue;
+        for (uint32_t s = 0; s < kMaxStrategies; ++s) {
+            for (uint32_t cb = 0; cb < kCallbacks; ++cb) {
+                const Counter& c = tc->c[s][cb];
+                total[s][cb].count += c.count;
+                total[s][cb].bytes += c.bytes;
+                total[s][cb].peak = std::max(total[s][cb].peak, c.peak);   // worst thread
+            }
+        }
+    }
+
+    std::fprintf(stderr, "\n=== Allocation report (%u threads) ===\n", threads);
+    std::fprintf(stderr, "%-28s %-20s %14s %16s %14s %12s\n",
+                 "Strategy", "Callback", "allocs", "bytes", "peak live", "bytes/alloc");
+    for (uint32_t s = 0; s < strategyCount.load(); ++s) {
+        for (uint32_t cb = 0; cb < kCallbacks; ++cb) {
+            const Counter& c = total[s][cb];
+            if (c.count == 0) continue;
+            std::fprintf(stderr, "%-28s %-20s %14llu %16llu %14lld %12.1f\n",
+                         strategyNames[s], kCallbackNames[cb],
+                         static_cast<unsigned long long>(c.count),
+                         static_cast<unsigned long long>(c.bytes),
+                         static_cast<long long>(c.peak),
+                         static_cast<double>(c.bytes) / c.count);
+        }
+    }
+}
+
+AllocScope::AllocScope(uint32_t strategyId, StrategyCallback callback) : saved(currentTag) {
+    currentTag = strategyId * kCallbacks + static_cast<uint32_t>(callback);
+}
+
+AllocScope::~AllocScope() {
+    currentTag = saved;
+}
+
+} // namespace sevens
+
+// -----------------------------------------------------------------------------
+// Global operator new / delete replacements
+// -----------------------------------------------------------------------------
+
+void* operator new(std::size_t size) { return sevens::trackedNew(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return sevens::trackedNew(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t al) { return sevens::trackedNew(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al) { return sevens::trackedNew(size, static_cast<std::size_t>(al)); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return sevens::trackedAlloc(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return sevens::trackedAlloc(size, alignof(std::max_align_t));
+}
+
+void operator delete(void* p) noexcept { sevens::trackedFree(p); }
+void operator delete[](void* p) noexcept { sevens::trackedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { sevens::trackedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { sevens::trackedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { sevens::trackedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { sevens::trackedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { sevens::trackedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { sevens::trackedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { sevens::trackedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { sevens::trackedFree(p); }
+
+#endif // SEVENS_ALLOC_TRACKING
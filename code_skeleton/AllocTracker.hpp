@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace sevens {
+
+/**
+ * Strategy callbacks allocations are attributed to.
+ */
+enum class StrategyCallback : uint32_t {
+    None = 0,            // engine / outside any strategy callback
+    Initialize,
+    SelectCardToPlay,
+    ObserveMove,
+    ObservePass,
+    Count
+};
+
+#ifdef SEVENS_ALLOC_TRACKING
+
+/**
+ * Allocation accounting (instrumentation build only, compile with -DSEVENS_ALLOC_TRACKING
+ * and add AllocTracker.cpp, see HowToCompile.txt).
+ *
+ * AllocTracker.cpp replaces the global operator new/delete, also for the strategies loaded
+ * with dlopen. Counters are thread-local; every allocation is tagged with the strategy and
+ * callback active on its thread (AllocScope), and a block freed on another thread is given
+ * back to the thread that allocated it. A per-strategy report (count, bytes, peak live
+ * bytes per callback, worst thread) is printed on stderr when the program exits.
+ */
+class AllocTracker {
+public:
+    static constexpr bool enabled = true;
+
+    // Id used to attribute allocations to a strategy (same name → same id)
+    static uint32_t strategyId(const std::string& name);
+
+    // Explicit report (also done automatically at exit)
+    static void report();
+};
+
+// Marks the strategy callback running on this thread for the lifetime of the scope
+class AllocScope {
+public:
+    AllocScope(uint32_t strategyId, StrategyCallback callback);
+    ~AllocScope();
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+    uint32_t saved;
+};
+
+#else
+
+// Regular build: no accounting, scopes compile to nothing
+class AllocTracker {
+public:
+    static constexpr bool enabled = false;
+    static uint32_t strategyId(const std::string&) { return 0; }
+    static void report() {}
+};
+
+class AllocScope {
+public:
+    AllocScope(uint32_t, StrategyCallback) {}
+};
+
+#endif
+
+} // namespace sevens
@@ -0,0 +1,750 @@
+/*
+ * sevens_bench : micro-benchmarks for the rule check, the strategies' decisions,
+ * dealing/shuffling and complete games.
+ *
+ * The scale/ family plays the generalized engine (VariantGame.hpp) for 1 to 4 decks and
+ * 4 to 16 players, to show how games/s follows the size of the bitset state.
+ *
+ * Every benchmark is auto-calibrated so that one repetition lasts --min-time ms,
+ * runs --warmup discarded repetitions, then --reps measured ones on a pinned thread.
+ * The summary reports median / mean / stddev / min in ns per operation and a 95%
+ * confidence interval of the median (order statistics), so two runs can be compared
+ * with --csv / --compare : a difference is only reported when the intervals are disjoint.
+ */
+#include "MyGameMapper.hpp"
+#include "StrategyLoader.hpp"
+#include "SevensRules.hpp"
+#include "StaticGame.hpp"
+#include "BuiltinStrategies.hpp"
+#include "VariantGame.hpp"
+#include "DealCorpus.hpp"
+#include "Symmetry.hpp"
+#include "TableIndex.hpp"
+#include "Tablebase.hpp"
+#include "Features.hpp"
+#include "PolicyModel.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace sevens;
+
+// -----------------------------------------------------------------------------
+// Harness
+// -----------------------------------------------------------------------------
+
+struct BenchOptions {
+    int reps = 15;
+    int warmup = 3;
+    double minTimeMs = 20.0;
+    int cpu = -2;            // -2 : current cpu, -1 : no pinning
+    uint64_t seed = 20250519;
+    std::string filter;
+    std::string strategyDir = ".";
+    std::string csvPath;
+    std::string comparePath;
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t opsPerRep = 0;
+    std::vector<double> nsPerOp;   // one sample per measured repetition
+
+    double median = 0, mean = 0, stddev = 0, min = 0, ciLow = 0, ciHigh = 0;
+};
+
+// Keep the optimizer from discarding a computed value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    __asm__ __volatile__("" : : "g"(value) : "memory");
+}
+
+// Swallows std::cout while games run (the engine logs its setup)
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+class CoutSilencer {
+public:
+    CoutSilencer() : old(std::cout.rdbuf(&sink)) {}
+    ~CoutSilencer() { std::cout.rdbuf(old); }
+private:
+    NullBuffer sink;
+    std::streambuf* old;
+};
+
+bool pinCurrentThread(int cpu) {
+    if (cpu == -1) return false;
+    if (cpu == -2) cpu = sched_getcpu();
+    if (cpu < 0) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+void summarize(BenchResult& r) {
+    std::vector<double> s = r.nsPerOp;
+    std::sort(s.begin(), s.end());
+    const size_t n = s.size();
+    r.min = s.front();
+    r.median = (n % 2) ? s[n / 2] : 0.5 * (s[n / 2 - 1] + s[n / 2]);
+    double sum = 0;
+    for (double v : s) sum += v;
+    r.mean = sum / n;
+    double sq = 0;
+    for (double v : s) sq += (v - r.mean) * (v - r.mean);
+    r.stddev = (n > 1) ? std::sqrt(sq / (n - 1)) : 0.0;
+
+    // Distribution-free 95% interval of the median: ranks n/2 -+ 0.98*sqrt(n)
+    double half = 0.98 * std::sqrt(static_cast<double>(n));
+    long lo = static_cast<long>(std::floor(n / 2.0 - half));
+    long hi = static_cast<long>(std::ceil(n / 2.0 + half));
+    lo = std::max(0L, lo);
+    hi = std::min(static_cast<long>(n) - 1, hi);
+    r.ciLow = s[lo];
+    r.ciHigh = s[hi];
+}
+
+/**
+ * Runs `body(iterations)` until one repetition lasts minTimeMs, then does the
+ * warm-up and measured repetitions. `body` must perform exactly `iterations` ops.
+ */
+BenchResult runBenchmark(const BenchOptions& opt, const std::string& name,
+                         const std::function<void(uint64_t)>& body)
+{
+    using clock = std::chrono::steady_clock;
+    auto timeIt = [&](uint64_t iters) {
+        auto t0 = clock::now();
+        body(iters);
+        return std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+    };
+
+    // Calibration (doubles as the first warm-up)
+    uint64_t iters = 1;
+    const double target = opt.minTimeMs * 1e6;
+    for (;;) {
+        double ns = timeIt(iters);
+        if (ns >= target || iters >= (1ull << 40)) break;
+        double scale = (ns > 0) ? target / ns : 16.0;
+        iters = static_cast<uint64_t>(std::max(2.0, std::min(16.0, scale * 1.2)) * iters);
+    }
+
+    for (int w = 0; w < opt.warmup; ++w) timeIt(iters);
+
+    BenchResult r;
+    r.name = name;
+    r.opsPerRep = iters;
+    for (int i = 0; i < opt.reps; ++i) r.nsPerOp.push_back(timeIt(iters) / iters);
+    summarize(r);
+    return r;
+}
+
+// -----------------------------------------------------------------------------
+// Fixed corpora
+// -----------------------------------------------------------------------------
+
+struct GameState {
+    std::vector<Card> hand;
+    TableLayout table;
+};
+
+std::vector<Card> standardDeck() {
+    std::vector<Card> deck;
+    for (int suit = 0; suit < 4; ++suit)
+        for (int rank = 1; rank <= 13; ++rank) deck.push_back(Card{suit, rank});
+    return deck;
+}
+
+/**
+ * Decision points collected from random-legal games played with a fixed seed:
+ * the same seed always produces the same corpus, whatever the strategies are.
+ */
+std::vector<GameState> buildStateCorpus(uint64_t seed, size_t count, uint64_t nP) {
+    std::mt19937_64 gen(seed);
+    std::vector<GameState> corpus;
+    corpus.reserve(count);
+
+    while (corpus.size() < count) {
+        std::vector<Card> deck = standardDeck();
+        std::shuffle(deck.begin(), deck.end(), gen);
+        std::vector<std::vector<Card>> hands(nP);
+        for (size_t i = 0; i < deck.size(); ++i) {
+            if (deck[i].suit == 2 && deck[i].rank == 7) continue;   // 7♦ starts on the table
+            hands[i % nP].push_back(deck[i]);
+        }
+        TableLayout table;
+        table[2][7] = true;
+
+        uint64_t current = gen() % nP;
+        uint64_t passesInRow = 0;
+        while (passesInRow < nP && corpus.size() < count) {
+            auto& hand = hands[current];
+            corpus.push_back(GameState{hand, table});
+
+            std::vector<size_t> legal;
+            for (size_t i = 0; i < hand.size(); ++i)
+                if (isPlayable(hand[i], table)) legal.push_back(i);
+
+            if (legal.empty()) {
+                ++passesInRow;
+            } else {
+                size_t pick = legal[gen() % legal.size()];
+                table[hand[pick].suit][hand[pick].rank] = true;
+                hand.erase(hand.begin() + pick);
+                passesInRow = 0;
+                if (hand.empty()) break;
+            }
+            current = (current + 1) % nP;
+        }
+    }
+    return corpus;
+}
+
+// -----------------------------------------------------------------------------
+// Benchmarks
+// -----------------------------------------------------------------------------
+
+const std::vector<std::string> kShippedStrategies = {
+    "RandomAgressiveStrategy", "PrudentStrategy", "CalculativeStrategy", "Sentinel7"
+};
+
+std::string libraryPath(const BenchOptions& opt, const std::string& name) {
+    return opt.strategyDir + "/" + name + ".so";
+}
+
+std::shared_ptr<PlayerStrategy> tryLoad(const BenchOptions& opt, const std::string& name) {
+    try {
+        CoutSilencer quiet;
+        return StrategyLoader::loadFromLibrary(libraryPath(opt, name));
+    } catch (const std::exception& e) {
+        std::cerr << "[sevens_bench] skipping " << name << " : " << e.what() << '\n';
+        return nullptr;
+    }
+}
+
+bool selected(const BenchOptions& opt, const std::string& name) {
+    return opt.filter.empty() || name.find(opt.filter) != std::string::npos;
+}
+
+void benchRules(const BenchOptions& opt, const std::vector<GameState>& corpus,
+                std::vector<BenchResult>& out)
+{
+    // Flatten (card, table) pairs so one op = one isPlayable call
+    std::vector<std::pair<Card, const TableLayout*>> checks;
+    for (const auto& st : corpus)
+        for (const auto& c : st.hand) checks.emplace_back(c, &st.table);
+
+    const std::string name = "rules/isPlayable";
+    if (!selected(opt, name)) return;
+    out.push_back(runBenchmark(opt, name, [&](uint64_t iters) {
+        size_t i = 0;
+        int playable = 0;
+        for (uint64_t k = 0; k < iters; ++k) {
+            playable += isPlayable(checks[i].first, *checks[i].second);
+            if (++i == checks.size()) i = 0;
+        }
+        doNotOptimize(playable);
+    }));
+}
+
+void benchStrategies(const BenchOptions& opt, const std::vector<GameState>& corpus,
+                     std::vector<BenchResult>& out)
+{
+    for (const auto& stratName : kShippedStrategies) {
+        const std::string name = "select/" + stratName;
+        if (!selected(opt, name)) continue;
+        auto strat = tryLoad(opt, stratName);
+        if (!strat) continue;
+        strat->initialize(1);
+
+        out.push_back(runBenchmark(opt, name, [&](uint64_t iters) {
+            size_t i = 0;
+            int acc = 0;
+            for (uint64_t k = 0; k < iters; ++k) {
+                acc += strat->selectCardToPlay(corpus[i].hand, corpus[i].table);
+                if (++i == corpus.size()) i = 0;
+            }
+            doNotOptimize(acc);
+        }));
+    }
+}
+
+void benchDealing(const BenchOptions& opt, std::vector<BenchResult>& out) {
+    for (uint64_t nP : {3u, 4u}) {
+        const std::string name = "deal/shuffle+deal " + std::to_string(nP) + "p";
+        if (!selected(opt, name)) continue;
+        std::mt19937 rng(static_cast<std::mt19937::result_type>(opt.seed));
+        const std::vector<Card> reference = standardDeck();
+        std::vector<Card> deck;
+        std::vector<std::vector<Card>> hands(nP);
+
+        out.push_back(runBenchmark(opt, name, [&](uint64_t iters) {
+            for (uint64_t k = 0; k < iters; ++k) {
+                deck = reference;
+                std::shuffle(deck.begin(), deck.end(), rng);
+                for (auto& h : hands) h.clear();
+                uint64_t start = rng() % nP;
+                for (size_t i = 0; i < deck.size(); ++i) hands[(start + i) % nP].push_back(deck[i]);
+                doNotOptimize(hands[0].data());
+            }
+        }));
+    }
+
+    // Same hands read from a mapped deal corpus (what batch --deals does), no shuffling
+    const std::string name = "deal/corpus 4p";
+    if (!selected(opt, name)) return;
+    const std::string path = (std::filesystem::temp_directory_path() / "sevens_bench_deals.svd").string();
+    DealCorpus::generate(path, 65536, 4, opt.seed);
+    {
+        DealCorpus corpus(path);
+        std::vector<std::vector<Card>> hands(4);
+        uint64_t next = 0;
+        out.push_back(runBenchmark(opt, name, [&](uint64_t iters) {
+            for (uint64_t k = 0; k < iters; ++k) {
+                const DealCorpus::Deal deal = corpus.deal(next++ % corpus.size());
+                for (auto& h : hands) h.clear();
+                for (int id = 0; id < 52; ++id) {
+                    unsigned owner = deal.owner(id);
+                    if (owner < 4) hands[owner].push_back(Card{id / 13, id % 13 + 1});
+                }
+                doNotOptimize(hands[0].data());
+            }
+        }));
+    }
+    std::remove(path.c_str());
+}
+
+// Canonical hash of mid-game positions under suit symmetry (Symmetry.hpp)
+void benchSymmetry(const BenchOptions& opt, std::vector<BenchResult>& out) {
+    const std::string name = "sym/canonical hash 4p";
+    if (!selected(opt, name)) return;
+
+    std::mt19937_64 rng(opt.seed);
+    std::vector<Position> positions(4096);
+    std::vector<int> ids(52);
+    for (Position& p : positions) {
+        for (int i = 0; i < 52; ++i) ids[i] = i;
+        std::shuffle(ids.begin(), ids.end(), rng);
+        const int onTable = 1 + static_cast<int>(rng() % 30);
+        p.hands.assign(4, 0);
+        for (int i = 0; i < 52; ++i) {
+            if (i < onTable) p.table |= 1ull << ids[i];
+            else p.hands[i % 4] |= 1ull << ids[i];
+        }
+    }
+
+    size_t next = 0;
+    out.push_back(runBenchmark(opt, name, [&](uint64_t iters) {
+        for (uint64_t k = 0; k < iters; ++k) {
+            const Position& p = positions[next++ & 4095];
+            doNotOptimize(SuitSymmetry::hash(p, SuitSymmetry::kPositionSuits));
+        }
+    }));
+}
+
+// Dense numbering of tables (TableIndex.hpp): rank of tables reached by random play, and back
+void benchTableIndex(const BenchOptions& opt, std::vector<BenchResult>& out) {
+    const std::string name = "table/rank+unrank";
+    if (!selected(opt, name)) return;
+
+    const TableIndex index;
+    std::mt19937_64 rng(opt.seed);
+    std::vector<uint64_t> tables;
+    while (tables.size() < 4096) {
+        CardSet<1> table;
+        table.set(32);   // 7♦
+        for (unsigned k = static_cast<unsigned>(rng() % 45); k; --k) {
+            CardSet<1> playable = table.playableOn();
+            table.set(playable.nth(static_cast<unsigned>(rng() % playable.count())));
+        }
+        tables.push_back(table.word(0));
+    }
+
+    size_t next = 0;
+    out.push_back(runBenchmark(opt, name, [&](uint64_t iters) {
+        uint64_t back = 0;
+        for (uint64_t k = 0; k < iters; ++k) {
+            index.unrank(index.rank(&tables[next++ & 4095]), &back);
+            doNotOptimize(back);
+        }
+    }));
+}
+
+// Standard feature vectors (Features.hpp) of decisions reached by random play: one decision
+// (state and every move), and the state vectors alone extracted in batches of 256
+void benchFeatures(const BenchOptions& opt, std::vector<BenchResult>& out) {
+    std::mt19937_64 rng(opt.seed);
+    std::vector<FeatureInput> inputs;
+    std::vector<int> ids;
+    while (inputs.size() < 4096) {
+        CardSet<1> table;
+        table.set(32);   // 7♦
+        for (unsigned k = static_cast<unsigned>(rng() % 40); k; --k) {
+            CardSet<1> playable = table.playableOn();
+            table.set(playable.nth(static_cast<unsigned>(rng() % playable.count())));
+        }
+        ids.clear();
+        for (int id = 0; id < 52; ++id) {
+            if (!table.test(id)) ids.push_back(id);
+        }
+        std::shuffle(ids.begin(), ids.end(), rng);
+        FeatureInput in;
+        in.table = table.word(0);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (i % 4 == 0) in.hand |= 1ull << ids[i];
+            in.handSizes[i % 4]++;
+        }
+        for (unsigned p = 0; p < 4; ++p) in.passes[p] = static_cast<uint8_t>(rng() % 3);
+        inputs.push_back(in);
+    }
+
+    const std::string decisionName = "feat/decision 4p";
+    if (selected(opt, decisionName)) {
+        std::vector<float> vec(Features::kMaxMoves * Features::kInputs);
+        int cards[Features::kMaxMoves];
+        size_t next = 0;
+        out.push_back(runBenchmark(opt, decisionName, [&](uint64_t iters) {
+            for (uint64_t k = 0; k < iters; ++k) {
+                doNotOptimize(Features::decision(inputs[next++ & 4095], vec.data(), cards));
+                doNotOptimize(vec[0]);
+            }
+        }));
+    }
+
+    const std::string batchName = "feat/states x256 4p";
+    if (selected(opt, batchName)) {
+        std::vector<float> vec(256 * Features::kState);
+        size_t next = 0;
+        out.push_back(runBenchmark(opt, batchName, [&](uint64_t iters) {
+            for (uint64_t k = 0; k < iters; ++k) {
+                Features::states(&inputs[(next += 256) & 4095], 256, vec.data());
+                doNotOptimize(vec[0]);
+            }
+        }));
+    }
+
+    // Whole decisions of LearnedStrategy (features + scores), random weights
+    std::normal_distribution<float> weight(0.0f, 0.2f);
+    auto randomModel = [&](unsigned hidden, bool quantize) {
+        std::vector<float> w1(Features::kInputs * (hidden ? hidden : 1)), b1(hidden), w2(hidden);
+        for (float& w : w1) w = weight(rng);
+        for (float& w : b1) w = weight(rng);
+        for (float& w : w2) w = weight(rng);
+        return PolicyModel(hidden, w1, b1, w2, 0.0f, quantize);
+    };
+    const std::pair<std::string, std::pair<unsigned, bool>> models[] = {
+        {"policy/choose linear", {0, false}},
+        {"policy/choose mlp32", {32, false}},
+        {"policy/choose mlp32 int8", {32, true}},
+        {"policy/choose mlp128", {128, false}},
+        {"policy/choose mlp128 int8", {128, true}},
+    };
+    for (const auto& m : models) {
+        if (!selected(opt, m.first)) continue;
+        const PolicyModel model = randomModel(m.second.first, m.second.second);
+        size_t next = 0;
+        out.push_back(runBenchmark(opt, m.first, [&](uint64_t iters) {
+            for (uint64_t k = 0; k < iters; ++k) doNotOptimize(model.choose(inputs[next++ & 4095]));
+        }));
+    }
+}
+
+// Endgame tablebase lookups (Tablebase.hpp) on positions reached by random play
+void benchTablebase(const BenchOptions& opt, std::vector<BenchResult>& out) {
+    const std::string name = "tb/probe 3p 6 cards";
+    if (!selected(opt, name)) return;
+    const unsigned nP = 3, maxCards = 6;
+    const std::string path = (std::filesystem::temp_directory_path() / "sevens_bench_endgame.svt").string();
+    Tablebase::generate(path, nP, maxCards);
+    {
+        Tablebase tb(path);
+        struct Endgame {
+            std::array<uint64_t, 3> hands;
+            unsigned toMove;
+            unsigned passes;
+        };
+        std::vector<Endgame> endgames;
+        std::mt19937_64 rng(opt.seed);
+        std::vector<int> pack;
+        while (endgames.size() < 4096) {
+            pack.clear();
+            for (int id = 0; id < 52; ++id) if (id != 32) pack.push_back(id);   // 7♦ on the table
+            std::shuffle(pack.begin(), pack.end(), rng);
+            Endgame e{{}, static_cast<unsigned>(rng() % nP), 0};
+            for (size_t i = 0; i < pack.size(); ++i) e.hands[i % nP] |= 1ull << pack[i];
+            CardSet<1> table;
+            table.set(32);
+            unsigned left = static_cast<unsigned>(pack.size());
+            while (left > maxCards && e.passes < nP) {
+                uint64_t playable = e.hands[e.toMove] & table.playableOn().word(0);
+                if (playable && rng() % 8) {
+                    for (unsigned k = static_cast<unsigned>(rng() % __builtin_popcountll(playable)); k; --k) {
+                        playable &= playable - 1;
+                    }
+                    const int card = __builtin_ctzll(playable);
+                    e.hands[e.toMove] &= ~(1ull << card);
+                    table.set(card);
+                    --left;
+                    e.passes = 0;
+                    if (!e.hands[e.toMove]) break;
+                } else {
+                    ++e.passes;
+                }
+                e.toMove = (e.toMove + 1) % nP;
+            }
+            Tablebase::Outcome o;
+            if (left <= maxCards && tb.probe(e.hands.data(), e.toMove, e.passes, o)) endgames.push_back(e);
+        }
+
+        size_t next = 0;
+        out.push_back(runBenchmark(opt, name, [&](uint64_t iters) {
+            Tablebase::Outcome o;
+            for (uint64_t k = 0; k < iters; ++k) {
+                const Endgame& e = endgames[next++ & 4095];
+                doNotOptimize(tb.probe(e.hands.data(), e.toMove, e.passes, o));
+            }
+        }));
+    }
+    std::remove(path.c_str());
+}
+
+void benchGames(const BenchOptions& opt, std::vector<BenchResult>& out) {
+    // Standard seatings: the README line-ups plus the internal / demo modes
+    const std::vector<std::pair<std::string, std::vector<std::string>>> seatings = {
+        {"internal 4x Random", {"RandomAgressiveStrategy", "RandomAgressiveStrategy",
+                                "RandomAgressiveStrategy", "RandomAgressiveStrategy"}},
+        {"demo Random/Calculative", {"RandomAgressiveStrategy", "CalculativeStrategy",
+                                     "RandomAgressiveStrategy", "CalculativeStrategy"}},
+        {"Sentinel7 + 2x Prudent", {"Sentinel7", "PrudentStrategy", "PrudentStrategy"}},
+        {"Sentinel7 + 2x Calculative", {"Sentinel7", "CalculativeStrategy", "CalculativeStrategy"}},
+        {"Sentinel7 + Prudent + Calculative + Random", {"Sentinel7", "PrudentStrategy",
+                                                        "CalculativeStrategy", "RandomAgressiveStrategy"}},
+    };
+
+    for (const auto& [label, seats] : seatings) {
+        const std::string name = "game/" + label;
+        if (!selected(opt, name)) continue;
+
+        MyGameMapper game;
+        game.seed(opt.seed);
+        bool complete = true;
+        for (size_t i = 0; i < seats.size() && complete; ++i) {
+            auto strat = tryLoad(opt, seats[i]);
+            if (!strat) { complete = false; break; }
+            game.registerStrategy(i, strat);
+        }
+        if (!complete) continue;
+
+        CoutSilencer quiet;
+        out.push_back(runBenchmark(opt, name, [&](uint64_t iters) {
+            for (uint64_t k = 0; k < iters; ++k) doNotOptimize(game.play_round(seats.size()).front());
+        }));
+    }
+}
+
+// Same seatings through the compile-time engine (builtin strategies, no dlopen)
+template <typename... S>
+void benchStaticSeating(const BenchOptions& opt, const std::string& label, std::vector<BenchResult>& out) {
+    const std::string name = "static/" + label;
+    if (!selected(opt, name)) return;
+    StaticGame<S...> game(opt.seed);
+    out.push_back(runBenchmark(opt, name, [&](uint64_t iters) {
+        for (uint64_t k = 0; k < iters; ++k) doNotOptimize(game.play()[0]);
+    }));
+}
+
+void benchStaticGames(const BenchOptions& opt, std::vector<BenchResult>& out) {
+    benchStaticSeating<RandomAgressiveStrategy, RandomAgressiveStrategy,
+                       RandomAgressiveStrategy, RandomAgressiveStrategy>(opt, "internal 4x Random", out);
+    benchStaticSeating<RandomAgressiveStrategy, CalculativeStrategy,
+                       RandomAgressiveStrategy, CalculativeStrategy>(opt, "demo Random/Calculative", out);
+    benchStaticSeating<Sentinel7, PrudentStrategy, PrudentStrategy>(opt, "Sentinel7 + 2x Prudent", out);
+    benchStaticSeating<Sentinel7, CalculativeStrategy, CalculativeStrategy>(opt, "Sentinel7 + 2x Calculative", out);
+    benchStaticSeating<Sentinel7, PrudentStrategy, CalculativeStrategy,
+                       RandomAgressiveStrategy>(opt, "Sentinel7 + Prudent + Calculative + Random", out);
+}
+
+// Generalized engine: games/s against the number of decks (bitset words) and players
+template <unsigned Decks>
+void benchScaleDecks(const BenchOptions& opt, std::vector<BenchResult>& out) {
+    for (unsigned players : {4u, 8u, 12u, 16u}) {
+        RulesConfig rules;
+        rules.decks = Decks;
+        rules.players = players;
+        rules.validate();
+        const std::string label = "scale/" + std::to_string(Decks) + " deck(s) x " + std::to_string(players) + " players";
+
+        // Engine alone: a random legal card for every player
+        if (selected(opt, label + " random")) {
+            VariantGame<Decks> game(rules);
+            RandomCardSeats<Decks> seats(opt.seed);
+            std::mt19937_64 rng(opt.seed);
+            out.push_back(runBenchmark(opt, label + " random", [&](uint64_t iters) {
+                for (uint64_t k = 0; k < iters; ++k) doNotOptimize(game.play(seats, rng)[0]);
+            }));
+        }
+
+        // Same tables with a Sentinel7 in every seat (strategy API: hands and TableLayout kept in step)
+        if (selected(opt, label + " Sentinel7")) {
+            std::vector<std::shared_ptr<PlayerStrategy>> strategies;
+            for (unsigned p = 0; p < players; ++p) {
+                auto s = std::make_shared<Sentinel7>();
+                s->seed(opt.seed + p);
+                strategies.push_back(s);
+            }
+            VariantGame<Decks> game(rules);
+            StrategySeats<Decks> seats(strategies);
+            std::mt19937_64 rng(opt.seed);
+            out.push_back(runBenchmark(opt, label + " Sentinel7", [&](uint64_t iters) {
+                for (uint64_t k = 0; k < iters; ++k) doNotOptimize(game.play(seats, rng)[0]);
+            }));
+        }
+    }
+}
+
+void benchScaling(const BenchOptions& opt, std::vector<BenchResult>& out) {
+    benchScaleDecks<1>(opt, out);
+    benchScaleDecks<2>(opt, out);
+    benchScaleDecks<3>(opt, out);
+    benchScaleDecks<4>(opt, out);
+}
+
+// -----------------------------------------------------------------------------
+// Reporting
+// -----------------------------------------------------------------------------
+
+struct Baseline {
+    double median, ciLow, ciHigh;
+};
+
+std::map<std::string, Baseline> readBaseline(const std::string& path) {
+    std::map<std::string, Baseline> base;
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line); // header
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        std::string name, field;
+        std::vector<double> values;
+        std::getline(ss, name, ',');
+        while (std::getline(ss, field, ',')) values.push_back(std::stod(field));
+        if (values.size() >= 7) base[name] = Baseline{values[1], values[5], values[6]};
+    }
+    return base;
+}
+
+void printReport(const std::vector<BenchResult>& results, const BenchOptions& opt) {
+    std::map<std::string, Baseline> base;
+    if (!opt.comparePath.empty()) base = readBaseline(opt.comparePath);
+
+    std::cout << std::left << std::setw(52) << "benchmark"
+              << std::right << std::setw(12) << "median ns" << std::setw(10) << "+-CI %"
+              << std::setw(12) << "stddev" << std::setw(12) << "min" << std::setw(14) << "ops/s";
+    if (!base.empty()) std::cout << std::setw(10) << "delta %" << "  verdict";
+    std::cout << '\n' << std::string(base.empty() ? 112 : 132, '-') << '\n';
+
+    std::cout << std::fixed;
+    for (const auto& r : results) {
+        double ciPct = 100.0 * 0.5 * (r.ciHigh - r.ciLow) / r.median;
+        std::cout << std::left << std::setw(52) << r.name << std::right << std::setprecision(1)
+                  << std::setw(12) << r.median << std::setw(10) << ciPct
+                  << std::setw(12) << r.stddev << std::setw(12) << r.min
+                  << std::setw(14) << std::setprecision(0) << 1e9 / r.median;
+        auto it = base.find(r.name);
+        if (it != base.end()) {
+            const Baseline& b = it->second;
+            const char* verdict = (r.ciLow > b.ciHigh) ? "REGRESSION"
+                                : (r.ciHigh < b.ciLow) ? "improvement" : "noise";
+            std::cout << std::setprecision(2) << std::setw(10) << 100.0 * (r.median - b.median) / b.median
+                      << "  " << verdict;
+        }
+        std::cout << '\n';
+    }
+}
+
+void writeCsv(const std::vector<BenchResult>& results, const std::string& path) {
+    std::ofstream out(path);
+    out << "name,ops_per_rep,median_ns,mean_ns,stddev_ns,min_ns,ci_low_ns,ci_high_ns\n";
+    out << std::setprecision(10);
+    for (const auto& r : results) {
+        out << r.name << ',' << r.opsPerRep << ',' << r.median << ',' << r.mean << ','
+            << r.stddev << ',' << r.min << ',' << r.ciLow << ',' << r.ciHigh << '\n';
+    }
+}
+
+void usage() {
+    std::cout << "Usage: ./sevens_bench [--reps N] [--warmup N] [--min-time MS] [--cpu K|-1]\n"
+                 "                      [--seed S] [--filter TEXT] [--strategy-dir DIR]\n"
+                 "                      [--csv out.csv] [--compare baseline.csv]\n";
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// MAIN
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    BenchOptions opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) { usage(); std::exit(1); }
+            return argv[++i];
+        };
+        if (arg == "--reps") opt.reps = std::max(1, std::stoi(next()));
+        else if (arg == "--warmup") opt.warmup = std::stoi(next());
+        else if (arg == "--min-time") opt.minTimeMs = std::stod(next());
+        else if (arg == "--cpu") opt.cpu = std::stoi(next());
+        else if (arg == "--seed") opt.seed = std::stoull(next());
+        else if (arg == "--filter") opt.filter = next();
+        else if (arg == "--strategy-dir") opt.strategyDir = next();
+        else if (arg == "--csv") opt.csvPath = next();
+        else if (arg == "--compare") opt.comparePath = next();
+        else { usage(); return arg == "--help" ? 0 : 1; }
+    }
+
+    bool pinned = pinCurrentThread(opt.cpu);
+    std::cout << "[sevens_bench] reps=" << opt.reps << " warmup=" << opt.warmup
+              << " min-time=" << opt.minTimeMs << "ms seed=" << opt.seed
+              << (pinned ? " pinned on cpu " + std::to_string(sched_getcpu()) : std::string(" unpinned"))
+              << "\n\n";
+
+    const std::vector<GameState> corpus = buildStateCorpus(opt.seed, 4096, 4);
+
+    std::vector<BenchResult> results;
+    benchRules(opt, corpus, results);
+    benchStrategies(opt, corpus, results);
+    benchDealing(opt, results);
+    benchSymmetry(opt, results);
+    benchTableIndex(opt, results);
+    benchTablebase(opt, results);
+    benchFeatures(opt, results);
+    benchGames(opt, results);
+    benchStaticGames(opt, results);
+    benchScaling(opt, results);
+
+    printReport(results, opt);
+    if (!opt.csvPath.empty()) writeCsv(results, opt.csvPath);
+    return 0;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "MatchRunner.hpp"
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Compact binary encoding shared by the checkpoints and the distributed protocol:
+ * integers as LEB128 varints, doubles as their exact bits (a resumed or distributed run
+ * must fold the very same ratings), strings and vectors prefixed with their length.
+ */
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::ostream& out) : out(out) {}
+
+    void u64(uint64_t v) {
+        char buf[10];
+        int n = 0;
+        while (v >= 0x80) {
+            buf[n++] = static_cast<char>((v & 0x7F) | 0x80);
+            v >>= 7;
+        }
+        buf[n++] = static_cast<char>(v);
+        out.write(buf, n);
+    }
+
+    void f64(double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        char buf[8];
+        for (int i = 0; i < 8; ++i) buf[i] = static_cast<char>(bits >> (8 * i));
+        out.write(buf, 8);
+    }
+
+    void str(const std::string& s) {
+        u64(s.size());
+        out.write(s.data(), s.size());
+    }
+
+    void vec(const std::vector<uint64_t>& v) {
+        u64(v.size());
+        for (uint64_t x : v) u64(x);
+    }
+
+    void outcome(const MatchOutcome& o) {
+        u64(o.matchId);
+        u64(o.seed);
+        vec(o.seatSpec);
+        u64(o.result.rounds);
+        vec(o.result.totals);
+        vec(o.result.wins);
+        vec(o.result.ties);
+        vec(o.result.ranks);
+    }
+
+private:
+    std::ostream& out;
+};
+
+/**
+ * Reads BinaryWriter data; any truncated or implausible value throws std::runtime_error
+ * prefixed with context.
+ */
+class BinaryReader {
+public:
+    static constexpr uint64_t kMaxLength = 1u << 20;
+
+    BinaryReader(std::istream& in, std::string context) : in(in), context(std::move(context)) {}
+
+    uint64_t u64() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int c = in.get();
+            if (c == std::char_traits<char>::eof()) fail("données tronquées");
+            v |= static_cast<uint64_t>(c & 0x7F) << shift;
+            if (!(c & 0x80)) return v;
+        }
+        fail("données corrompues");
+    }
+
+    double f64() {
+        unsigned char buf[8];
+        if (!in.read(reinterpret_cast<char*>(buf), 8)) fail("données tronquées");
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i) bits |= static_cast<uint64_t>(buf[i]) << (8 * i);
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+    std::string str() {
+        uint64_t n = length();
+        std::string s(n, '\0');
+        if (n && !in.read(&s[0], n)) fail("données tronquées");
+        return s;
+    }
+
+    std::vector<uint64_t> vec() {
+        std::vector<uint64_t> v(length());
+        for (uint64_t& x : v) x = u64();
+        return v;
+    }
+
+    MatchOutcome outcome() {
+        MatchOutcome o;
+        o.matchId = u64();
+        o.seed = u64();
+        o.seatSpec = vec();
+        o.result.rounds = u64();
+        o.result.totals = vec();
+        o.result.wins = vec();
+        o.result.ties = vec();
+        o.result.ranks = vec();
+        const size_t nP = o.seatSpec.size();
+        if (o.result.totals.size() != nP || o.result.wins.size() != nP ||
+            o.result.ties.size() != nP || o.result.ranks.size() != nP) {
+            fail("résultat de match incohérent");
+        }
+        return o;
+    }
+
+    [[noreturn]] void fail(const std::string& why) {
+        throw std::runtime_error(context + " : " + why);
+    }
+
+private:
+    std::istream& in;
+    std::string context;
+
+    uint64_t length() {
+        uint64_t n = u64();
+        if (n > kMaxLength) fail("données corrompues");
+        return n;
+    }
+};
+
+} // namespace sevens
@@ -0,0 +1,19 @@
+#pragma once
+
+/*
+ * Shipped strategies compiled straight into the binary (no dlopen).
+ * The strategy sources are included as-is; SEVENS_STATIC_STRATEGIES only removes their
+ * extern "C" createStrategy() so all of them can live in the same executable.
+ * The .so build of each strategy (HowToCompile.txt, step 2) is unchanged.
+ */
+#ifndef SEVENS_STATIC_STRATEGIES
+#define SEVENS_STATIC_STRATEGIES
+#endif
+
+#include "RandomAgressiveStrategy.cpp"
+#include "PrudentStrategy.cpp"
+#include "CalculativeStrategy.cpp"
+#include "Sentinel7.cpp"
+#include "LearnedStrategy.cpp"
+#include "CfrStrategy.cpp"
+#include "MonteCarloStrategy.cpp"
@@ -1,9 +1,9 @@
 #include "PlayerStrategy.hpp"
+#include "ScratchArena.hpp"
+#include "OpeningBook.hpp"
 #include <algorithm>
 #include <vector>
 #include <string>
-#include <map>
-#include <set>
 #include <unordered_map>
 #include <cmath>
 #include <random>
@@ -19,6 +19,7 @@ public:
             std::chrono::system_clock::now().time_since_epoch().count()
         );
         rng.seed(seed);
+        book = OpeningBook::active();
     }
 
     ~CalculativeStrategy() override = default;
@@ -27,13 +28,17 @@ public:
         myID = playerID;
         
         // Initialize data structures for tracking
-        playerHands.clear();
-        playerPasses.clear();
+        // (reset in place: the map nodes are kept from one game to the next)
+        for (auto& [id, cards] : playerHands) cards.clear();
+        for (auto& [id, passes] : playerPasses) passes = 0;
         playedCards.clear();
         
         // Track suits that players seem to have or lack
-        playerSuitStrengths.clear();
-        playerSuitWeaknesses.clear();
+        for (auto& [id, suits] : playerSuitStrengths) suits = 0;
+        for (auto& [id, suits] : playerSuitWeaknesses) suits = 0;
+        
+        openingHandSize = 0;
+        bookDecisions = 0;
     }
 
     int selectCardToPlay(
@@ -42,15 +47,13 @@ public:
     {
         // Update our tracked hand
         myHand = hand;
+        if (openingHandSize == 0) openingHandSize = hand.size();
         
-        // Track what suits we have
-        std::map<int, int> mySuitCounts;
-        for (const auto& card : hand) {
-            mySuitCounts[card.suit]++;
-        }
+        // Per-call temporaries live in the scratch arena (no heap allocation)
+        ScratchScope scratch;
         
         // Get all playable cards and their indices
-        std::vector<std::pair<int, Card>> playableCards;
+        std::pmr::vector<std::pair<int, Card>> playableCards(scratch.resource());
         for (size_t i = 0; i < hand.size(); ++i) {
             if (isPlayable(hand[i], tableLayout)) {
                 playableCards.emplace_back(static_cast<int>(i), hand[i]);
@@ -61,8 +64,17 @@ public:
             return -1; // No playable cards, must pass
         }
         
+        // First decisions of the round: the opening book, when one is loaded for this player count
+        if (book && bookDecisions < book->depth()) {
+            ++bookDecisions;
+            if (book->dealtFor(openingHandSize)) {
+                int idx = book->choose(hand, tableLayout);
+                if (idx >= 0) return idx;
+            }
+        }
+        
         // SCORING SYSTEM FOR EACH PLAYABLE CARD
-        std::vector<std::pair<double, int>> scoredMoves; // score, index
+        std::pmr::vector<std::pair<double, int>> scoredMoves(scratch.resource()); // score, index
         
         for (const auto& [idx, card] : playableCards) {
             double score = calculateMoveScore(card, hand, tableLayout);
@@ -77,7 +89,7 @@ public:
         // but within top 20% of scores to avoid being predictable
         if (scoredMoves.size() > 1) {
             double topScore = scoredMoves[0].first;
-            std::vector<int> topIndices;
+            std::pmr::vector<int> topIndices(scratch.resource());
             
             for (const auto& [score, idx] : scoredMoves) {
                 // Consider moves within 20% of the top score
@@ -106,7 +118,7 @@ public:
         playedCards.emplace_back(playedCard);
         
         // Player revealed they have this suit
-        playerSuitStrengths[playerID].insert(playedCard.suit);
+        playerSuitStrengths[playerID] |= 1u << playedCard.suit;
         
         // Update our model of each player's hand
         auto& playerHand = playerHands[playerID];
@@ -141,6 +153,11 @@ public:
         return "CalculativeStrategy";
     }
 
+    // Reproducible runs (see seedStrategy below)
+    void seed(uint64_t s) {
+        rng.seed(static_cast<std::mt19937::result_type>(s));
+    }
+
 private:
     uint64_t myID;
     std::mt19937 rng;
@@ -151,33 +168,45 @@ private:
     std::unordered_map<uint64_t, int> playerPasses;
     std::vector<Card> playedCards;
     
-    // Track which suits each player seems to have or lack
-    std::unordered_map<uint64_t, std::set<int>> playerSuitStrengths;
-    std::unordered_map<uint64_t, std::set<int>> playerSuitWeaknesses;
+    // Track which suits each player seems to have or lack (bit s set for suit s)
+    std::unordered_map<uint64_t, unsigned> playerSuitStrengths;
+    std::unordered_map<uint64_t, unsigned> playerSuitWeaknesses;
+    
+    // Opening book of the process (OpeningBook::activate), decisions it answered this round
+    std::shared_ptr<const OpeningBook> book;
+    size_t openingHandSize = 0;
+    unsigned bookDecisions = 0;
+    
+    // A card we pretend was played, so look-ahead does not need a copy of the table
+    struct Overlay {
+        int suit;   // -1 : no card
+        int rank;
+    };
+    
+    // Is (suit, rank) on the table, or the `extra` card?
+    static bool onTable(int suit, int rank,
+                        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout,
+                        const Overlay& extra) {
+        if (extra.suit == suit && extra.rank == rank) return true;
+        auto s = tableLayout.find(suit);
+        if (s == tableLayout.end()) return false;
+        auto r = s->second.find(rank);
+        return r != s->second.end() && r->second;
+    }
     
     // Helper function to check if a card is playable
     bool isPlayable(const Card& card, 
-                   const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) const {
+                   const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout,
+                   const Overlay& extra = Overlay{-1, 0}) const {
         // Check if it's a 7
         if (card.rank == 7) {
             // If the 7 is not on the table, it can be played
-            return tableLayout.count(card.suit) == 0 || 
-                   tableLayout.at(card.suit).count(7) == 0 || 
-                   !tableLayout.at(card.suit).at(7);
+            return !onTable(card.suit, 7, tableLayout, extra);
         }
         
         // Check for cards adjacent to this one
-        bool hasLower = false;
-        if (card.rank > 1 && tableLayout.count(card.suit) > 0) {
-            hasLower = tableLayout.at(card.suit).count(card.rank - 1) > 0 && 
-                      tableLayout.at(card.suit).at(card.rank - 1);
-        }
-        
-        bool hasUpper = false;
-        if (card.rank < 13 && tableLayout.count(card.suit) > 0) {
-            hasUpper = tableLayout.at(card.suit).count(card.rank + 1) > 0 && 
-                      tableLayout.at(card.suit).at(card.rank + 1);
-        }
+        bool hasLower = card.rank > 1 && onTable(card.suit, card.rank - 1, tableLayout, extra);
+        bool hasUpper = card.rank < 13 && onTable(card.suit, card.rank + 1, tableLayout, extra);
         
         return hasLower || hasUpper;
     }
@@ -217,7 +246,7 @@ private:
         // PRIORITY 5: Block opponents if they seem to specialize in a suit
         bool isSuitStrengthForOpponent = false;
         for (const auto& [playerID, strengths] : playerSuitStrengths) {
-            if (playerID != myID && strengths.count(card.suit) > 0) {
+            if (playerID != myID && ((strengths >> card.suit) & 1)) {
                 isSuitStrengthForOpponent = true;
                 break;
             }
@@ -248,12 +277,11 @@ private:
     // Count how many of our cards would become playable after playing this card
     int countCardsUnlockedByPlaying(const Card& card, 
                                    const std::vector<Card>& hand,
-                                   const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>> tableLayout) {
+                                   const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) {
         int count = 0;
         
-        // Create a copy of the table layout with this card added
-        auto newTableLayout = tableLayout;
-        newTableLayout[card.suit][card.rank] = true;
+        // The table with this card added (as an overlay, the table itself is not copied)
+        const Overlay withCard{card.suit, card.rank};
         
         // Check which cards would become playable that weren't before
         for (const auto& potentialCard : hand) {
@@ -264,7 +292,7 @@ private:
             
             // If it wasn't playable before but would be after, count it
             if (!isPlayable(potentialCard, tableLayout) && 
-                 isPlayable(potentialCard, newTableLayout)) {
+                 isPlayable(potentialCard, tableLayout, withCard)) {
                 count++;
             }
         }
@@ -326,17 +354,23 @@ private:
         // they might be out of that suit or missing specific ranks
         
         // For now, just mark suits they've never played as potential weaknesses
-        for (int suit = 0; suit < 4; ++suit) {
-            if (strengths.count(suit) == 0) {
-                weaknesses.insert(suit);
-            }
-        }
+        weaknesses |= ~strengths & 0xFFFFu; // up to 16 suits (4 combined decks)
     }
 };
 
 } // namespace sevens
 
 // Export function for the loader — DO NOT place in the namespace
+#ifndef SEVENS_STATIC_STRATEGIES // compiled into the binary instead, see BuiltinStrategies.hpp
 extern "C" sevens::PlayerStrategy* createStrategy() {
     return new sevens::CalculativeStrategy();
-}
\ No newline at end of file
+}
+
+extern "C" void seedStrategy(sevens::PlayerStrategy* strategy, uint64_t seed) {
+    static_cast<sevens::CalculativeStrategy*>(strategy)->seed(seed);
+}
+
+extern "C" void useOpeningBook(const char* path) {
+    sevens::OpeningBook::activate(path);
+}
+#endif
@@ -0,0 +1,366 @@
+#include "CfrPolicy.hpp"
+#include "MatchRunner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace sevens {
+
+namespace {
+
+constexpr unsigned kMaxSeats = SelfPlayRecord::kMaxPlayers;
+constexpr float kRegretScale = 256.0f;          // regrets in 1/256 card
+constexpr int32_t kRegretFloor = -(1 << 28);
+constexpr int32_t kRegretCeiling = 1 << 30;
+constexpr int32_t kPruneThreshold = -(1 << 18);
+constexpr unsigned kMaxProbes = 64;
+constexpr uint64_t kChunk = 256;                // iterations handed to a thread at once
+constexpr unsigned kWindowStarts = 8;           // the window starts at one of the first 8 choices
+
+// One information set, one cache line
+struct alignas(64) InfoSet {
+    std::atomic<uint64_t> key;                  // key + 1, 0 = free
+    std::atomic<int32_t> regret[CfrPolicy::kActions];
+    std::atomic<uint16_t> average[CfrPolicy::kActions];
+};
+
+static_assert(sizeof(InfoSet) == 64, "information sets are one cache line");
+
+/**
+ * Fixed-size open-addressing table of information sets, shared by the threads without
+ * locks: a set is claimed by compare-and-swap on its key, then only updated by atomic
+ * operations on its counters.
+ */
+class RegretTable {
+public:
+    explicit RegretTable(unsigned bits) : bits(bits), mask((uint64_t(1) << bits) - 1), sets(new InfoSet[mask + 1]()) {}
+
+    // The set of a key, claimed if new; null when the table has no room left around it
+    InfoSet* find(uint64_t key, uint64_t& created) {
+        const uint64_t tag = key + 1;
+        uint64_t i = CfrPolicy::slot(key, bits);
+        for (unsigned probe = 0; probe < kMaxProbes; ++probe, i = (i + 1) & mask) {
+            uint64_t k = sets[i].key.load(std::memory_order_acquire);
+            if (k == tag) return &sets[i];
+            if (k == 0) {
+                if (sets[i].key.compare_exchange_strong(k, tag, std::memory_order_acq_rel)) {
+                    ++created;
+                    return &sets[i];
+                }
+                if (k == tag) return &sets[i];   // claimed by another thread meanwhile
+            }
+        }
+        return nullptr;
+    }
+
+    uint64_t size() const { return mask + 1; }
+    const InfoSet& operator[](uint64_t i) const { return sets[i]; }
+
+private:
+    unsigned bits;
+    uint64_t mask;
+    std::unique_ptr<InfoSet[]> sets;
+};
+
+// Saturating add on a regret, floored
+void addRegret(std::atomic<int32_t>& regret, float delta) {
+    const int32_t d = static_cast<int32_t>(delta * kRegretScale);
+    int32_t old = regret.load(std::memory_order_relaxed);
+    int32_t next;
+    do {
+        next = static_cast<int32_t>(std::max<int64_t>(kRegretFloor, std::min<int64_t>(kRegretCeiling, int64_t(old) + d)));
+    } while (!regret.compare_exchange_weak(old, next, std::memory_order_relaxed));
+}
+
+void countAction(InfoSet& set, unsigned a) {
+    if (set.average[a].fetch_add(1, std::memory_order_relaxed) == 0xFFFE) {
+        for (auto& c : set.average) c.store(c.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+    }
+}
+
+// A round in progress
+struct Round {
+    uint64_t hands[kMaxSeats];
+    uint64_t table;
+    uint8_t sizes[kMaxSeats];
+    unsigned players;
+    unsigned player;
+};
+
+/**
+ * One thread's traversals. Counters are merged at the end.
+ */
+class Traversal {
+public:
+    Traversal(RegretTable& table, unsigned players, unsigned window)
+        : table(table), players(players), window(window) {}
+
+    void iteration(uint64_t t, std::mt19937_64& rng, bool prune) {
+        rng64 = &rng;
+        pruning = prune;
+
+        // Deal as VariantGame<1>: 7♦ on the table, 51 cards from the seat after a random dealer
+        int pack[51];
+        for (int id = 0, n = 0; id < 52; ++id) {
+            if (id != 32) pack[n++] = id;
+        }
+        std::shuffle(pack, pack + 51, rng);
+        Round r{};
+        r.players = players;
+        const unsigned dealer = static_cast<unsigned>(rng() % players);
+        for (unsigned i = 0; i < 51; ++i) {
+            const unsigned p = (dealer + i) % players;
+            r.hands[p] |= 1ull << pack[i];
+            ++r.sizes[p];
+        }
+        r.table = 1ull << 32;
+        r.player = (dealer + 1) % players;
+        windowStart = window ? static_cast<unsigned>(rng() % kWindowStarts) : 0;
+        traverse(r, static_cast<unsigned>(t % players), 0);
+    }
+
+    uint64_t nodes = 0;
+    uint64_t created = 0;
+    uint64_t overflow = 0;
+
+private:
+    // Payoff of the traverser from this position on; depth = its decisions with a choice so far
+    float traverse(Round r, unsigned traverser, unsigned depth) {
+        unsigned passes = 0;
+        for (;;) {
+            const unsigned p = r.player;
+            const uint64_t playable = Features::legal(r.hands[p], r.table);
+            if (playable == 0) {
+                if (++passes >= r.players) return -static_cast<float>(r.sizes[traverser]);
+                r.player = (p + 1) % r.players;
+                continue;
+            }
+            passes = 0;
+            if ((playable & (playable - 1)) == 0) {
+                if (play(r, __builtin_ctzll(playable))) return -static_cast<float>(r.sizes[traverser]);
+                continue;
+            }
+
+            ++nodes;
+            FeatureInput in;
+            in.hand = r.hands[p];
+            in.table = r.table;
+            in.players = static_cast<uint8_t>(r.players);
+            for (unsigned i = 0; i < r.players; ++i) in.handSizes[i] = r.sizes[(p + i) % r.players];
+            std::array<int, 4> order;
+            unsigned legal;
+            const uint64_t key = CfrPolicy::key(in, order, legal);
+            InfoSet* set = table.find(key, created);
+            if (!set) ++overflow;
+            float sigma[CfrPolicy::kActions];
+            strategy(set, legal, sigma);
+
+            // Outside the window, the traverser follows its strategy without learning
+            const bool outside = window && (depth < windowStart || depth >= windowStart + window);
+            if (p != traverser || outside) {
+                const unsigned a = sample(sigma, legal);
+                if (p != traverser && set) countAction(*set, a);
+                if (p == traverser) ++depth;
+                if (play(r, CfrPolicy::actionCard(a, r.table, order))) return -static_cast<float>(r.sizes[traverser]);
+                continue;
+            }
+
+            unsigned explored = legal;
+            if (pruning && set) {
+                for (unsigned a = 0; a < CfrPolicy::kActions; ++a) {
+                    if (set->regret[a].load(std::memory_order_relaxed) < kPruneThreshold) explored &= ~(1u << a);
+                }
+                if (explored == 0) explored = legal;
+            }
+            // The node value is the expectation over the explored actions only: sigma
+            // restricted to them and renormalized (uniform when they have no mass)
+            float value[CfrPolicy::kActions];
+            float node = 0.0f;
+            float mass = 0.0f;
+            unsigned n = 0;
+            for (unsigned a = 0; a < CfrPolicy::kActions; ++a) {
+                if (!(explored >> a & 1)) continue;
+                Round child = r;
+                value[a] = play(child, CfrPolicy::actionCard(a, r.table, order))
+                               ? -static_cast<float>(child.sizes[traverser]) : traverse(child, traverser, depth + 1);
+                node += sigma[a] * value[a];
+                mass += sigma[a];
+                ++n;
+            }
+            if (mass > 0.0f) {
+                node /= mass;
+            } else {
+                for (unsigned a = 0; a < CfrPolicy::kActions; ++a) {
+                    if (explored >> a & 1) node += value[a] / n;
+                }
+            }
+            if (set) {
+                for (unsigned a = 0; a < CfrPolicy::kActions; ++a) {
+                    if (explored >> a & 1) addRegret(set->regret[a], value[a] - node);
+                }
+            }
+            return node;
+        }
+    }
+
+    // Plays a card; true when it empties the hand (end of the round)
+    static bool play(Round& r, int card) {
+        const unsigned p = r.player;
+        r.hands[p] &= ~(1ull << card);
+        r.table |= 1ull << card;
+        r.player = (p + 1) % r.players;
+        return --r.sizes[p] == 0;
+    }
+
+    // Regret matching: positive regrets normalized, uniform when there is none
+    static void strategy(const InfoSet* set, unsigned legal, float* sigma) {
+        float sum = 0.0f;
+        unsigned n = 0;
+        for (unsigned a = 0; a < CfrPolicy::kActions; ++a) {
+            sigma[a] = 0.0f;
+            if (!(legal >> a & 1)) continue;
+            ++n;
+            if (set) sigma[a] = static_cast<float>(std::max(0, set->regret[a].load(std::memory_order_relaxed)));
+            sum += sigma[a];
+        }
+        for (unsigned a = 0; a < CfrPolicy::kActions; ++a) {
+            if (legal >> a & 1) sigma[a] = sum > 0.0f ? sigma[a] / sum : 1.0f / n;
+        }
+    }
+
+    unsigned sample(const float* sigma, unsigned legal) {
+        float x = static_cast<float>((*rng64)() >> 40) * (1.0f / (1 << 24));
+        unsigned last = 0;
+        for (unsigned a = 0; a < CfrPolicy::kActions; ++a) {
+            if (!(legal >> a & 1)) continue;
+            last = a;
+            if ((x -= sigma[a]) < 0.0f) return a;
+        }
+        return last;
+    }
+
+    RegretTable& table;
+    unsigned players;
+    unsigned window;
+    unsigned windowStart = 0;
+    std::mt19937_64* rng64 = nullptr;
+    bool pruning = false;
+};
+
+template <typename T>
+void put(unsigned char* at, T v) {
+    for (size_t i = 0; i < sizeof(T); ++i) at[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+// Average strategies of the visited sets, as a CfrPolicy file
+uint64_t writePolicy(const std::string& path, const RegretTable& table, const CfrConfig& cfg, uint64_t iterations) {
+    std::vector<CfrPolicy::Entry> entries;
+    for (uint64_t i = 0; i < table.size(); ++i) {
+        const InfoSet& set = table[i];
+        const uint64_t tag = set.key.load(std::memory_order_relaxed);
+        if (tag == 0) continue;
+        uint32_t total = 0;
+        for (const auto& c : set.average) total += c.load(std::memory_order_relaxed);
+        if (total == 0) continue;
+        CfrPolicy::Entry e{};
+        e.key = tag;
+        for (unsigned a = 0; a < CfrPolicy::kActions; ++a) {
+            e.probability[a] = static_cast<uint8_t>((set.average[a].load(std::memory_order_relaxed) * 255u + total / 2) / total);
+        }
+        entries.push_back(e);
+    }
+
+    unsigned bits = 4;
+    while ((uint64_t(1) << bits) < entries.size() * 2) ++bits;
+    std::vector<CfrPolicy::Entry> slots(size_t(1) << bits, CfrPolicy::Entry{});
+    const uint64_t mask = slots.size() - 1;
+    for (const CfrPolicy::Entry& e : entries) {
+        uint64_t i = CfrPolicy::slot(e.key - 1, bits);
+        while (slots[i].key) i = (i + 1) & mask;
+        slots[i] = e;
+    }
+
+    unsigned char header[CfrPolicy::kHeaderSize] = {};
+    std::memcpy(header, "SVNSCFRP", 8);
+    put<uint32_t>(header + 8, CfrPolicy::kVersion);
+    put<uint32_t>(header + 12, cfg.players);
+    put<uint32_t>(header + 16, bits);
+    put<uint64_t>(header + 24, entries.size());
+    put<uint64_t>(header + 32, iterations);
+    put<uint64_t>(header + 40, cfg.seed);
+
+    const std::string tmp = path + ".tmp";
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Impossible d'écrire la politique CFR : " + tmp);
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(CfrPolicy::Entry)));
+    out.close();
+    if (!out) throw std::runtime_error("Impossible d'écrire la politique CFR : " + tmp);
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Impossible de renommer la politique CFR : " + tmp);
+    }
+    return entries.size();
+}
+
+} // namespace
+
+CfrStats trainCfr(const std::string& path, const CfrConfig& cfg) {
+    if (cfg.players < 2 || cfg.players > kMaxSeats) {
+        throw std::invalid_argument("Nombre de joueurs invalide (2 à 8) : " + std::to_string(cfg.players));
+    }
+    if (cfg.tableBits < 10 || cfg.tableBits > 34) {
+        throw std::invalid_argument("Taille de table invalide (10 à 34 bits) : " + std::to_string(cfg.tableBits));
+    }
+
+    RegretTable table(cfg.tableBits);
+    const uint64_t chunks = (cfg.iterations + kChunk - 1) / kChunk;
+    CfrStats totals;
+    std::mutex merge;
+    std::atomic<uint64_t> next{0};
+    std::exception_ptr failure;
+
+    auto worker = [&] {
+        try {
+            Traversal traversal(table, cfg.players, cfg.window);
+            uint64_t iterations = 0;
+            for (uint64_t c = next.fetch_add(1); c < chunks; c = next.fetch_add(1)) {
+                std::mt19937_64 rng(MatchRunner::deriveSeed(cfg.seed, c, 0));
+                const uint64_t last = std::min(cfg.iterations, (c + 1) * kChunk);
+                for (uint64_t t = c * kChunk; t < last; ++t) {
+                    const bool prune = cfg.prune && t >= cfg.pruneAfter && rng() % 100 < 95;
+                    traversal.iteration(t, rng, prune);
+                    ++iterations;
+                }
+            }
+            std::lock_guard<std::mutex> lock(merge);
+            totals.iterations += iterations;
+            totals.nodes += traversal.nodes;
+            totals.informationSets += traversal.created;
+            totals.overflow += traversal.overflow;
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(merge);
+            if (!failure) failure = std::current_exception();
+            next.store(chunks);
+        }
+    };
+
+    unsigned threads = cfg.threads ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<uint64_t>(threads, std::max<uint64_t>(1, chunks)));
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+    if (failure) std::rethrow_exception(failure);
+
+    totals.written = writePolicy(path, table, cfg, totals.iterations);
+    return totals;
+}
+
+} // namespace sevens
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "Features.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Average policy of a Monte Carlo CFR run (mode `cfr`) over an abstraction of the 52-card
+ * game, read by CfrStrategy from a memory-mapped file.
+ *
+ * Information set: one digit per suit (0-71), the four sorted (suit symmetry), then two
+ * opponent hand-size buckets:
+ *   no 7 on the table   7 held, any of our cards below / above the 7               0 - 7
+ *   7 on the table      8 + 8 * low side + high side, a side being: next card held,
+ *                       any of our cards beyond it, any held by the others
+ *   bits 32-33          smallest hand of the others (1, 2, 3-4, 5+)
+ *   bits 34-35          hand of the next player (same buckets)
+ * Action 2 * i + side plays the next card of the i-th suit of the key on that side
+ * (side 0 = the 7 itself while it is not on the table), so the key gives the legal actions.
+ *
+ * File (little-endian):
+ *   0   header   "SVNSCFRP", u32 version, u32 players, u32 table bits, u32 reserved,
+ *                u64 information sets, u64 iterations, u64 seed (padded to 64 bytes)
+ *   64  table    2^bits entries of 16 bytes: u64 key + 1 (0 = empty), u8 probabilities
+ *                of the 8 actions (out of 255); open addressing, linear probing
+ *
+ * Header-only, like OpeningBook: every strategy .so gets its own copy.
+ */
+class CfrPolicy {
+public:
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kHeaderSize = 64;
+    static constexpr unsigned kActions = 8;
+
+    struct Entry {
+        uint64_t key;                 // key + 1, 0 = empty
+        uint8_t probability[kActions];
+    };
+    static_assert(sizeof(Entry) == 16, "policy entries are 16 bytes");
+
+    // Maps the file read-only; throws std::runtime_error when it is not a valid policy
+    explicit CfrPolicy(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Politique CFR introuvable : " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kHeaderSize) {
+            ::close(fd);
+            throw std::runtime_error("Politique CFR invalide : " + path);
+        }
+        mapSize = static_cast<size_t>(st.st_size);
+        map = ::mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            map = nullptr;
+            throw std::runtime_error("Impossible de projeter la politique CFR en mémoire : " + path);
+        }
+        const unsigned char* h = static_cast<const unsigned char*>(map);
+        bits = read32(h + 16);
+        if (std::memcmp(h, "SVNSCFRP", 8) != 0 || read32(h + 8) != kVersion || bits > 40 ||
+            mapSize != kHeaderSize + (size_t(1) << bits) * sizeof(Entry)) {
+            ::munmap(map, mapSize);
+            map = nullptr;
+            throw std::runtime_error("Politique CFR " + path + " : format inconnu");
+        }
+        nPlayers = read32(h + 12);
+        nSets = read64(h + 24);
+        nIterations = read64(h + 32);
+        entries = reinterpret_cast<const Entry*>(h + kHeaderSize);
+    }
+
+    ~CfrPolicy() {
+        if (map) ::munmap(map, mapSize);
+    }
+
+    CfrPolicy(const CfrPolicy&) = delete;
+    CfrPolicy& operator=(const CfrPolicy&) = delete;
+
+    unsigned players() const { return nPlayers; }
+    uint64_t informationSets() const { return nSets; }
+    uint64_t iterations() const { return nIterations; }
+
+    // Probabilities of the information set, null when the run never reached it
+    const uint8_t* find(uint64_t key) const {
+        const uint64_t mask = (uint64_t(1) << bits) - 1;
+        for (uint64_t i = slot(key, bits);; i = (i + 1) & mask) {
+            if (entries[i].key == key + 1) return entries[i].probability;
+            if (entries[i].key == 0) return nullptr;
+        }
+    }
+
+    // ── Abstraction, shared with the trainer ────────────────────────────────
+
+    /**
+     * Key of a decision; order[i] = the suit that comes i-th in the key, legal = the legal
+     * actions (bit a).
+     */
+    static uint64_t key(const FeatureInput& in, std::array<int, 4>& order, unsigned& legal) {
+        unsigned digits[4];
+        unsigned moves[4];
+        for (unsigned s = 0; s < 4; ++s) digits[s] = digit(Features::row(in.hand, s), Features::row(in.table, s), moves[s]);
+        for (int s = 0; s < 4; ++s) {
+            int i = s;
+            while (i > 0 && digits[order[i - 1]] > digits[s]) {
+                order[i] = order[i - 1];
+                --i;
+            }
+            order[i] = s;
+        }
+        uint64_t k = 0;
+        legal = 0;
+        for (unsigned i = 0; i < 4; ++i) {
+            k |= static_cast<uint64_t>(digits[order[i]]) << (8 * i);
+            legal |= moves[order[i]] << (2 * i);
+        }
+        unsigned smallest = 13;
+        for (unsigned i = 1; i < in.players; ++i) smallest = std::min<unsigned>(smallest, in.handSizes[i]);
+        k |= static_cast<uint64_t>(sizeBucket(smallest)) << 32;
+        k |= static_cast<uint64_t>(sizeBucket(in.handSizes[1])) << 34;
+        return k;
+    }
+
+    // Card id of action a on this table for a key's suit order
+    static int actionCard(unsigned a, uint64_t table, const std::array<int, 4>& order) {
+        const int s = order[a / 2];
+        const unsigned t = Features::row(table, static_cast<unsigned>(s));
+        if (t == 0) return s * 13 + 6;
+        const int b = a % 2 ? 31 - __builtin_clz(t) + 1 : __builtin_ctz(t) - 1;
+        return s * 13 + b;
+    }
+
+    static uint64_t slot(uint64_t key, unsigned bits) {
+        return (key * 0x9E3779B97F4A7C15ull) >> (64 - bits);
+    }
+
+    // Policy of the process, read on first use of its path (null when it cannot be read)
+    static std::shared_ptr<const CfrPolicy> shared(const std::string& path) {
+        static std::mutex mutex;
+        static std::map<std::string, std::shared_ptr<const CfrPolicy>> policies;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = policies.find(path);
+        if (it == policies.end()) {
+            std::shared_ptr<const CfrPolicy> policy;
+            try {
+                policy = std::make_shared<const CfrPolicy>(path);
+            } catch (const std::exception& e) {
+                std::cerr << "[CfrPolicy] " << e.what() << '\n';
+            }
+            it = policies.emplace(path, std::move(policy)).first;
+        }
+        return it->second;
+    }
+
+private:
+    // Digit of a suit row; moves = its legal actions (bit 0: low side or the 7, bit 1: high)
+    static unsigned digit(unsigned h, unsigned t, unsigned& moves) {
+        if (t == 0) {
+            moves = (h >> 6) & 1;
+            return moves | ((h & Features::kBelow) ? 2u : 0u) | ((h & Features::kAbove) ? 4u : 0u);
+        }
+        const unsigned lowEnd = static_cast<unsigned>(__builtin_ctz(t));
+        const unsigned highEnd = static_cast<unsigned>(31 - __builtin_clz(t));
+        const unsigned below = (1u << lowEnd) - 1;                       // ranks under the table
+        const unsigned above = 0x1FFF & ~((2u << highEnd) - 1);          // ranks over it
+        const unsigned lowNext = lowEnd ? 1u << (lowEnd - 1) : 0;
+        const unsigned highNext = highEnd < 12 ? 1u << (highEnd + 1) : 0;
+        moves = ((h & lowNext) ? 1u : 0u) | ((h & highNext) ? 2u : 0u);
+        return 8 + 8 * side(h, below, lowNext) + side(h, above, highNext);
+    }
+
+    static unsigned side(unsigned h, unsigned span, unsigned next) {
+        const unsigned beyond = span & ~next;
+        return ((h & next) ? 1u : 0u) | ((h & beyond) ? 2u : 0u) | ((beyond & ~h) ? 4u : 0u);
+    }
+
+    static unsigned sizeBucket(unsigned n) { return n <= 2 ? (n ? n - 1 : 0) : n <= 4 ? 2 : 3; }
+
+    static uint32_t read32(const unsigned char* at) {
+        return uint32_t(at[0]) | uint32_t(at[1]) << 8 | uint32_t(at[2]) << 16 | uint32_t(at[3]) << 24;
+    }
+
+    static uint64_t read64(const unsigned char* at) {
+        return uint64_t(read32(at)) | uint64_t(read32(at + 4)) << 32;
+    }
+
+    void* map = nullptr;
+    size_t mapSize = 0;
+    const Entry* entries = nullptr;
+    unsigned bits = 0;
+    unsigned nPlayers = 0;
+    uint64_t nSets = 0;
+    uint64_t nIterations = 0;
+};
+
+/**
+ * External-sampling Monte Carlo CFR (mode `cfr`) on the abstraction above, `players`
+ * seats, a seat's payoff being minus its cards left at the end of the round.
+ *
+ * Iteration t deals at random and traverses for seat t % players: every legal action of
+ * the traverser is explored, the other seats sample one action from their current
+ * strategy (regret matching) and count it in their average strategy.
+ *
+ * A seat makes a dozen decisions per round, so exploring all of them costs tens of
+ * thousands of positions per iteration. With window W > 0 the traverser explores only W
+ * consecutive decisions with a choice, starting at one of its first 8 at random, and plays
+ * the others from its current strategy like the other seats (without learning there):
+ * every decision of the round still gets its updates, at a bounded cost per iteration,
+ * but the updates are weighted by the traverser's own probability of reaching them.
+ * window = 0 is plain external sampling. With `prune`, after
+ * `pruneAfter` iterations the traverser skips actions whose regret is below a threshold
+ * in 95% of its iterations (regret-based pruning), which cuts most of the tree once the
+ * bad moves are known.
+ *
+ * The regret table is shared by all the threads without locks: a fixed array of 64-byte
+ * information sets (one cache line: key, 8 int32 regrets, 8 uint16 average counts),
+ * claimed by compare-and-swap on the key and updated with atomic adds, as in "Hogwild"
+ * SGD. 2^tableBits sets are allocated up front; once the table is full, new sets are not
+ * stored (they play uniformly) and are counted in `overflow`. Regrets saturate and floor
+ * (-2^28, which lets bad actions recover quickly); counts are halved when one saturates.
+ * The result depends on the thread interleaving; with one thread, on the seed only.
+ */
+struct CfrConfig {
+    unsigned players = 4;
+    uint64_t iterations = 1000000;
+    unsigned threads = 0;             // 0 = std::thread::hardware_concurrency()
+    uint64_t seed = 0;
+    unsigned tableBits = 22;          // 2^22 information sets = 256 MiB
+    unsigned window = 3;              // 0 = explore every decision of the traverser
+    bool prune = true;
+    uint64_t pruneAfter = 100000;
+};
+
+struct CfrStats {
+    uint64_t iterations = 0;
+    uint64_t nodes = 0;               // decisions visited with 2 legal actions or more
+    uint64_t informationSets = 0;
+    uint64_t written = 0;             // information sets with an average strategy in the file
+    uint64_t overflow = 0;            // visits of sets the full table could not store
+};
+
+CfrStats trainCfr(const std::string& path, const CfrConfig& cfg);
+
+} // namespace sevens
@@ -0,0 +1,126 @@
+#include "PlayerStrategy.hpp"
+#include "SevensRules.hpp"
+#include "CfrPolicy.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Plays the average policy of a Monte Carlo CFR run (CfrPolicy.hpp, written by
+ * `./sevens_game cfr`): the decision is abstracted to its information set and the card
+ * drawn from the policy's probabilities.
+ *
+ * The policy is mapped once per process at the first initialize(), from $SEVENS_CFR_POLICY
+ * (default: cfr.svc in the working directory). Information sets the run never reached,
+ * games of another player count, a missing policy and variants get a random playable
+ * card, which is what CFR plays before it learns anything.
+ */
+class CfrStrategy : public PlayerStrategy {
+public:
+    CfrStrategy() {
+        auto seed = static_cast<unsigned long>(
+            std::chrono::system_clock::now().time_since_epoch().count()
+        );
+        rng.seed(seed);
+    }
+
+    ~CfrStrategy() override = default;
+
+    void initialize(uint64_t playerID) override {
+        if (!loaded) {
+            const char* path = std::getenv("SEVENS_CFR_POLICY");
+            policy = CfrPolicy::shared(path && *path ? path : "cfr.svc");
+            loaded = true;
+        }
+        game.reset(playerID);
+    }
+
+    int selectCardToPlay(
+        const std::vector<Card>& hand,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override
+    {
+        std::vector<int> playable;
+        bool variant = !game.followed();   // more than 8 seats
+        for (size_t i = 0; i < hand.size(); ++i) {
+            variant |= hand[i].suit < 0 || hand[i].suit > 3;
+            if (isPlayable(hand[i], tableLayout)) playable.push_back(static_cast<int>(i));
+        }
+        if (playable.empty()) return -1;
+        if (variant) return playable[rng() % playable.size()];
+
+        const FeatureInput in = game.decision(hand, tableLayout);
+        if (playable.size() == 1 || !policy || policy->players() != in.players) {
+            return playable[rng() % playable.size()];
+        }
+
+        std::array<int, 4> order;
+        unsigned legal;
+        const uint8_t* probability = policy->find(CfrPolicy::key(in, order, legal));
+        if (!probability) return playable[rng() % playable.size()];
+
+        // Draw an action among the legal ones (weights out of 255)
+        unsigned total = 0;
+        for (unsigned a = 0; a < CfrPolicy::kActions; ++a) {
+            if (legal >> a & 1) total += probability[a];
+        }
+        unsigned chosen = CfrPolicy::kActions;
+        if (total == 0) {
+            for (unsigned a = 0, seen = 0; a < CfrPolicy::kActions; ++a) {
+                if ((legal >> a & 1) && rng() % ++seen == 0) chosen = a;
+            }
+        } else {
+            unsigned x = static_cast<unsigned>(rng() % total);
+            for (unsigned a = 0; a < CfrPolicy::kActions && chosen == CfrPolicy::kActions; ++a) {
+                if (!(legal >> a & 1)) continue;
+                if (x < probability[a]) chosen = a;
+                else x -= probability[a];
+            }
+        }
+
+        const int card = CfrPolicy::actionCard(chosen, in.table, order);
+        for (int i : playable) {
+            if (hand[i].suit * 13 + hand[i].rank - 1 == card) return i;
+        }
+        return playable[rng() % playable.size()];
+    }
+
+    void observeMove(uint64_t playerID, const Card& playedCard) override {
+        game.moved(playerID, playedCard);
+    }
+
+    void observePass(uint64_t playerID) override {
+        game.passed(playerID);
+    }
+
+    std::string getName() const override {
+        return "CfrStrategy";
+    }
+
+    // Reproducible runs (see seedStrategy below)
+    void seed(uint64_t s) {
+        rng.seed(static_cast<std::mt19937::result_type>(s));
+    }
+
+private:
+    std::mt19937 rng;
+    std::shared_ptr<const CfrPolicy> policy;
+    bool loaded = false;
+    ObservedGame game;
+};
+
+} // namespace sevens
+
+// Export function for the loader — DO NOT place in the namespace
+#ifndef SEVENS_STATIC_STRATEGIES // compiled into the binary instead, see BuiltinStrategies.hpp
+extern "C" sevens::PlayerStrategy* createStrategy() {
+    return new sevens::CfrStrategy();
+}
+
+extern "C" void seedStrategy(sevens::PlayerStrategy* strategy, uint64_t seed) {
+    static_cast<sevens::CfrStrategy*>(strategy)->seed(seed);
+}
+#endif
@@ -0,0 +1,104 @@
+#include "Checkpoint.hpp"
+#include "BinaryIO.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace sevens {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'V', 'N', 'S', 'C', 'K', 'P', '4'};
+
+} // namespace
+
+void Checkpoint::save(const std::string& path, const MatchRunnerConfig& cfg, const RunState& state) {
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("Impossible d'écrire le checkpoint : " + tmp);
+        BinaryWriter w(out);
+
+        out.write(kMagic, sizeof(kMagic));
+        w.u64(cfg.seed);
+        w.u64(cfg.maxScore);
+        w.u64(cfg.rotateSeats);
+        w.str(cfg.deals);
+        w.u64(cfg.dealsFingerprint);
+        w.str(cfg.book);
+        w.u64(cfg.specs.size());
+        for (const std::string& spec : cfg.specs) w.str(spec);
+
+        w.u64(state.nextMatch);
+        w.u64(state.rounds);
+        w.f64(state.seconds);
+        w.u64(state.resultsBytes);
+        w.u64(state.strategies.size());
+        for (const StrategySummary& s : state.strategies) {
+            w.u64(s.samples);
+            w.vec(s.rankCounts);
+            w.u64(s.points);
+            w.u64(s.roundWins);
+            w.u64(s.roundTies);
+            w.f64(s.rating);
+        }
+        w.u64(state.pending.size());
+        for (const auto& [id, outcome] : state.pending) w.outcome(outcome);
+
+        out.flush();
+        if (!out) throw std::runtime_error("Impossible d'écrire le checkpoint : " + tmp);
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Impossible de remplacer le checkpoint : " + path);
+    }
+}
+
+RunState Checkpoint::load(const std::string& path, const MatchRunnerConfig& cfg, const RunState& fresh) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("Checkpoint introuvable : " + path);
+    BinaryReader r(in, "Checkpoint " + path);
+
+    char magic[sizeof(kMagic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        r.fail("ce n'est pas un checkpoint");
+    }
+
+    // Same run? (the number of matches may grow)
+    if (r.u64() != cfg.seed) r.fail("autre graine (--seed)");
+    if (r.u64() != cfg.maxScore) r.fail("autre score maximal (--max-score)");
+    if (r.u64() != static_cast<uint64_t>(cfg.rotateSeats)) r.fail("autre placement (--fixed-seats)");
+    if (r.str() != cfg.deals) r.fail("autre corpus de donnes (--deals)");
+    if (r.u64() != cfg.dealsFingerprint) r.fail("corpus de donnes modifié (--deals)");
+    if (r.str() != cfg.book) r.fail("autre livre d'ouvertures (--book)");
+    uint64_t specs = r.u64();
+    if (specs != cfg.specs.size()) r.fail("autre nombre de joueurs");
+    for (const std::string& spec : cfg.specs) {
+        if (r.str() != spec) r.fail("autres stratégies (" + spec + ")");
+    }
+
+    RunState state = fresh;
+    state.nextMatch = r.u64();
+    state.rounds = r.u64();
+    state.seconds = r.f64();
+    state.resultsBytes = r.u64();
+    if (r.u64() != state.strategies.size()) r.fail("fichier corrompu");
+    for (StrategySummary& s : state.strategies) {
+        s.samples = r.u64();
+        s.rankCounts = r.vec();
+        s.points = r.u64();
+        s.roundWins = r.u64();
+        s.roundTies = r.u64();
+        s.rating = r.f64();
+        if (s.rankCounts.size() != specs) r.fail("fichier corrompu");
+    }
+    uint64_t pending = r.u64();
+    for (uint64_t i = 0; i < pending; ++i) {
+        MatchOutcome o = r.outcome();
+        state.pending.emplace(o.matchId, std::move(o));
+    }
+    return state;
+}
+
+} // namespace sevens
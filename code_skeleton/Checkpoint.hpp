@@ -0,0 +1,30 @@
+#pragma once
+
+#include "MatchRunner.hpp"
+
+#include <string>
+
+namespace sevens {
+
+/**
+ * Checkpoints of a batch run (MatchRunnerConfig::checkpoint / --checkpoint).
+ *
+ * Binary file (BinaryIO.hpp encoding):
+ *   "SVNSCKP4", run identity (master seed, max score, seat rotation, deal corpus path and
+ *   fingerprint, opening book path, strategy specs),
+ *   RunState (next match, rounds, seconds, results file size, per-strategy aggregates and
+ *   rating bits, finished out-of-order matches with their full MatchResult).
+ * Written to <path>.tmp then renamed, so a crash never leaves a half-written checkpoint.
+ * The number of matches is not part of the identity: a finished run can be resumed with a
+ * larger --matches to extend it.
+ */
+class Checkpoint {
+public:
+    static void save(const std::string& path, const MatchRunnerConfig& cfg, const RunState& state);
+
+    // fresh is the initial state of this configuration (strategy names, seats);
+    // throws std::runtime_error when the file does not belong to the same run
+    static RunState load(const std::string& path, const MatchRunnerConfig& cfg, const RunState& fresh);
+};
+
+} // namespace sevens
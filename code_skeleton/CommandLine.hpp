@@ -0,0 +1,89 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <initializer_list>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Minimal option parser for the batch modes of main:
+ *   ./sevens_game batch --matches 1000 --threads 4 builtin:Sentinel7 ./PrudentStrategy.so
+ * "--key value" options and boolean "--flag" options, both declared up front by the mode;
+ * the rest are positional arguments. Throws std::invalid_argument on an undeclared option
+ * or a malformed value.
+ */
+class CommandLine {
+public:
+    CommandLine(int argc, char* argv[], int first, std::initializer_list<const char*> valued,
+                std::initializer_list<const char*> flags = {})
+        : valueNames(valued.begin(), valued.end()), flagNames(flags.begin(), flags.end()) {
+        for (int i = first; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0 || arg.size() == 2) {
+                positional.push_back(arg);
+                continue;
+            }
+            std::string key = arg.substr(2);
+            if (flagNames.count(key)) {
+                options[key] = "1";
+            } else if (!valueNames.count(key)) {
+                throw std::invalid_argument("unknown option --" + key);
+            } else if (i + 1 < argc) {
+                options[key] = argv[++i];
+            } else {
+                throw std::invalid_argument("missing value for --" + key);
+            }
+        }
+    }
+
+    bool has(const std::string& key) const { return options.count(key) != 0; }
+
+    std::string get(const std::string& key, const std::string& fallback) const {
+        auto it = options.find(key);
+        return it == options.end() ? fallback : it->second;
+    }
+
+    uint64_t getU64(const std::string& key, uint64_t fallback) const {
+        auto it = options.find(key);
+        return it == options.end() ? fallback : parseU64(it->second, "--" + key);
+    }
+
+    double getDouble(const std::string& key, double fallback) const {
+        auto it = options.find(key);
+        if (it == options.end()) return fallback;
+        size_t used = 0;
+        double v = 0.0;
+        try {
+            v = std::stod(it->second, &used);
+        } catch (const std::logic_error&) {
+            used = 0;
+        }
+        if (used == 0 || used != it->second.size()) throw std::invalid_argument("bad value for --" + key + ": " + it->second);
+        return v;
+    }
+
+    // Decimal digits only: no sign, base prefix or blanks ("010" is 10, "-1" is refused)
+    static uint64_t parseU64(const std::string& text, const std::string& what) {
+        uint64_t v = 0;
+        const char* end = text.data() + text.size();
+        auto [last, ec] = std::from_chars(text.data(), end, v);
+        if (text.empty() || ec != std::errc() || last != end) throw std::invalid_argument("bad value for " + what + ": " + text);
+        return v;
+    }
+
+    const std::vector<std::string>& args() const { return positional; }
+
+private:
+    std::set<std::string> valueNames;
+    std::set<std::string> flagNames;
+    std::unordered_map<std::string, std::string> options;
+    std::vector<std::string> positional;
+};
+
+} // namespace sevens
@@ -0,0 +1,181 @@
+#include "DealCorpus.hpp"
+#include "VariantGame.hpp"
+#include "Symmetry.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+namespace sevens {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'V', 'N', 'S', 'D', 'E', 'A', 'L'};
+constexpr size_t kRecordSize = 32;
+constexpr size_t kRecordSizeWithTable = 40;
+
+// Fixed-width fields of the header, little-endian like the records
+template <typename T>
+void put(unsigned char* at, T v) {
+    for (size_t i = 0; i < sizeof(T); ++i) at[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+template <typename T>
+T get(const unsigned char* at) {
+    T v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) v |= static_cast<T>(at[i]) << (8 * i);
+    return v;
+}
+
+} // namespace
+
+DealCorpus::DealCorpus(const std::string& path) : file(path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Corpus de donnes introuvable : " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kHeaderSize) {
+        ::close(fd);
+        throw std::runtime_error("Corpus de donnes invalide : " + path);
+    }
+    mapSize = static_cast<size_t>(st.st_size);
+    map = ::mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        map = nullptr;
+        throw std::runtime_error("Impossible de projeter le corpus en mémoire : " + path);
+    }
+
+    const unsigned char* h = static_cast<const unsigned char*>(map);
+    auto fail = [&](const std::string& why) {
+        ::munmap(map, mapSize);
+        map = nullptr;
+        throw std::runtime_error("Corpus " + path + " : " + why);
+    };
+    if (std::memcmp(h, kMagic, sizeof(kMagic)) != 0) fail("ce n'est pas un corpus de donnes");
+    if (get<uint32_t>(h + 8) != kVersion) fail("version inconnue");
+    nPlayers = get<uint32_t>(h + 12);
+    flags = get<uint32_t>(h + 16);
+    recordSize = get<uint32_t>(h + 20);
+    count = get<uint64_t>(h + 24);
+    genSeed = get<uint64_t>(h + 32);
+    if (nPlayers < 2 || nPlayers > kMaxPlayers) fail("nombre de joueurs invalide");
+    if (recordSize != (hasTables() ? kRecordSizeWithTable : kRecordSize)) fail("taille d'enregistrement invalide");
+    if (count == 0 || (mapSize - kHeaderSize) / recordSize < count) fail("fichier tronqué");
+
+    records = h + kHeaderSize;
+    // Every match reads its own range of deals in order (see MatchRunner)
+    ::madvise(map, mapSize, MADV_SEQUENTIAL);
+}
+
+DealCorpus::~DealCorpus() {
+    if (map) ::munmap(map, mapSize);
+}
+
+uint64_t DealCorpus::fingerprint() const {
+    const unsigned char* p = static_cast<const unsigned char*>(map);
+    const size_t size = kHeaderSize + count * recordSize;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= p[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+uint64_t DealCorpus::generate(const std::string& path, uint64_t deals, unsigned players, uint64_t seed,
+                              unsigned tableCards, bool unique) {
+    if (players < 2 || players > kMaxPlayers) {
+        throw std::invalid_argument("Nombre de joueurs invalide (2 à 15) : " + std::to_string(players));
+    }
+    if (tableCards > 40) throw std::invalid_argument("Trop de cartes sur la table de départ (40 au plus)");
+    if (deals == 0) throw std::invalid_argument("Le corpus doit contenir au moins une donne");
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Impossible d'écrire le corpus : " + path);
+
+    const size_t recordSize = tableCards ? kRecordSizeWithTable : kRecordSize;
+    unsigned char header[kHeaderSize] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    put<uint32_t>(header + 8, kVersion);
+    put<uint32_t>(header + 12, players);
+    put<uint32_t>(header + 16, tableCards ? kHasTables : 0);
+    put<uint32_t>(header + 20, static_cast<uint32_t>(recordSize));
+    put<uint64_t>(header + 24, deals);
+    put<uint64_t>(header + 32, seed);
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    const int openingCard = CardSet<1>::id(Card{2, 7});   // 7♦, as MyGameParser::read_game
+    std::mt19937_64 rng(seed);
+    std::vector<int> pack;
+    pack.reserve(52);
+
+    // Written by chunks of 4096 records
+    const size_t perChunk = 4096;
+    std::vector<unsigned char> chunk;
+    chunk.reserve(perChunk * recordSize);
+
+    // Canonical hashes of the deals written so far (unique); a starting table is a
+    // position, where every suit may move
+    std::unordered_set<uint64_t> seen;
+    const unsigned freeSuits = tableCards ? SuitSymmetry::kPositionSuits : SuitSymmetry::kDealSuits;
+    std::vector<uint64_t> hands(players);
+    uint64_t redrawn = 0;
+
+    for (uint64_t d = 0; d < deals; ++d) {
+        CardSet<1> table;
+        table.set(openingCard);
+        for (unsigned k = 0; k < tableCards; ++k) {
+            CardSet<1> playable = table.playableOn();
+            table.set(playable.nth(static_cast<unsigned>(rng() % playable.count())));
+        }
+
+        pack.clear();
+        for (int id = 0; id < 52; ++id) {
+            if (!table.test(id)) pack.push_back(id);
+        }
+        std::shuffle(pack.begin(), pack.end(), rng);
+        const unsigned dealer = static_cast<unsigned>(rng() % players);
+
+        const size_t at = chunk.size();
+        chunk.resize(at + recordSize, 0);
+        unsigned char* rec = chunk.data() + at;
+        std::memset(rec, 0xFF, 26);   // every card kNotDealt until dealt
+        for (size_t i = 0; i < pack.size(); ++i) {
+            const int id = pack[i];
+            const unsigned owner = static_cast<unsigned>((dealer + i) % players);
+            const int shift = (id & 1) * 4;
+            rec[id >> 1] = static_cast<unsigned char>((rec[id >> 1] & ~(0xF << shift)) | (owner << shift));
+        }
+        if (unique) {
+            std::fill(hands.begin(), hands.end(), 0);
+            for (size_t i = 0; i < pack.size(); ++i) hands[(dealer + i) % players] |= 1ull << pack[i];
+            if (!seen.insert(SuitSymmetry::hash(table.word(0), hands.data(), players, freeSuits, dealer)).second) {
+                chunk.resize(at);
+                if (++redrawn > 100 * deals) throw std::runtime_error("Pas assez de donnes distinctes pour ce corpus");
+                --d;
+                continue;
+            }
+        }
+        rec[26] = static_cast<unsigned char>(dealer);
+        rec[27] = static_cast<unsigned char>(table.count());
+        if (tableCards) put<uint64_t>(rec + 32, table.word(0));
+
+        if (chunk.size() >= perChunk * recordSize || d + 1 == deals) {
+            out.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+            chunk.clear();
+        }
+    }
+    out.flush();
+    if (!out) throw std::runtime_error("Impossible d'écrire le corpus : " + path);
+    return redrawn;
+}
+
+} // namespace sevens
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace sevens {
+
+/**
+ * Fixed deal corpus: the same deals for every run, read in place from a memory-mapped file.
+ *
+ * Layout (little-endian, as mapped):
+ *   0   header   "SVNSDEAL", u32 version, u32 players, u32 flags, u32 record size,
+ *                u64 deal count, u64 seed of the generator (padded to 64 bytes)
+ *   64  records  count x record size bytes:
+ *                  26 bytes  owner of card id (suit * 13 + rank - 1), one nibble per card,
+ *                            low nibble first; 0xF = not dealt (on the table)
+ *                   1 byte   dealer (the player after the dealer moves first)
+ *                   1 byte   cards on the starting table
+ *                   4 bytes  reserved
+ *                   8 bytes  starting table, bit = card id (only with kHasTables)
+ *
+ * Without kHasTables the starting table is the game's own (7♦), whose cards are not dealt.
+ * A deal holds no shuffled order: a hand is its cards by increasing card id.
+ */
+class DealCorpus {
+public:
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kHasTables = 1;
+    static constexpr unsigned kNotDealt = 0xF;
+    static constexpr unsigned kMaxPlayers = 15;
+    static constexpr size_t kHeaderSize = 64;
+
+    /**
+     * One deal, pointing into the mapping (no copy).
+     */
+    class Deal {
+    public:
+        explicit Deal(const unsigned char* record, bool hasTable) : p(record), withTable(hasTable) {}
+
+        unsigned owner(int card) const { return (p[card >> 1] >> ((card & 1) * 4)) & 0xF; }
+        unsigned dealer() const { return p[26]; }
+        unsigned tableCards() const { return p[27]; }
+        bool hasTable() const { return withTable; }
+
+        uint64_t table() const {
+            uint64_t bits = 0;
+            if (withTable) std::memcpy(&bits, p + 32, sizeof(bits));
+            return bits;
+        }
+
+    private:
+        const unsigned char* p;
+        bool withTable;
+    };
+
+    // Maps the file read-only; throws std::runtime_error when it is not a valid corpus
+    explicit DealCorpus(const std::string& path);
+    ~DealCorpus();
+
+    DealCorpus(const DealCorpus&) = delete;
+    DealCorpus& operator=(const DealCorpus&) = delete;
+
+    uint64_t size() const { return count; }
+    unsigned players() const { return nPlayers; }
+    bool hasTables() const { return flags & kHasTables; }
+    uint64_t seed() const { return genSeed; }
+    const std::string& path() const { return file; }
+
+    // FNV-1a of the header and the records: the same deals give the same value, whatever the
+    // file is called (reads the whole mapping)
+    uint64_t fingerprint() const;
+
+    Deal deal(uint64_t i) const { return Deal(records + i * recordSize, hasTables()); }
+
+    /**
+     * Writes `deals` deals for `players` players (2..15) drawn from `seed`.
+     * tableCards > 0 stores a starting table: 7♦ plus that many random legal plays.
+     * unique: a deal equivalent to one already written up to a suit permutation
+     * (Symmetry.hpp) is drawn again. Returns the number of deals drawn again.
+     */
+    static uint64_t generate(const std::string& path, uint64_t deals, unsigned players, uint64_t seed,
+                             unsigned tableCards = 0, bool unique = false);
+
+private:
+    std::string file;
+    void* map = nullptr;
+    size_t mapSize = 0;
+    const unsigned char* records = nullptr;
+    uint64_t count = 0;
+    unsigned nPlayers = 0;
+    uint32_t flags = 0;
+    uint32_t recordSize = 0;
+    uint64_t genSeed = 0;
+};
+
+} // namespace sevens
@@ -0,0 +1,424 @@
+#include "Distributed.hpp"
+#include "BinaryIO.hpp"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace sevens {
+
+namespace {
+
+constexpr uint64_t kProtocolVersion = 3;
+constexpr uint32_t kMaxFrame = 64u << 20;
+
+enum class Message : uint8_t {
+    Hello = 1,
+    Config,
+    Ready,
+    Request,
+    Unit,
+    Results,
+    Done
+};
+
+struct Unit {
+    uint64_t first;
+    uint64_t last;
+};
+
+using Clock = std::chrono::steady_clock;
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool sendFrame(int fd, Message type, const std::string& payload = std::string()) {
+    uint32_t len = static_cast<uint32_t>(payload.size() + 1);
+    std::string frame;
+    for (int i = 0; i < 4; ++i) frame += static_cast<char>(len >> (8 * i));
+    frame += static_cast<char>(type);
+    frame += payload;
+    return sendAll(fd, frame);
+}
+
+// Extracts one complete frame from the front of buffer (false if not complete yet)
+bool takeFrame(std::string& buffer, Message& type, std::string& payload) {
+    if (buffer.size() < 4) return false;
+    uint32_t len = 0;
+    for (int i = 0; i < 4; ++i) len |= static_cast<uint32_t>(static_cast<uint8_t>(buffer[i])) << (8 * i);
+    if (len == 0 || len > kMaxFrame) throw std::runtime_error("invalid frame");
+    if (buffer.size() < 4 + static_cast<size_t>(len)) return false;
+    type = static_cast<Message>(buffer[4]);
+    payload.assign(buffer, 5, len - 1);
+    buffer.erase(0, 4 + static_cast<size_t>(len));
+    return true;
+}
+
+// Blocking read of the next frame (worker side)
+bool recvFrame(int fd, std::string& buffer, Message& type, std::string& payload) {
+    char chunk[64 * 1024];
+    while (!takeFrame(buffer, type, payload)) {
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+    return true;
+}
+
+std::string peerName(const sockaddr_in& addr) {
+    char ip[INET_ADDRSTRLEN] = "?";
+    ::inet_ntop(AF_INET, &addr.sin_addr, ip, sizeof(ip));
+    return std::string(ip) + ":" + std::to_string(ntohs(addr.sin_port));
+}
+
+struct Client {
+    int fd = -1;
+    std::string peer;
+    std::string in;
+    unsigned threads = 0;
+    bool ready = false;
+    bool waiting = false;             // asked for a unit while none was available
+    bool hasUnit = false;
+    Unit unit{0, 0};
+    Clock::time_point assignedAt;
+    uint64_t played = 0;
+};
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// Coordinator
+// -----------------------------------------------------------------------------
+
+Coordinator::Coordinator(CoordinatorConfig config) : cfg(std::move(config)) {
+    if (cfg.run.specs.size() < 2) throw std::invalid_argument("Coordinator: at least two strategies are needed");
+    if (cfg.unitSize == 0) cfg.unitSize = 1;
+}
+
+MatchReport Coordinator::run() {
+    const MatchRunnerConfig& run = cfg.run;
+
+    int listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(cfg.port));
+    if (listenFd < 0 || ::inet_pton(AF_INET, cfg.bind.c_str(), &addr.sin_addr) != 1 ||
+        ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listenFd, 64) != 0) {
+        if (listenFd >= 0) ::close(listenFd);
+        throw std::runtime_error("Coordinator: impossible d'écouter sur " + cfg.bind + ":" + std::to_string(cfg.port));
+    }
+    std::cout << "[coordinator] " << run.matches << " matches in units of " << cfg.unitSize
+              << ", listening on " << cfg.bind << ':' << cfg.port << std::endl;
+
+    // Everything the workers need to rebuild the same MatchRunner
+    std::string configPayload;
+    {
+        std::ostringstream out;
+        BinaryWriter w(out);
+        w.u64(run.seed);
+        w.u64(run.maxScore);
+        w.u64(run.rotateSeats);
+        w.str(run.deals);
+        w.str(run.book);
+        w.u64(run.specs.size());
+        for (const std::string& spec : run.specs) w.str(spec);
+        configPayload = out.str();
+    }
+
+    std::unique_ptr<MatchAggregator> agg;     // created with the strategy names of the first worker
+    std::vector<std::string> names;
+    RunState state;
+    std::deque<Unit> todo;                    // units given back by lost workers
+    uint64_t nextFirst = 0;
+    std::vector<Client> clients;
+    unsigned maxThreads = 0;
+    auto t0 = Clock::now();
+
+    auto takeUnit = [&](Unit& u) {
+        if (!todo.empty()) {
+            u = todo.front();
+            todo.pop_front();
+            return true;
+        }
+        if (nextFirst >= run.matches) return false;
+        u = Unit{nextFirst, std::min(nextFirst + cfg.unitSize, run.matches)};
+        nextFirst = u.last;
+        return true;
+    };
+
+    auto assign = [&](Client& c) {
+        Unit u;
+        if (!takeUnit(u)) {
+            c.waiting = true;
+            return true;
+        }
+        std::ostringstream out;
+        BinaryWriter w(out);
+        w.u64(u.first);
+        w.u64(u.last);
+        c.waiting = false;
+        c.hasUnit = true;
+        c.unit = u;
+        c.assignedAt = Clock::now();
+        return sendFrame(c.fd, Message::Unit, out.str());
+    };
+
+    auto drop = [&](Client& c, const std::string& why) {
+        std::cout << "[coordinator] worker " << c.peer << " lost (" << why << ")";
+        if (c.hasUnit) {
+            std::cout << ", matches [" << c.unit.first << ", " << c.unit.last << ") reassigned";
+            todo.push_front(c.unit);
+        }
+        std::cout << std::endl;
+        ::close(c.fd);
+        c.fd = -1;
+    };
+
+    auto handle = [&](Client& c, Message type, const std::string& payload) -> bool {
+        std::istringstream in(payload);
+        BinaryReader r(in, "worker " + c.peer);
+
+        switch (type) {
+            case Message::Hello: {
+                if (r.u64() != kProtocolVersion) throw std::runtime_error("protocol version mismatch");
+                c.threads = static_cast<unsigned>(r.u64());
+                return sendFrame(c.fd, Message::Config, configPayload);
+            }
+            case Message::Ready: {
+                std::vector<std::string> workerNames(r.u64());
+                for (std::string& n : workerNames) n = r.str();
+                if (!agg) {
+                    names = workerNames;
+                    agg.reset(new MatchAggregator(run.specs, names));
+                    state = agg->initialState();
+                } else if (workerNames != names) {
+                    throw std::runtime_error("different strategy builds than the other workers");
+                }
+                c.ready = true;
+                unsigned active = 0;
+                for (const Client& o : clients) if (o.fd >= 0 && o.ready) active += o.threads;
+                maxThreads = std::max(maxThreads, active);
+                std::cout << "[coordinator] worker " << c.peer << " ready (" << c.threads << " threads)" << std::endl;
+                return true;
+            }
+            case Message::Request:
+                if (!c.ready) throw std::runtime_error("REQUEST before READY");
+                return assign(c);
+            case Message::Results: {
+                uint64_t count = r.u64();
+                for (uint64_t i = 0; i < count; ++i) {
+                    MatchOutcome o = r.outcome();
+                    if (o.matchId < c.unit.first || o.matchId >= c.unit.last) throw std::runtime_error("match outside its unit");
+                    agg->complete(state, std::move(o));   // duplicates are ignored
+                }
+                c.played += count;
+                c.hasUnit = false;
+                return true;
+            }
+            default:
+                throw std::runtime_error("unexpected message");
+        }
+    };
+
+    while (!agg || state.nextMatch < run.matches) {
+        // Lost workers: their units go to the idle ones
+        for (Client& c : clients) {
+            if (c.fd >= 0 && c.hasUnit &&
+                std::chrono::duration<double>(Clock::now() - c.assignedAt).count() > cfg.unitTimeoutSeconds) {
+                drop(c, "unit timeout");
+            }
+        }
+        for (Client& c : clients) {
+            if (c.fd >= 0 && c.waiting && !todo.empty() && !assign(c)) drop(c, "send failed");
+        }
+        clients.erase(std::remove_if(clients.begin(), clients.end(), [](const Client& c) { return c.fd < 0; }),
+                      clients.end());
+
+        std::vector<pollfd> fds{pollfd{listenFd, POLLIN, 0}};
+        for (const Client& c : clients) fds.push_back(pollfd{c.fd, POLLIN, 0});
+        if (::poll(fds.data(), fds.size(), 500) < 0) continue;
+
+        if (fds[0].revents & POLLIN) {
+            sockaddr_in peer{};
+            socklen_t len = sizeof(peer);
+            int fd = ::accept(listenFd, reinterpret_cast<sockaddr*>(&peer), &len);
+            if (fd >= 0) {
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                Client c;
+                c.fd = fd;
+                c.peer = peerName(peer);
+                clients.push_back(c);
+            }
+        }
+
+        for (size_t i = 1; i < fds.size(); ++i) {
+            Client& c = clients[i - 1];
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+            char chunk[64 * 1024];
+            ssize_t n = ::recv(c.fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                drop(c, "disconnected");
+                continue;
+            }
+            c.in.append(chunk, static_cast<size_t>(n));
+            try {
+                Message type;
+                std::string payload;
+                while (c.fd >= 0 && takeFrame(c.in, type, payload)) {
+                    if (!handle(c, type, payload)) drop(c, "send failed");
+                }
+            } catch (const std::exception& e) {
+                drop(c, e.what());
+            }
+        }
+    }
+
+    // Everything folded: release the workers
+    for (Client& c : clients) {
+        if (c.fd < 0) continue;
+        sendFrame(c.fd, Message::Done);
+        std::cout << "[coordinator] worker " << c.peer << " done, " << c.played << " matches" << std::endl;
+        ::close(c.fd);
+    }
+    ::close(listenFd);
+
+    state.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    return MatchRunner::makeReport(state, maxThreads);
+}
+
+// -----------------------------------------------------------------------------
+// RemoteWorker
+// -----------------------------------------------------------------------------
+
+static int connectTo(const RemoteWorkerConfig& cfg) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    auto deadline = Clock::now() + std::chrono::duration<double>(cfg.connectTimeoutSeconds);
+
+    for (;;) {
+        addrinfo* res = nullptr;
+        if (::getaddrinfo(cfg.host.c_str(), std::to_string(cfg.port).c_str(), &hints, &res) == 0) {
+            for (addrinfo* a = res; a; a = a->ai_next) {
+                int fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+                if (fd < 0) continue;
+                if (::connect(fd, a->ai_addr, a->ai_addrlen) == 0) {
+                    ::freeaddrinfo(res);
+                    int one = 1;
+                    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    return fd;
+                }
+                ::close(fd);
+            }
+            ::freeaddrinfo(res);
+        }
+        if (Clock::now() > deadline) {
+            throw std::runtime_error("Worker: impossible de joindre " + cfg.host + ":" + std::to_string(cfg.port));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+}
+
+uint64_t RemoteWorker::run(const RemoteWorkerConfig& cfg) {
+    int fd = connectTo(cfg);
+    std::string buffer, payload;
+    Message type;
+    uint64_t played = 0;
+
+    try {
+        unsigned threads = cfg.threads ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+        {
+            std::ostringstream out;
+            BinaryWriter w(out);
+            w.u64(kProtocolVersion);
+            w.u64(threads);
+            if (!sendFrame(fd, Message::Hello, out.str())) throw std::runtime_error("coordinator closed the connection");
+        }
+        if (!recvFrame(fd, buffer, type, payload) || type != Message::Config) {
+            throw std::runtime_error("no configuration from the coordinator");
+        }
+
+        MatchRunnerConfig rc;
+        {
+            std::istringstream in(payload);
+            BinaryReader r(in, "coordinator");
+            rc.seed = r.u64();
+            rc.maxScore = r.u64();
+            rc.rotateSeats = r.u64() != 0;
+            rc.deals = r.str();
+            rc.book = r.str();
+            rc.specs.resize(r.u64());
+            for (std::string& spec : rc.specs) spec = r.str();
+        }
+        rc.threads = threads;
+        rc.matches = ~0ULL;   // units decide
+        MatchRunner runner(rc);
+
+        {
+            std::vector<std::string> names = runner.strategyNames();
+            std::ostringstream out;
+            BinaryWriter w(out);
+            w.u64(names.size());
+            for (const std::string& n : names) w.str(n);
+            if (!sendFrame(fd, Message::Ready, out.str())) throw std::runtime_error("coordinator closed the connection");
+        }
+
+        std::vector<MatchOutcome> outcomes;
+        std::mutex mutex;
+        for (;;) {
+            if (!sendFrame(fd, Message::Request)) throw std::runtime_error("coordinator closed the connection");
+            if (!recvFrame(fd, buffer, type, payload)) throw std::runtime_error("coordinator closed the connection");
+            if (type == Message::Done) break;
+            if (type != Message::Unit) throw std::runtime_error("unexpected message from the coordinator");
+
+            std::istringstream in(payload);
+            BinaryReader r(in, "coordinator");
+            uint64_t first = r.u64(), last = r.u64();
+
+            outcomes.clear();
+            runner.forEachMatch(first, last, {}, [&](MatchOutcome&& o) {
+                std::lock_guard<std::mutex> lock(mutex);
+                outcomes.push_back(std::move(o));
+            });
+            std::sort(outcomes.begin(), outcomes.end(),
+                      [](const MatchOutcome& a, const MatchOutcome& b) { return a.matchId < b.matchId; });
+
+            std::ostringstream out;
+            BinaryWriter w(out);
+            w.u64(outcomes.size());
+            for (const MatchOutcome& o : outcomes) w.outcome(o);
+            if (!sendFrame(fd, Message::Results, out.str())) throw std::runtime_error("coordinator closed the connection");
+            played += outcomes.size();
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    return played;
+}
+
+} // namespace sevens
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "MatchRunner.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace sevens {
+
+/**
+ * Batch runs spread over several processes / machines.
+ *
+ * The coordinator splits matches [0, matches) into work units of unitSize consecutive match
+ * ids and hands them out over TCP. Each worker loads the strategies itself (same .so paths
+ * on its machine, and the same --deals corpus and --book paths if any), plays its unit on
+ * all its threads and sends back the outcomes. The coordinator folds them in match order
+ * (MatchAggregator) and every seed is derived from (master seed, match id, seat), so the
+ * report is identical to `batch` on one node.
+ *
+ * A worker that disconnects, or holds a unit longer than unitTimeoutSeconds, is dropped
+ * and its unit is given to another worker; a late duplicate of a match is ignored.
+ *
+ * Protocol: frames of { u32 little-endian length, u8 type, payload (BinaryIO.hpp) }
+ *   worker → coordinator : HELLO (version, threads), READY (strategy names), REQUEST,
+ *                          RESULTS (outcomes of the unit)
+ *   coordinator → worker : CONFIG (seed, max score, seat rotation, deal corpus, specs), UNIT (first, last), DONE
+ */
+struct CoordinatorConfig {
+    MatchRunnerConfig run;            // specs, matches, maxScore, seed, rotateSeats
+    std::string bind = "127.0.0.1";   // 0.0.0.0 to accept workers of other machines
+    int port = 7777;
+    uint64_t unitSize = 64;
+    double unitTimeoutSeconds = 300.0;
+};
+
+class Coordinator {
+public:
+    explicit Coordinator(CoordinatorConfig config);
+
+    // Serves workers until every match has been played
+    MatchReport run();
+
+private:
+    CoordinatorConfig cfg;
+};
+
+struct RemoteWorkerConfig {
+    std::string host = "127.0.0.1";
+    int port = 7777;
+    unsigned threads = 0;                 // 0 = all cores
+    double connectTimeoutSeconds = 30.0;  // the coordinator may start after the workers
+};
+
+class RemoteWorker {
+public:
+    // Plays units until the coordinator says DONE; returns the number of matches played
+    static uint64_t run(const RemoteWorkerConfig& config);
+};
+
+} // namespace sevens
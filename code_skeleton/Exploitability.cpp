@@ -0,0 +1,302 @@
+#include "Exploitability.hpp"
+#include "StrategyLoader.hpp"
+#include "MatchRunner.hpp"
+#include "Features.hpp"
+#include "WorkScheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+namespace sevens {
+
+namespace {
+
+constexpr unsigned kMaxSeats = SelfPlayRecord::kMaxPlayers;
+
+struct Event {
+    uint8_t player;
+    int8_t card;                      // -1 = pass
+};
+
+// A round of the 52-card game as masks, with what happened so far
+struct State {
+    unsigned players = 4;
+    uint64_t hands[kMaxSeats] = {};
+    uint64_t table = 0;
+    unsigned player = 0;
+    unsigned passesInARow = 0;
+    bool finished = false;
+    std::vector<Event> history;
+
+    bool over() const { return finished || passesInARow >= players; }
+    unsigned left(unsigned p) const { return static_cast<unsigned>(__builtin_popcountll(hands[p])); }
+};
+
+/**
+ * Strategies seated at a State: keeps their TableLayout in step and forwards the
+ * notifications as StrategySeats does. start() can join a round in progress: the
+ * strategies are initialized and told the history.
+ */
+class Seats {
+public:
+    void start(const std::vector<std::shared_ptr<PlayerStrategy>>& strategies, const State& s) {
+        seats = &strategies;
+        for (unsigned suit = 0; suit < 4; ++suit) {
+            for (uint64_t rank = 1; rank <= 13; ++rank) layout[suit][rank] = false;
+        }
+        layout[2][7] = true;   // 7♦
+        for (unsigned p = 0; p < s.players; ++p) strategies[p]->initialize(p);
+        for (const Event& e : s.history) notify(e);
+        for (unsigned id = 0; id < 52; ++id) {
+            if (s.table >> id & 1) layout[id / 13][id % 13 + 1] = true;
+        }
+    }
+
+    // Card id the strategy of the player to move picks, -1 for a pass or an illegal card
+    int choose(const State& s) {
+        const unsigned p = s.player;
+        hand.clear();
+        for (uint64_t m = s.hands[p]; m; m &= m - 1) {
+            const int id = __builtin_ctzll(m);
+            hand.push_back(Card{id / 13, id % 13 + 1});
+        }
+        const int idx = (*seats)[p]->selectCardToPlay(hand, layout);
+        if (idx < 0 || static_cast<size_t>(idx) >= hand.size()) return -1;
+        const int id = hand[idx].suit * 13 + hand[idx].rank - 1;
+        return Features::legal(s.hands[p], s.table) >> id & 1 ? id : -1;
+    }
+
+    void apply(State& s, int card) {
+        const Event e{static_cast<uint8_t>(s.player), static_cast<int8_t>(card)};
+        s.history.push_back(e);
+        if (card >= 0) {
+            s.hands[s.player] &= ~(1ull << card);
+            s.table |= 1ull << card;
+            layout[card / 13][card % 13 + 1] = true;
+            s.passesInARow = 0;
+            s.finished = s.hands[s.player] == 0;
+        } else {
+            ++s.passesInARow;
+        }
+        notify(e);
+        s.player = (s.player + 1) % s.players;
+    }
+
+    // The strategies play the round to its end
+    void playOut(State& s) {
+        while (!s.over()) {
+            apply(s, Features::legal(s.hands[s.player], s.table) ? choose(s) : -1);
+        }
+    }
+
+private:
+    void notify(const Event& e) {
+        if (e.card >= 0) {
+            const Card c{e.card / 13, e.card % 13 + 1};
+            for (const auto& strategy : *seats) strategy->observeMove(e.player, c);
+        } else {
+            (*seats)[e.player]->observePass(e.player);
+        }
+    }
+
+    const std::vector<std::shared_ptr<PlayerStrategy>>* seats = nullptr;
+    TableLayout layout;
+    std::vector<Card> hand;
+};
+
+struct DealResult {
+    double baselineLeft = 0.0;
+    double responseLeft = 0.0;
+    double baselineWin = 0.0;
+    double responseWin = 0.0;
+    uint64_t decisions = 0;
+    uint64_t rollouts = 0;
+};
+
+// Share of the round won by seat b (fewest cards left, ties shared)
+double winShare(const State& s, unsigned b) {
+    unsigned best = 52, tied = 0;
+    for (unsigned p = 0; p < s.players; ++p) best = std::min(best, s.left(p));
+    for (unsigned p = 0; p < s.players; ++p) tied += s.left(p) == best;
+    return s.left(b) == best ? 1.0 / tied : 0.0;
+}
+
+class Evaluator {
+public:
+    Evaluator(const ExploitConfig& cfg, const std::vector<StrategyFactory>& factories) : cfg(cfg), factories(factories) {}
+
+    DealResult run(uint64_t d) {
+        DealResult result;
+        const unsigned nP = cfg.players;
+        const unsigned b = static_cast<unsigned>(d % nP);
+        std::mt19937_64 rng(MatchRunner::deriveSeed(cfg.seed, d, 0));
+
+        // Deal as VariantGame<1>: 7♦ on the table, 51 cards from the seat after a random dealer
+        State dealt;
+        dealt.players = nP;
+        int pack[51];
+        for (int id = 0, n = 0; id < 52; ++id) {
+            if (id != 32) pack[n++] = id;
+        }
+        std::shuffle(pack, pack + 51, rng);
+        const unsigned dealer = static_cast<unsigned>(rng() % nP);
+        for (unsigned i = 0; i < 51; ++i) dealt.hands[(dealer + i) % nP] |= 1ull << pack[i];
+        dealt.table = 1ull << 32;
+        dealt.player = (dealer + 1) % nP;
+
+        State baseline = dealt;
+        auto strategies = lineUp(d, 1);
+        Seats seats;
+        seats.start(strategies, baseline);
+        seats.playOut(baseline);
+        result.baselineLeft = baseline.left(b);
+        result.baselineWin = winShare(baseline, b);
+
+        // Same deal and seeds, seat b best-responding
+        State s = dealt;
+        strategies = lineUp(d, 1);
+        rollout = lineUp(d, 2);
+        seats.start(strategies, s);
+        std::mt19937_64 sampler(MatchRunner::deriveSeed(cfg.seed, d, 3));
+        while (!s.over()) {
+            const uint64_t legal = Features::legal(s.hands[s.player], s.table);
+            int card = -1;
+            if (s.player != b) {
+                card = legal ? seats.choose(s) : -1;
+            } else if (legal & (legal - 1)) {
+                card = respond(d, s, legal, sampler, result);
+            } else if (legal) {
+                card = __builtin_ctzll(legal);
+            }
+            seats.apply(s, card);
+        }
+        result.responseLeft = s.left(b);
+        result.responseWin = winShare(s, b);
+        return result;
+    }
+
+private:
+    // Strategies of deal d, seeded from (seed, d, stream * kMaxSeats + 1 + seat)
+    std::vector<std::shared_ptr<PlayerStrategy>> lineUp(uint64_t d, uint64_t stream) const {
+        std::vector<std::shared_ptr<PlayerStrategy>> strategies;
+        for (unsigned p = 0; p < cfg.players; ++p) {
+            strategies.push_back(factories[p % factories.size()].create(seedOf(d, stream, p)));
+        }
+        return strategies;
+    }
+
+    // The same strategies seeded again, as lineUp(d, stream) would
+    void reseed(std::vector<std::shared_ptr<PlayerStrategy>>& strategies, uint64_t d, uint64_t stream) const {
+        for (unsigned p = 0; p < cfg.players; ++p) {
+            factories[p % factories.size()].seed(*strategies[p], seedOf(d, stream, p));
+        }
+    }
+
+    uint64_t seedOf(uint64_t d, uint64_t stream, unsigned p) const {
+        return MatchRunner::deriveSeed(cfg.seed, d, stream * kMaxSeats + 1 + p);
+    }
+
+    // Card of the responder with the fewest cards left over the determinizations. Before
+    // each rollout the strategies are seeded again from their world (stream 4 + world of
+    // the deal), the same for every card: common random numbers for the strategies too.
+    int respond(uint64_t d, const State& s, uint64_t legal, std::mt19937_64& sampler, DealResult& result) {
+        const unsigned b = s.player;
+        const uint64_t firstWorld = result.decisions++ * cfg.samples;
+
+        // Cards b cannot see, dealt again to the others
+        int unseen[52];
+        unsigned nUnseen = 0;
+        for (int id = 0; id < 52; ++id) {
+            if (!((s.table | s.hands[b]) >> id & 1)) unseen[nUnseen++] = id;
+        }
+        std::vector<State> worlds(cfg.samples, s);
+        for (State& w : worlds) {
+            std::shuffle(unseen, unseen + nUnseen, sampler);
+            unsigned next = 0;
+            for (unsigned p = 0; p < s.players; ++p) {
+                if (p == b) continue;
+                const unsigned n = s.left(p);
+                w.hands[p] = 0;
+                for (unsigned i = 0; i < n; ++i) w.hands[p] |= 1ull << unseen[next++];
+            }
+        }
+
+        int best = -1;
+        double bestLeft = 1e9;
+        Seats seats;
+        for (uint64_t m = legal; m; m &= m - 1) {
+            const int card = __builtin_ctzll(m);
+            double total = 0.0;
+            for (unsigned i = 0; i < cfg.samples; ++i) {
+                reseed(rollout, d, 4 + firstWorld + i);
+                State r = worlds[i];
+                seats.start(rollout, r);
+                seats.apply(r, card);
+                seats.playOut(r);
+                total += r.left(b);
+                ++result.rollouts;
+            }
+            if (total < bestLeft) {
+                bestLeft = total;
+                best = card;
+            }
+        }
+        return best;
+    }
+
+    const ExploitConfig& cfg;
+    const std::vector<StrategyFactory>& factories;
+    std::vector<std::shared_ptr<PlayerStrategy>> rollout;
+};
+
+} // namespace
+
+ExploitReport evaluateExploitability(const ExploitConfig& cfg) {
+    if (cfg.specs.empty()) throw std::invalid_argument("Il faut au moins une stratégie");
+    if (cfg.players < 2 || cfg.players > kMaxSeats) {
+        throw std::invalid_argument("Nombre de joueurs invalide (2 à 8) : " + std::to_string(cfg.players));
+    }
+    if (cfg.samples == 0) throw std::invalid_argument("Il faut au moins une détermination par décision");
+    if (cfg.deals < 2) throw std::invalid_argument("Il faut au moins deux donnes pour un intervalle de confiance");
+
+    std::vector<StrategyFactory> factories;
+    for (const std::string& spec : cfg.specs) factories.emplace_back(spec);
+
+    std::vector<DealResult> results(cfg.deals);
+    WorkScheduler scheduler(0, cfg.deals, cfg.threads);
+    scheduler.run([&](WorkScheduler::Tasks& tasks) {
+        Evaluator evaluator(cfg, factories);
+        for (uint64_t d; tasks.next(d);) results[d] = evaluator.run(d);
+    });
+
+    ExploitReport report;
+    report.deals = cfg.deals;
+    double gainSq = 0.0;
+    for (const DealResult& r : results) {
+        report.decisions += r.decisions;
+        report.rollouts += r.rollouts;
+        report.baselineLeft += r.baselineLeft;
+        report.responseLeft += r.responseLeft;
+        report.baselineWins += r.baselineWin;
+        report.responseWins += r.responseWin;
+        const double gain = r.baselineLeft - r.responseLeft;
+        report.gain += gain;
+        gainSq += gain * gain;
+    }
+    const double n = static_cast<double>(cfg.deals);
+    report.baselineLeft /= n;
+    report.responseLeft /= n;
+    report.baselineWins /= n;
+    report.responseWins /= n;
+    report.gain /= n;
+    const double variance = std::max(0.0, (gainSq - n * report.gain * report.gain) / (n - 1));
+    const double half = 1.96 * std::sqrt(variance / n);
+    report.gainLow = report.gain - half;
+    report.gainHigh = report.gain + half;
+    return report;
+}
+
+} // namespace sevens
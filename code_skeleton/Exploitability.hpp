@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Exploitability estimate of a line-up (mode `exploit`): how much a player gains by
+ * best-responding to the strategies instead of playing them.
+ *
+ * In deal d (52-card game, seat p played by specs[p % specs.size()]), seat b = d % players
+ * is the responder. The round is played twice on the same deal with the same strategy
+ * seeds: once as is (baseline), once with seat b replaced by a sampled best response while
+ * the other seats stay frozen. At each of its decisions with a choice, the responder draws
+ * `samples` determinizations (the cards it cannot see dealt at random to the others, hand
+ * sizes kept) and plays every legal card in each of them, the rest of the round played by
+ * the strategies (its own seat by its baseline strategy), replayed from the notifications
+ * of the round so far; it plays the card with the fewest cards left on average. The same
+ * determinizations, and the same strategy seeds in each of them, serve every card (common
+ * random numbers).
+ *
+ * This is one step of policy improvement, so the gain is a lower bound of the true
+ * best-response gain, up to the sampling noise. The gain per deal is the baseline's cards
+ * left minus the responder's; deals are independent, so the mean comes with a normal 95%
+ * confidence interval. Deals run in parallel; the strategies of a deal are created and
+ * seeded for it, so the report does not depend on the thread count.
+ */
+struct ExploitConfig {
+    std::vector<std::string> specs;
+    unsigned players = 4;
+    uint64_t deals = 1000;
+    unsigned samples = 8;             // determinizations per decision
+    unsigned threads = 0;             // 0 = std::thread::hardware_concurrency()
+    uint64_t seed = 0;
+};
+
+struct ExploitReport {
+    uint64_t deals = 0;
+    uint64_t decisions = 0;           // responder decisions with a choice
+    uint64_t rollouts = 0;
+    double baselineLeft = 0.0;        // mean cards left of the responder's seat, as is
+    double responseLeft = 0.0;        // same, best-responding
+    double gain = 0.0;                // baselineLeft - responseLeft
+    double gainLow = 0.0;             // 95% confidence interval of the gain
+    double gainHigh = 0.0;
+    double baselineWins = 0.0;        // round wins of the seat (ties shared), fraction of the deals
+    double responseWins = 0.0;
+};
+
+ExploitReport evaluateExploitability(const ExploitConfig& cfg);
+
+} // namespace sevens
@@ -0,0 +1,405 @@
+#pragma once
+
+#include "PlayerStrategy.hpp"
+#include "SelfPlay.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * What a player sees at a decision of the 52-card game, as masks: the input of Features.
+ * Card masks use the card id as bit (suit * 13 + rank - 1); seat arrays start at the
+ * decider and follow the turn order, as in SelfPlayRecord.
+ */
+struct FeatureInput {
+    uint64_t hand = 0;
+    uint64_t table = 0;
+    uint8_t handSizes[SelfPlayRecord::kMaxPlayers] = {};
+    uint8_t passes[SelfPlayRecord::kMaxPlayers] = {};
+    uint8_t players = 4;
+    uint8_t passesInARow = 0;
+
+    static FeatureInput of(const SelfPlayRecord& r) {
+        FeatureInput in;
+        in.hand = r.hand;
+        in.table = r.table;
+        for (unsigned i = 0; i < SelfPlayRecord::kMaxPlayers; ++i) {
+            in.handSizes[i] = r.handSizes[i];
+            in.passes[i] = r.passes[i];
+        }
+        in.players = r.players;
+        in.passesInARow = r.passesInARow;
+        return in;
+    }
+};
+
+/**
+ * Standard feature vector of a decision, shared by the heuristic strategies, the learned
+ * ones and the self-play trainers. Everything is computed on 13-bit suit rows (bit
+ * rank - 1) with shifts, masks and bit counts, with no loop over the cards (the few
+ * conditionals compile to selects). The row primitives work for any number of suits
+ * (variants); the vectors are those of the 52-card game.
+ *
+ * State features (kState floats, per decision), suit s = 0..3 at 8 * s:
+ *   +0  cards of the suit held / 13        +4  7 of the suit on the table
+ *   +1  held below the 7 / 6               +5  table cards below the 7 / 6
+ *   +2  held above the 7 / 6               +6  table cards above the 7 / 6
+ *   +3  7 of the suit held                 +7  playable cards of the suit held / 2
+ * then at 32:
+ *   32  1 (constant)                       40  own passes / 13
+ *   33  hand size / 13                     41  passes of the others / 26
+ *   34  table cards / 52                   42  distance of the hand / 39 (see distance())
+ *   35  playable cards held / 8            43  cards held back by us / 39 (see blocked())
+ *   36  players / 8                        44  cards in the other hands / 39
+ *   37  passes in a row / players          45  suits with no card held / 4
+ *   38  hand size of the next player / 13  46  hand size of the third player / 13
+ *   39  smallest other hand / 13           47  hand size of the fourth player / 13
+ *
+ * Move features (kMove floats, per playable card c):
+ *   0  1 (constant)                        8  our cards c makes playable / 4 (unlocks())
+ *   1  c is a 7                            9  other cards c makes playable / 2
+ *   2  c is a 6 or an 8                   10  our cards in a run with c / 6 (run())
+ *   3  c is an ace or a king              11  our cards of the suit beyond c / 6
+ *   4  distance of c from the 7 / 6       12  cards no longer held back by us / 12
+ *   5  c is below the 7                   13  distance of the hand saved / 12
+ *   6  cards of the suit left after c / 13  14  playable cards held after c / 8
+ *   7  c is the last card of its suit     15  table cards of the suit after c / 13
+ *
+ * A model scores a move on the kInputs floats of [state, move]. Header-only, like
+ * ScratchArena, so strategy .so files use it without linking anything.
+ */
+class Features {
+public:
+    static constexpr unsigned kState = 48;
+    static constexpr unsigned kMove = 16;
+    static constexpr unsigned kInputs = kState + kMove;
+    static constexpr unsigned kMaxMoves = 12;   // at most 3 playable cards per suit
+
+    static constexpr unsigned kRow = 0x1FFF;
+    static constexpr unsigned kSeven = 1u << 6;
+    static constexpr unsigned kBelow = kSeven - 1;
+    static constexpr unsigned kAbove = kRow & ~(kSeven | kBelow);
+
+    // ── Row primitives (one suit, bit rank - 1) ──────────────────────────────
+
+    static unsigned row(uint64_t mask, unsigned suit) { return static_cast<unsigned>(mask >> (13 * suit)) & kRow; }
+
+    // Cards of a row. SWAR count rather than __builtin_popcount, which is a library call
+    // unless the build targets a CPU with POPCNT (the documented flags do not)
+    static unsigned count(unsigned bits) {
+        bits = bits - ((bits >> 1) & 0x5555);
+        bits = (bits & 0x3333) + ((bits >> 2) & 0x3333);
+        bits = (bits + (bits >> 4)) & 0x0F0F;
+        return (bits + (bits >> 8)) & 0x1F;
+    }
+
+    // Cards of the suit that may be played on this table row: its 7, or a neighbour
+    static unsigned playable(unsigned table) { return ((table << 1) | (table >> 1) | kSeven) & ~table & kRow; }
+
+    // Our cards that `card` (a bit of the row) makes playable
+    static unsigned unlocks(unsigned hand, unsigned table, unsigned card) {
+        return count(playable(table | card) & ~playable(table) & hand & ~card);
+    }
+
+    // Other cards (not held, not on the table) that `card` makes playable
+    static unsigned releases(unsigned hand, unsigned table, unsigned card) {
+        return count(playable(table | card) & ~playable(table) & ~hand & ~card);
+    }
+
+    // Our cards in a run of consecutive ranks with bit b, both directions, b excluded
+    static unsigned run(unsigned hand, unsigned b) {
+        const unsigned up = static_cast<unsigned>(__builtin_ctz(~(hand >> (b + 1))));
+        const unsigned gaps = ~hand & ((1u << b) - 1);
+        const int lowestGap = gaps ? 31 - __builtin_clz(gaps) : -1;
+        return up + static_cast<unsigned>(static_cast<int>(b) - 1 - lowestGap);
+    }
+
+    /**
+     * Cards held by nobody we know of that wait behind one of our cards: all the suit when
+     * we hold its 7 and it is not on the table, else those beyond our card nearest to the
+     * table on each side.
+     */
+    static unsigned blocked(unsigned hand, unsigned table) {
+        const unsigned outside = ~(hand | table) & kRow;
+        const unsigned below = hand & kBelow & ~table;
+        const unsigned beneath = (1u << (31 - __builtin_clz(below | 1))) - 1;   // under the highest one
+        const unsigned above = hand & kAbove & ~table;
+        const unsigned nearAbove = above & (0u - above);
+        const unsigned sides = count(outside & beneath) + count(outside & ~((nearAbove << 1) - 1));
+        const unsigned sevenHeld = 0u - ((hand & ~table & kSeven) >> 6);
+        return (count(outside) & sevenHeld) | (sides & ~sevenHeld);
+    }
+
+    /**
+     * Cards of others between our farthest card and the table, on both sides: how many
+     * plays of the others our last card of the suit waits for (the 7 counts as on the
+     * table, we can always lay it).
+     */
+    static unsigned distance(unsigned hand, unsigned table) {
+        const unsigned laid = table | kSeven;
+        const unsigned outside = ~(hand | table) & kRow;
+        const unsigned below = hand & ~laid & kBelow;
+        const unsigned bottom = laid & (0u - laid);
+        const unsigned lowSpan = (bottom - 1) & ~((below & (0u - below)) - 1);
+        const unsigned above = hand & ~laid & kAbove;
+        const unsigned top = 1u << (31 - __builtin_clz(laid));
+        const unsigned far = above ? 1u << (31 - __builtin_clz(above)) : top;
+        const unsigned highSpan = ((far << 1) - 1) & ~((top << 1) - 1);
+        return count(outside & (lowSpan | highSpan));
+    }
+
+    // ── Masks from the strategy API (52-card game; cards of other suits are ignored) ──
+
+    static uint64_t handMask(const std::vector<Card>& hand) {
+        uint64_t m = 0;
+        for (const Card& c : hand) {
+            if (c.suit >= 0 && c.suit < 4 && c.rank >= 1 && c.rank <= 13) m |= 1ull << (c.suit * 13 + c.rank - 1);
+        }
+        return m;
+    }
+
+    static uint64_t tableMask(const TableLayout& table) {
+        uint64_t m = 0;
+        for (const auto& [suit, ranks] : table) {
+            if (suit >= 4) continue;
+            for (const auto& [rank, on] : ranks) {
+                if (on && rank >= 1 && rank <= 13) m |= 1ull << (suit * 13 + rank - 1);
+            }
+        }
+        return m;
+    }
+
+    // Playable cards of a hand on a table (masks)
+    static uint64_t legal(uint64_t hand, uint64_t table) {
+        uint64_t m = 0;
+        for (unsigned s = 0; s < 4; ++s) m |= static_cast<uint64_t>(playable(row(table, s))) << (13 * s);
+        return m & hand;
+    }
+
+    // ── Vectors ──────────────────────────────────────────────────────────────
+
+    // kState floats
+    static void state(const FeatureInput& in, float* out) {
+        unsigned cards = 0, laid = 0, legalCards = 0, held = 0, far = 0, voids = 0;
+        for (unsigned s = 0; s < 4; ++s) {
+            const unsigned h = row(in.hand, s), t = row(in.table, s);
+            const unsigned p = count(playable(t) & h);
+            float* f = out + 8 * s;
+            f[0] = count(h) * (1.0f / 13);
+            f[1] = count(h & kBelow) * (1.0f / 6);
+            f[2] = count(h & kAbove) * (1.0f / 6);
+            f[3] = static_cast<float>((h >> 6) & 1);
+            f[4] = static_cast<float>((t >> 6) & 1);
+            f[5] = count(t & kBelow) * (1.0f / 6);
+            f[6] = count(t & kAbove) * (1.0f / 6);
+            f[7] = p * (1.0f / 2);
+            cards += count(h);
+            laid += count(t);
+            legalCards += p;
+            held += blocked(h, t);
+            far += distance(h, t);
+            voids += h == 0;
+        }
+
+        const unsigned nP = in.players < 2 ? 2 : in.players;
+        unsigned others = 0, otherPasses = 0, smallest = 13;
+        for (unsigned i = 1; i < nP && i < SelfPlayRecord::kMaxPlayers; ++i) {
+            others += in.handSizes[i];
+            otherPasses += in.passes[i];
+            smallest = in.handSizes[i] < smallest ? in.handSizes[i] : smallest;
+        }
+
+        float* g = out + 32;
+        g[0] = 1.0f;
+        g[1] = cards * (1.0f / 13);
+        g[2] = laid * (1.0f / 52);
+        g[3] = legalCards * (1.0f / 8);
+        g[4] = nP * (1.0f / 8);
+        g[5] = static_cast<float>(in.passesInARow) / static_cast<float>(nP);
+        g[6] = in.handSizes[1] * (1.0f / 13);
+        g[7] = smallest * (1.0f / 13);
+        g[8] = in.passes[0] * (1.0f / 13);
+        g[9] = otherPasses * (1.0f / 26);
+        g[10] = far * (1.0f / 39);
+        g[11] = held * (1.0f / 39);
+        g[12] = others * (1.0f / 39);
+        g[13] = voids * (1.0f / 4);
+        g[14] = in.handSizes[2] * (1.0f / 13);
+        g[15] = in.handSizes[3] * (1.0f / 13);
+    }
+
+    // kMove floats for card id `card` (playable in the hand)
+    static void move(const FeatureInput& in, int card, float* out) {
+        const unsigned s = static_cast<unsigned>(card) / 13, b = static_cast<unsigned>(card) % 13;
+        const unsigned c = 1u << b;
+        const unsigned h = row(in.hand, s), t = row(in.table, s);
+        const unsigned after = h & ~c;
+        const unsigned beyond = b < 6 ? count(h & (c - 1)) : b > 6 ? count(h >> (b + 1)) : count(h) - 1;
+        const unsigned dist = b > 6 ? b - 6 : 6 - b;
+        const int freed = static_cast<int>(blocked(h, t)) - static_cast<int>(blocked(after, t | c));
+        const int saved = static_cast<int>(distance(h, t)) - static_cast<int>(distance(after, t | c));
+
+        unsigned playableAfter = 0;
+        for (unsigned o = 0; o < 4; ++o) {
+            const unsigned ho = o == s ? after : row(in.hand, o);
+            const unsigned to = o == s ? (t | c) : row(in.table, o);
+            playableAfter += count(playable(to) & ho);
+        }
+
+        out[0] = 1.0f;
+        out[1] = static_cast<float>(b == 6);
+        out[2] = static_cast<float>(b == 5 || b == 7);
+        out[3] = static_cast<float>(b == 0 || b == 12);
+        out[4] = dist * (1.0f / 6);
+        out[5] = static_cast<float>(b < 6);
+        out[6] = count(after) * (1.0f / 13);
+        out[7] = static_cast<float>(after == 0);
+        out[8] = unlocks(h, t, c) * (1.0f / 4);
+        out[9] = releases(h, t, c) * (1.0f / 2);
+        out[10] = run(h, b) * (1.0f / 6);
+        out[11] = beyond * (1.0f / 6);
+        out[12] = freed * (1.0f / 12);
+        out[13] = saved * (1.0f / 12);
+        out[14] = playableAfter * (1.0f / 8);
+        out[15] = count(t | c) * (1.0f / 13);
+    }
+
+    /**
+     * Every playable card of a decision: cards[i] and the kInputs floats [state, move]
+     * of move i at inputs + i * kInputs (room for kMaxMoves). Returns the number of moves.
+     */
+    static unsigned decision(const FeatureInput& in, float* inputs, int* cards) {
+        state(in, inputs);
+        unsigned n = 0;
+        for (uint64_t m = legal(in.hand, in.table); m; m &= m - 1, ++n) {
+            float* at = inputs + n * kInputs;
+            if (n) for (unsigned i = 0; i < kState; ++i) at[i] = inputs[i];
+            cards[n] = __builtin_ctzll(m);
+            move(in, cards[n], at + kState);
+        }
+        return n;
+    }
+
+    // Batched: the state vectors of n decisions, out + i * kState for decision i
+    static void states(const FeatureInput* in, size_t n, float* out) {
+        for (size_t i = 0; i < n; ++i) state(in[i], out + i * kState);
+    }
+};
+
+/**
+ * The FeatureInput of a strategy's decisions, kept up to date from the notifications of
+ * the PlayerStrategy API, which does not give the table as a mask nor the others' hand
+ * sizes and passes. The table is read from the layout at our first decision and then
+ * follows the moves; a player skipped in turn order between two notifications has
+ * passed (the engine tells a pass only to the passer). The player count is the highest
+ * seat seen, or guessed from our opening hand (51 cards dealt) until every seat has moved.
+ * Tables of more than kMaxSeats seats are not followed (see followed()).
+ */
+class ObservedGame {
+public:
+    static constexpr unsigned kMaxSeats = SelfPlayRecord::kMaxPlayers;
+
+    void reset(uint64_t playerID) {
+        myID = playerID;
+        table = 0;
+        tableKnown = false;
+        openingHandSize = 0;
+        played.fill(0);
+        passes.fill(0);
+        lastActor = -1;
+        passesInARow = 0;
+        highestID = playerID;
+    }
+
+    // At our turn (52-card game)
+    FeatureInput decision(const std::vector<Card>& hand, const TableLayout& layout) {
+        if (!tableKnown) {
+            table = Features::tableMask(layout);
+            tableKnown = true;
+        }
+        if (openingHandSize == 0) openingHandSize = static_cast<unsigned>(hand.size());
+        skippedUntil(myID);
+
+        const unsigned nP = players();
+        FeatureInput in;
+        in.hand = Features::handMask(hand);
+        in.table = table;
+        in.players = static_cast<uint8_t>(nP);
+        in.passesInARow = static_cast<uint8_t>(std::min(passesInARow, 255u));
+        for (unsigned i = 0; i < nP; ++i) {
+            const unsigned seat = static_cast<unsigned>((myID + i) % nP);
+            const unsigned left = i == 0 ? static_cast<unsigned>(hand.size())
+                                         : openingHandSize - std::min(openingHandSize, played[seat]);
+            in.handSizes[i] = static_cast<uint8_t>(left);
+            in.passes[i] = static_cast<uint8_t>(std::min(passes[seat], 255u));
+        }
+        return in;
+    }
+
+    void moved(uint64_t playerID, const Card& card) {
+        skippedUntil(playerID);
+        if (tableKnown && card.suit >= 0 && card.suit < 4) table |= 1ull << (card.suit * 13 + card.rank - 1);
+        if (playerID < kMaxSeats) played[playerID]++;
+        passesInARow = 0;
+        lastActor = static_cast<int>(playerID);
+    }
+
+    void passed(uint64_t playerID) {
+        skippedUntil(playerID);
+        if (playerID < kMaxSeats) passes[playerID]++;
+        passesInARow++;
+        lastActor = static_cast<int>(playerID);
+    }
+
+    // Round as last notified, for a search running between our turns (MonteCarloStrategy);
+    // the table is only known from our first decision on
+    bool tableSeen() const { return tableKnown; }
+    uint64_t tableNow() const { return table; }
+    unsigned cardsLeft(unsigned seat) const { return openingHandSize - std::min(openingHandSize, played[seat]); }
+    int lastToAct() const { return lastActor; }
+
+    unsigned players() const {
+        const unsigned fromHand = openingHandSize ? (51 + openingHandSize / 2) / openingHandSize : 4;
+        const unsigned seen = static_cast<unsigned>(std::min<uint64_t>(highestID + 1, kMaxSeats));
+        return std::max(seen, std::min(std::max(fromHand, 2u), kMaxSeats));
+    }
+
+    // False once a seat past kMaxSeats shows up (large variant tables): the counts are no
+    // longer kept and the strategies fall back to a simple policy
+    bool followed() const { return highestID < kMaxSeats; }
+
+private:
+    // The players between the last one seen and `playerID`, in turn order, have passed.
+    // Leaves lastActor on the seat before playerID, so the move or pass that follows our
+    // own decision does not count the same gap twice.
+    void skippedUntil(uint64_t playerID) {
+        highestID = std::max(highestID, playerID);
+        if (!followed()) return;
+        const unsigned nP = players();
+        const unsigned to = static_cast<unsigned>(playerID % nP);
+        if (lastActor >= 0) {
+            for (unsigned seat = (static_cast<unsigned>(lastActor) + 1) % nP; seat != to; seat = (seat + 1) % nP) {
+                passes[seat]++;
+                passesInARow++;
+            }
+        }
+        lastActor = static_cast<int>((to + nP - 1) % nP);
+    }
+
+    uint64_t myID = 0;
+    uint64_t table = 0;
+    bool tableKnown = false;
+    unsigned openingHandSize = 0;
+    std::array<unsigned, kMaxSeats> played{};
+    std::array<unsigned, kMaxSeats> passes{};
+    int lastActor = -1;                      // seat of the last move or pass seen, -1 = none yet
+    unsigned passesInARow = 0;
+    uint64_t highestID = 0;
+};
+
+} // namespace sevens
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "PlayerStrategy.hpp"
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Per-thread storage for everything a quiet game needs (deck, hands, scores, pass
+ * flags, table). reset() prepares a new game without giving memory back, so after the
+ * first game of a thread MyGameMapper::play_round runs without heap allocations.
+ *
+ * The table handed to the strategies is sparse, as in compute_and_display_game: only the
+ * cards on the table have an entry. TableNodes keeps the nodes of the previous game and
+ * puts them back on insertion, so a warm arena still does not allocate.
+ */
+struct TableNodes {
+    using Ranks = TableLayout::mapped_type;
+
+    std::vector<TableLayout::node_type> suits;
+    std::vector<Ranks::node_type> ranks;
+
+    // Empties the table, keeping its nodes for the next insertions
+    void clear(TableLayout& table) {
+        for (auto& entry : table) {
+            Ranks& row = entry.second;
+            while (!row.empty()) ranks.push_back(row.extract(row.begin()));
+        }
+        while (!table.empty()) suits.push_back(table.extract(table.begin()));
+    }
+
+    // table[suit][rank] = true, from a kept node when there is one
+    void put(TableLayout& table, uint64_t suit, uint64_t rank) {
+        auto s = table.find(suit);
+        if (s == table.end()) {
+            if (suits.empty()) {
+                s = table.emplace(suit, Ranks()).first;
+            } else {
+                TableLayout::node_type node = std::move(suits.back());
+                suits.pop_back();
+                node.key() = suit;
+                s = table.insert(std::move(node)).position;
+            }
+        }
+        Ranks& row = s->second;
+        auto r = row.find(rank);
+        if (r != row.end()) {
+            r->second = true;
+        } else if (ranks.empty()) {
+            row.emplace(rank, true);
+        } else {
+            Ranks::node_type node = std::move(ranks.back());
+            ranks.pop_back();
+            node.key() = rank;
+            node.mapped() = true;
+            row.insert(std::move(node));
+        }
+    }
+};
+
+struct GameArena {
+    std::vector<Card> deck;
+    std::vector<std::vector<Card>> hands;   // only the first nP are in use
+    std::vector<uint64_t> scores;
+    std::vector<uint64_t> moves;            // cards played / passes per player this round
+    std::vector<uint64_t> passes;
+    std::vector<uint64_t> decisionNs;       // time spent in selectCardToPlay (only when timed)
+    std::vector<uint64_t> timeouts;         // decisions over the budget
+    std::vector<uint64_t> ponderNs;         // CPU time spent pondering (set_pondering only)
+    std::vector<bool> passed;
+    std::vector<MoveEvent> history;         // moves and passes of the round, oldest first
+    TableLayout table;
+    TableNodes tableNodes;
+    uint64_t tableMask = 0;                 // same table, bit suit * 13 + rank - 1 (legal moves of the batches)
+
+    void reset(uint64_t nP) {
+        if (hands.size() < nP) hands.resize(nP);
+        for (uint64_t p = 0; p < nP; ++p) {
+            hands[p].clear();
+            hands[p].reserve(52);
+        }
+        scores.assign(nP, 0);
+        moves.assign(nP, 0);
+        passes.assign(nP, 0);
+        decisionNs.assign(nP, 0);
+        timeouts.assign(nP, 0);
+        ponderNs.assign(nP, 0);
+        passed.assign(nP, false);
+        history.clear();
+        history.reserve(128);
+        clearTable();
+    }
+
+    void clearTable() {
+        tableNodes.clear(table);
+        tableMask = 0;
+    }
+
+    // isPlayable on tableMask
+    bool playable(const Card& c) const {
+        const uint64_t row = tableMask >> (c.suit * 13) & 0x1FFF;
+        if (c.rank == 7) return !(row >> 6 & 1);
+        return (c.rank > 1 && (row >> (c.rank - 2) & 1)) || (c.rank < 13 && (row >> c.rank & 1));
+    }
+
+    void put(const Card& c) {
+        tableNodes.put(table, c.suit, c.rank);
+        tableMask |= 1ull << (c.suit * 13 + c.rank - 1);
+    }
+
+    // tableMask of a table filled directly (opening cards, corpus deals)
+    void maskTable() {
+        tableMask = 0;
+        for (const auto& [suit, ranks] : table) {
+            for (const auto& [rank, on] : ranks) {
+                if (on && suit < 4 && rank >= 1 && rank <= 13) tableMask |= 1ull << (suit * 13 + rank - 1);
+            }
+        }
+    }
+
+    static GameArena& forThisThread() {
+        thread_local GameArena arena;
+        return arena;
+    }
+};
+
+} // namespace sevens
@@ -26,6 +26,9 @@ struct Card {
     }
 };
 
+// Table layout as handed to strategies: suit -> rank -> bool (true if on table)
+using TableLayout = std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>;
+
 /**
  * Base class for reading or generating cards.
  * Subclasses must override read_cards(...) to populate cards_hashmap.
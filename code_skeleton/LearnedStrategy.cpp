@@ -0,0 +1,187 @@
+#include "PlayerStrategy.hpp"
+#include "SevensRules.hpp"
+#include "PolicyModel.hpp"
+#include "ScratchArena.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Plays the moves of a trained policy (PolicyModel.hpp, written by `./sevens_game train`)
+ * over the standard feature vector (Features.hpp).
+ *
+ * The model is read once per process at the first initialize(), from $SEVENS_POLICY_MODEL
+ * (default: policy.svm in the working directory). Without a readable model the strategy
+ * plays a small hand-set linear policy, so it always has something to play.
+ *
+ * The feature input (table mask, the others' hand sizes and passes) is kept up to date
+ * from the notifications by ObservedGame. Exports selectCardsBatch for the interleaved
+ * batch runner.
+ */
+class LearnedStrategy : public PlayerStrategy {
+public:
+    LearnedStrategy() {
+        auto seed = static_cast<unsigned long>(
+            std::chrono::system_clock::now().time_since_epoch().count()
+        );
+        rng.seed(seed);
+    }
+
+    ~LearnedStrategy() override = default;
+
+    void initialize(uint64_t playerID) override {
+        if (!model) model = loadModel();
+        game.reset(playerID);
+    }
+
+    int selectCardToPlay(
+        const std::vector<Card>& hand,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override
+    {
+        alignas(16) float inputs[Features::kMaxMoves * Features::kInputs];
+        int cards[Features::kMaxMoves];
+        float scores[Features::kMaxMoves];
+        int choice;
+        const unsigned n = prepare(hand, tableLayout, inputs, cards, choice);
+        if (n < 2) return choice;
+        model->score(inputs, n, scores);
+        return pick(hand, cards, scores, n);
+    }
+
+    /**
+     * Batched decisions (selectCardsBatch export): the feature vectors of every decision
+     * first, then the model on all of them, so its weights stay in cache for the whole
+     * batch. Same choices, and the same random draws per instance, as selectCardToPlay.
+     */
+    static void selectCardsBatch(const DecisionRequest* requests, int* choices, size_t count) {
+        ScratchScope scratch;
+        const size_t rows = Features::kMaxMoves * Features::kInputs;
+        // Written before being read, like the stack arrays of selectCardToPlay: no zeroing
+        float* inputs = static_cast<float*>(scratch.resource()->allocate(count * rows * sizeof(float), 16));
+        std::pmr::vector<int> cards(count * Features::kMaxMoves, scratch.resource());
+        std::pmr::vector<unsigned> moves(count, scratch.resource());
+        for (size_t i = 0; i < count; ++i) {
+            auto* s = static_cast<LearnedStrategy*>(requests[i].strategy);
+            moves[i] = s->prepare(*requests[i].hand, *requests[i].table, inputs + i * rows,
+                                  &cards[i * Features::kMaxMoves], choices[i]);
+        }
+        float scores[Features::kMaxMoves];
+        for (size_t i = 0; i < count; ++i) {
+            if (moves[i] < 2) continue;
+            auto* s = static_cast<LearnedStrategy*>(requests[i].strategy);
+            s->model->score(inputs + i * rows, moves[i], scores);
+            choices[i] = s->pick(*requests[i].hand, &cards[i * Features::kMaxMoves], scores, moves[i]);
+        }
+    }
+
+    void observeMove(uint64_t playerID, const Card& playedCard) override {
+        game.moved(playerID, playedCard);
+    }
+
+    void observePass(uint64_t playerID) override {
+        game.passed(playerID);
+    }
+
+    std::string getName() const override {
+        return "LearnedStrategy";
+    }
+
+    // Reproducible runs (see seedStrategy below)
+    void seed(uint64_t s) {
+        rng.seed(static_cast<std::mt19937::result_type>(s));
+    }
+
+private:
+    std::mt19937 rng;
+    std::shared_ptr<const PolicyModel> model;
+    ObservedGame game;
+
+    // Candidate moves of a decision into inputs / cards; with fewer than 2, choice is the answer
+    unsigned prepare(const std::vector<Card>& hand, const TableLayout& tableLayout, float* inputs, int* cards,
+                     int& choice) {
+        // Variants (more than one deck, more than 8 seats) are outside the feature vector:
+        // first playable card
+        bool variant = !game.followed();
+        for (const Card& c : hand) variant |= c.suit < 0 || c.suit > 3;
+        if (variant) {
+            choice = -1;
+            for (size_t i = 0; i < hand.size() && choice < 0; ++i) {
+                if (isPlayable(hand[i], tableLayout)) choice = static_cast<int>(i);
+            }
+            return 0;
+        }
+
+        const FeatureInput in = game.decision(hand, tableLayout);
+        const unsigned n = Features::decision(in, inputs, cards);
+        choice = n == 1 ? indexOf(hand, cards[0]) : -1;
+        return n;
+    }
+
+    // Best score, ties broken at random
+    int pick(const std::vector<Card>& hand, const int* cards, const float* scores, unsigned n) {
+        const float best = *std::max_element(scores, scores + n);
+        int card = cards[0];
+        unsigned ties = 0;
+        for (unsigned k = 0; k < n; ++k) {
+            if (scores[k] == best && rng() % ++ties == 0) card = cards[k];
+        }
+        return indexOf(hand, card);
+    }
+
+    static int indexOf(const std::vector<Card>& hand, int card) {
+        for (size_t i = 0; i < hand.size(); ++i) {
+            if (hand[i].suit * 13 + hand[i].rank - 1 == card) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    static std::shared_ptr<const PolicyModel> loadModel() {
+        const char* path = std::getenv("SEVENS_POLICY_MODEL");
+        auto model = PolicyModel::shared(path && *path ? path : "policy.svm");
+        return model ? model : defaultModel();
+    }
+
+    // Hand-set linear policy on the move features: open our own play, keep the others waiting
+    static std::shared_ptr<const PolicyModel> defaultModel() {
+        std::vector<float> w(Features::kInputs, 0.0f);
+        float* m = w.data() + Features::kState;
+        m[1] = -0.5f;   // 7
+        m[2] = -0.5f;   // 6 or 8
+        m[3] = 0.5f;    // ace or king
+        m[4] = 0.5f;    // far from the 7
+        m[7] = 0.3f;    // last card of its suit
+        m[8] = 1.0f;    // unlocks our cards
+        m[9] = -0.5f;   // unlocks the others' cards
+        m[10] = 0.5f;   // run
+        m[11] = 0.8f;   // our cards beyond it
+        m[12] = -0.5f;  // frees cards we held back
+        m[13] = 0.5f;   // distance saved
+        m[14] = 0.5f;   // playable cards after it
+        static const auto model = std::make_shared<const PolicyModel>(0, w, std::vector<float>{},
+                                                                      std::vector<float>{}, 0.0f);
+        return model;
+    }
+
+};
+
+} // namespace sevens
+
+// Export function for the loader — DO NOT place in the namespace
+#ifndef SEVENS_STATIC_STRATEGIES // compiled into the binary instead, see BuiltinStrategies.hpp
+extern "C" sevens::PlayerStrategy* createStrategy() {
+    return new sevens::LearnedStrategy();
+}
+
+extern "C" void seedStrategy(sevens::PlayerStrategy* strategy, uint64_t seed) {
+    static_cast<sevens::LearnedStrategy*>(strategy)->seed(seed);
+}
+
+extern "C" void selectCardsBatch(const sevens::DecisionRequest* requests, int* choices, size_t count) {
+    sevens::LearnedStrategy::selectCardsBatch(requests, choices, count);
+}
+#endif
@@ -0,0 +1,518 @@
+#include "MatchRunner.hpp"
+#include "Checkpoint.hpp"
+#include "GameArena.hpp"
+#include "AllocTracker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+namespace sevens {
+
+double StrategySummary::winRate() const {
+    if (samples == 0 || rankCounts.empty()) return 0.0;
+    return static_cast<double>(rankCounts[0]) / samples;
+}
+
+double StrategySummary::winRateCI95() const {
+    if (samples == 0) return 0.0;
+    const double z = 1.96;
+    const double n = static_cast<double>(samples);
+    const double p = winRate();
+    return z * std::sqrt(p * (1 - p) / n + z * z / (4 * n * n)) / (1 + z * z / n);
+}
+
+MatchRunner::MatchRunner(MatchRunnerConfig config) : cfg(std::move(config)) {
+    if (cfg.specs.size() < 2) {
+        throw std::invalid_argument("MatchRunner: at least two strategies are needed");
+    }
+
+    // Identical specs share one factory and one line of the report
+    specGroup = MatchAggregator::groupSpecs(cfg.specs);
+    for (uint64_t i = 0; i < cfg.specs.size(); ++i) {
+        if (specGroup[i] == factories.size()) factories.emplace_back(cfg.specs[i], cfg.hotReload);
+    }
+    if (!cfg.book.empty()) {
+        for (const StrategyFactory& f : factories) f.useOpeningBook(cfg.book);
+    }
+    agg.reset(new MatchAggregator(cfg.specs, strategyNames()));
+
+    proto.prepare_rounds();
+    if (cfg.ponder && cfg.interleave) {
+        throw std::invalid_argument("MatchRunner: --ponder needs one match at a time per thread (no --interleave)");
+    }
+    proto.set_pondering(cfg.ponder);
+
+    if (!cfg.deals.empty()) {
+        corpus = std::make_shared<const DealCorpus>(cfg.deals);
+        if (corpus->players() != cfg.specs.size()) {
+            throw std::invalid_argument("MatchRunner: the deal corpus is for " + std::to_string(corpus->players()) +
+                                        " players, not " + std::to_string(cfg.specs.size()));
+        }
+        cfg.dealsFingerprint = corpus->fingerprint();
+
+        // Before its last round every player is under maxScore, and each round gives at
+        // least nP - 1 points: at most nP * (maxScore - 1) / (nP - 1) + 1 rounds
+        const uint64_t nP = cfg.specs.size();
+        dealsPerMatch = nP * (std::max<uint64_t>(cfg.maxScore, 1) - 1) / (nP - 1) + 1;
+    }
+
+    threads = WorkScheduler::threadCount(cfg.threads, cfg.matches);
+}
+
+uint64_t MatchRunner::deriveSeed(uint64_t master, uint64_t matchId, uint64_t stream) {
+    auto mix = [](uint64_t z) {
+        z += 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    };
+    return mix(mix(mix(master) ^ matchId) ^ stream);
+}
+
+/**
+ * Follows the rounds of a match: GameRow's for the results file (rank inside the game,
+ * ties share a rank), kept in the outcome until the match completes, and live counters
+ * for the metrics exporter.
+ */
+class MatchRecorder : public RoundObserver {
+public:
+    MatchRecorder(const MyGameMapper& game, MatchOutcome& outcome, const std::vector<uint64_t>& specGroup,
+                  bool rows, RunMetrics* metrics, unsigned worker)
+        : game(game), outcome(outcome), specGroup(specGroup), rows(rows), metrics(metrics), worker(worker) {}
+
+    void onRound(uint64_t round, const std::vector<uint64_t>& cardsLeft,
+                 const std::vector<uint64_t>& moves, const std::vector<uint64_t>& passes) override {
+        const uint64_t nP = outcome.seatSpec.size();
+        if (rows) {
+            for (uint64_t seat = 0; seat < nP; ++seat) {
+                uint64_t rank = 1;
+                for (uint64_t other = 0; other < nP; ++other) rank += cardsLeft[other] < cardsLeft[seat];
+
+                outcome.rows.push_back(GameRow{outcome.matchId, round, outcome.seed, seat,
+                                  specGroup[outcome.seatSpec[seat]], cardsLeft[seat], rank,
+                                  moves[seat], passes[seat], outcome.seatBuild[seat]});
+            }
+        }
+        if (metrics) {
+            const auto relaxed = std::memory_order_relaxed;
+            const std::vector<uint64_t>& ns = game.round_decision_ns();
+            const std::vector<uint64_t>& timeouts = game.round_timeouts();
+            const std::vector<uint64_t>& ponder = game.round_ponder_ns();
+            uint64_t played = 0, passed = 0;
+            for (uint64_t seat = 0; seat < nP; ++seat) {
+                RunMetrics::Strategy& s = metrics->strategy(specGroup[outcome.seatSpec[seat]]);
+                s.decisions.fetch_add(moves[seat] + passes[seat], relaxed);
+                s.decisionNs.fetch_add(ns[seat], relaxed);
+                if (timeouts[seat]) s.timeouts.fetch_add(timeouts[seat], relaxed);
+                if (ponder[seat]) s.ponderNs.fetch_add(ponder[seat], relaxed);
+                played += moves[seat];
+                passed += passes[seat];
+            }
+            RunMetrics::Worker& w = metrics->worker(worker);
+            w.games.fetch_add(1, relaxed);
+            w.moves.fetch_add(played, relaxed);
+            w.passes.fetch_add(passed, relaxed);
+            w.lastProgressNs.store(RunMetrics::nowNs(), relaxed);
+        }
+    }
+
+private:
+    const MyGameMapper& game;
+    MatchOutcome& outcome;
+    const std::vector<uint64_t>& specGroup;
+    bool rows;
+    RunMetrics* metrics;
+    unsigned worker;
+};
+
+std::vector<std::string> MatchRunner::strategyNames() const {
+    std::vector<std::string> names;
+    for (const StrategyFactory& f : factories) names.push_back(f.name());
+    return names;
+}
+
+MatchOutcome MatchRunner::seatMatch(MyGameMapper& game, uint64_t matchId,
+                                    std::vector<std::shared_ptr<const StrategyFactory::Build>>* builds) const {
+    const uint64_t nP = cfg.specs.size();
+
+    MatchOutcome outcome;
+    outcome.matchId = matchId;
+    outcome.seed = deriveSeed(cfg.seed, matchId, 0);
+    outcome.seatSpec.resize(nP);
+    outcome.seatBuild.resize(nP);
+
+    // One build per strategy for the whole match, even if a reload comes while seating
+    std::vector<std::shared_ptr<const StrategyFactory::Build>> current(factories.size());
+    if (builds) builds->resize(nP);
+
+    game.seed(outcome.seed);
+    if (corpus) game.use_deals(corpus.get(), matchId * dealsPerMatch % corpus->size());
+    for (uint64_t seat = 0; seat < nP; ++seat) {
+        uint64_t spec = cfg.rotateSeats ? (seat + matchId) % nP : seat;
+        outcome.seatSpec[seat] = spec;
+
+        std::shared_ptr<const StrategyFactory::Build>& build = current[specGroup[spec]];
+        if (!build) build = factories[specGroup[spec]].current();
+        outcome.seatBuild[seat] = build->number();
+        if (builds) (*builds)[seat] = build;
+
+        auto strat = build->create(deriveSeed(cfg.seed, matchId, 1 + seat));
+        strat->initialize(seat);
+        game.registerStrategy(seat, strat);
+    }
+    return outcome;
+}
+
+MatchOutcome MatchRunner::playMatch(MyGameMapper& game, uint64_t matchId, unsigned worker) const {
+    const uint64_t nP = cfg.specs.size();
+    MatchOutcome outcome = seatMatch(game, matchId);
+
+    if (cfg.results || cfg.metrics) {
+        MatchRecorder recorder(game, outcome, specGroup, cfg.results != nullptr, cfg.metrics, worker);
+        outcome.result = game.play_match(nP, cfg.maxScore, &recorder);
+        if (cfg.metrics) cfg.metrics->worker(worker).matches.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        outcome.result = game.play_match(nP, cfg.maxScore);
+    }
+    return outcome;
+}
+
+// -----------------------------------------------------------------------------
+// MatchAggregator
+// -----------------------------------------------------------------------------
+
+MatchAggregator::MatchAggregator(std::vector<std::string> specs_, std::vector<std::string> names_)
+    : specs(std::move(specs_)), names(std::move(names_)), specGroup(groupSpecs(specs)) {}
+
+std::vector<uint64_t> MatchAggregator::groupSpecs(const std::vector<std::string>& specs) {
+    std::vector<uint64_t> groups;
+    uint64_t distinct = 0;
+    for (size_t i = 0; i < specs.size(); ++i) {
+        size_t first = 0;
+        while (specs[first] != specs[i]) ++first;
+        groups.push_back(first == i ? distinct++ : groups[first]);
+    }
+    return groups;
+}
+
+RunState MatchAggregator::initialState() const {
+    RunState state;
+    for (size_t i = 0; i < specs.size(); ++i) {
+        if (specGroup[i] < state.strategies.size()) continue;   // same spec as an earlier seat
+        StrategySummary s;
+        s.spec = specs[i];
+        s.name = specGroup[i] < names.size() ? names[specGroup[i]] : specs[i];
+        s.rankCounts.assign(specs.size(), 0);
+        state.strategies.push_back(s);
+    }
+    for (uint64_t g : specGroup) state.strategies[g].seatsPerMatch++;
+    return state;
+}
+
+bool MatchAggregator::complete(RunState& state, MatchOutcome&& outcome) const {
+    if (outcome.matchId < state.nextMatch || state.pending.count(outcome.matchId)) return false;
+
+    state.pending.emplace(outcome.matchId, std::move(outcome));
+    while (!state.pending.empty() && state.pending.begin()->first == state.nextMatch) {
+        fold(state, state.pending.begin()->second);
+        state.pending.erase(state.pending.begin());
+        state.nextMatch++;
+    }
+    return true;
+}
+
+void MatchAggregator::fold(RunState& state, const MatchOutcome& outcome) const {
+    const MatchResult& r = outcome.result;
+    const uint64_t nP = outcome.seatSpec.size();
+    std::vector<StrategySummary>& summaries = state.strategies;
+
+    state.rounds += r.rounds;
+    for (uint64_t seat = 0; seat < nP; ++seat) {
+        StrategySummary& s = summaries[specGroup[outcome.seatSpec[seat]]];
+        s.samples++;
+        s.rankCounts[r.ranks[seat] - 1]++;
+        s.points += r.totals[seat];
+        s.roundWins += r.wins[seat];
+        s.roundTies += r.ties[seat];
+    }
+
+    // Elo: every pair of seats held by different strategies is one game, K = 16 split over the opponents
+    const double k = 16.0 / (nP - 1);
+    std::vector<double> delta(summaries.size(), 0.0);
+    for (uint64_t i = 0; i < nP; ++i) {
+        for (uint64_t j = i + 1; j < nP; ++j) {
+            uint64_t a = specGroup[outcome.seatSpec[i]], b = specGroup[outcome.seatSpec[j]];
+            if (a == b) continue;
+            double score = r.ranks[i] < r.ranks[j] ? 1.0 : (r.ranks[i] == r.ranks[j] ? 0.5 : 0.0);
+            double expected = 1.0 / (1.0 + std::pow(10.0, (summaries[b].rating - summaries[a].rating) / 400.0));
+            delta[a] += k * (score - expected);
+            delta[b] -= k * (score - expected);
+        }
+    }
+    for (size_t g = 0; g < summaries.size(); ++g) summaries[g].rating += delta[g];
+}
+
+// -----------------------------------------------------------------------------
+// MatchRunner
+// -----------------------------------------------------------------------------
+
+void MatchRunner::forEachMatch(uint64_t first, uint64_t last, const std::vector<uint64_t>& skip,
+                               const std::function<void(MatchOutcome&&)>& done) const {
+    // Match costs vary with the line-up: the scheduler steals work until the last match
+    WorkScheduler scheduler(first, last, threads);
+    scheduler.run([&](WorkScheduler::Tasks& tasks) {
+        if (cfg.interleave) {
+            playInterleaved(tasks, skip, done);
+            return;
+        }
+        MyGameMapper game = proto;
+        if (cfg.metrics) game.set_decision_budget(cfg.metrics->decisionBudgetNs());
+
+        for (uint64_t m; tasks.next(m);) {
+            if (std::binary_search(skip.begin(), skip.end(), m)) continue;
+            done(playMatch(game, m, tasks.worker()));
+        }
+    });
+}
+
+namespace {
+
+// A match kept in flight by playInterleaved: its own engine copy and round storage
+struct InFlight {
+    MyGameMapper game;
+    GameArena arena;
+    MatchOutcome outcome;
+    std::unique_ptr<MatchRecorder> recorder;
+    bool active = false;
+    std::vector<std::shared_ptr<const StrategyFactory::Build>> builds;   // by seat
+
+    SelectCardsBatchFn batchToPlay() const { return builds[game.to_play()]->batch(); }
+};
+
+/**
+ * Decisions of several matches waiting on a strategy that exports selectCardsBatch.
+ * With a decision budget, every decision is charged the mean time of the batch.
+ */
+void decideBatch(SelectCardsBatchFn fn, const std::vector<InFlight*>& batch, std::vector<int>& choices,
+                 std::vector<DecisionRequest>& requests, std::vector<int>& legal) {
+    legal.clear();
+    requests.clear();
+    for (InFlight* f : batch) {
+        const std::vector<Card>& hand = f->game.hand_to_play();
+        const TableLayout& table = f->game.round_table();
+        const size_t first = legal.size();
+        for (size_t i = 0; i < hand.size(); ++i) {
+            if (f->arena.playable(hand[i])) legal.push_back(static_cast<int>(i));
+        }
+        const std::vector<MoveEvent>& history = f->game.round_history();
+        requests.push_back(DecisionRequest{&f->game.strategy_to_play(), f->game.to_play(), &hand, &table,
+                                           nullptr, legal.size() - first, history.data(), history.size()});
+    }
+    const int* next = legal.data();   // legal is complete: its addresses are stable now
+    for (DecisionRequest& r : requests) {
+        r.legal = next;
+        next += r.legalCount;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        // Same strategy for the whole batch: its allocations, as in MyGameMapper::decide
+        AllocScope scope(batch.front()->game.alloc_id_to_play(), StrategyCallback::SelectCardToPlay);
+        fn(requests.data(), choices.data(), requests.size());
+    }
+    const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - t0).count();
+    for (InFlight* f : batch) f->game.record_decision_ns(ns / batch.size());
+}
+
+} // namespace
+
+/**
+ * Hand-written coroutines: every match in flight stops at its next decision. One pass
+ * gathers the waiting decisions per strategy, answers each group in one batch, then plays
+ * the answers; a slot whose match is over takes the next match of the worker.
+ * A strategy exporting selectCardsBatch gets the group in one call; the others answer
+ * through MyGameMapper::decide, one selectCardToPlay per match (timed and tracked as in
+ * play_match).
+ */
+void MatchRunner::playInterleaved(WorkScheduler::Tasks& tasks, const std::vector<uint64_t>& skip,
+                                  const std::function<void(MatchOutcome&&)>& done) const {
+    const uint64_t nP = cfg.specs.size();
+
+    std::vector<std::unique_ptr<InFlight>> slots(cfg.interleave);
+    std::vector<std::vector<InFlight*>> waiting(factories.size());
+    std::vector<InFlight*> batch;
+    std::vector<int> choices;
+    std::vector<DecisionRequest> requests;
+    std::vector<int> legal;
+    bool more = true;
+
+    for (;;) {
+        // Free slots take the next matches
+        size_t live = 0;
+        for (auto& slot : slots) {
+            while (more && !(slot && slot->active)) {
+                uint64_t m;
+                if (!tasks.next(m)) {
+                    more = false;
+                    break;
+                }
+                if (std::binary_search(skip.begin(), skip.end(), m)) continue;
+                if (!slot) {
+                    slot.reset(new InFlight{proto, GameArena(), MatchOutcome(), nullptr, false, {}});
+                    slot->game.use_arena(&slot->arena);
+                    if (cfg.metrics) slot->game.set_decision_budget(cfg.metrics->decisionBudgetNs());
+                }
+                slot->outcome = seatMatch(slot->game, m, &slot->builds);
+                RoundObserver* observer = nullptr;
+                if (cfg.results || cfg.metrics) {
+                    slot->recorder.reset(new MatchRecorder(slot->game, slot->outcome, specGroup, cfg.results != nullptr,
+                                                           cfg.metrics, tasks.worker()));
+                    observer = slot->recorder.get();
+                }
+                slot->game.start_match(nP, cfg.maxScore, observer);
+                slot->active = true;
+            }
+            if (slot && slot->active) {
+                waiting[specGroup[slot->outcome.seatSpec[slot->game.to_play()]]].push_back(slot.get());
+                ++live;
+            }
+        }
+        if (live == 0) break;
+
+        // One batch per strategy, then every match moves on by one turn. After a hot reload,
+        // matches of the previous build are still in flight: one batch per build.
+        for (size_t g = 0; g < waiting.size(); ++g) {
+            std::vector<InFlight*>& pending = waiting[g];
+            while (!pending.empty()) {
+                const SelectCardsBatchFn fn = pending.front()->batchToPlay();
+                batch.clear();
+                size_t kept = 0;
+                for (InFlight* f : pending) {
+                    if (f->batchToPlay() == fn) batch.push_back(f);
+                    else pending[kept++] = f;
+                }
+                pending.resize(kept);
+
+                choices.resize(batch.size());
+                if (batch.size() > 1 && fn) {
+                    decideBatch(fn, batch, choices, requests, legal);
+                } else {
+                    for (size_t i = 0; i < batch.size(); ++i) choices[i] = batch[i]->game.decide();
+                }
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    InFlight& f = *batch[i];
+                    f.game.play_turn(choices[i]);
+                    if (!f.game.match_over()) continue;
+                    f.outcome.result = f.game.match_result();
+                    f.active = false;
+                    if (cfg.metrics) cfg.metrics->worker(tasks.worker()).matches.fetch_add(1, std::memory_order_relaxed);
+                    done(std::move(f.outcome));
+                }
+            }
+        }
+    }
+}
+
+MatchReport MatchRunner::run() {
+    RunState state = cfg.resume ? Checkpoint::load(cfg.checkpoint, cfg, agg->initialState()) : agg->initialState();
+
+    // Matches finished before the checkpoint are not played again
+    std::vector<uint64_t> done;
+    for (const auto& [id, outcome] : state.pending) done.push_back(id);
+
+    // Rows reach the writer when their match completes, under the merge lock: a checkpoint
+    // then records a results file holding exactly the rows of its completed matches
+    std::unique_ptr<ResultsWriter::Buffer> rows;
+    if (cfg.results) rows.reset(new ResultsWriter::Buffer(*cfg.results));
+    auto save = [&](RunState& snapshot) {
+        snapshot.resultsBytes = 0;
+        if (rows) {
+            rows->flush();
+            snapshot.resultsBytes = cfg.results->sync();
+        }
+        Checkpoint::save(cfg.checkpoint, cfg, snapshot);
+    };
+
+    std::mutex merge;
+    auto t0 = std::chrono::steady_clock::now();
+    auto lastCheckpoint = t0;
+    auto elapsed = [&] {
+        return state.seconds + std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    // Outcomes are folded in match order whatever thread played them: same report, same
+    // ratings and same checkpoints for any number of threads (and across a resume)
+    forEachMatch(state.nextMatch, cfg.matches, done, [&](MatchOutcome&& outcome) {
+        std::lock_guard<std::mutex> lock(merge);
+        if (rows) {
+            for (const GameRow& row : outcome.rows) rows->add(row);
+        }
+        outcome.rows = std::vector<GameRow>();
+        agg->complete(state, std::move(outcome));
+
+        if (!cfg.checkpoint.empty() &&
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - lastCheckpoint).count() >= cfg.checkpointSeconds) {
+            RunState snapshot = state;
+            snapshot.seconds = elapsed();
+            save(snapshot);
+            lastCheckpoint = std::chrono::steady_clock::now();
+        }
+    });
+
+    state.seconds = elapsed();
+    if (!cfg.checkpoint.empty()) save(state);
+    return makeReport(state, threads);
+}
+
+MatchReport MatchRunner::makeReport(const RunState& state, unsigned threads) {
+    MatchReport report;
+    report.matches = state.nextMatch;
+    report.rounds = state.rounds;
+    report.threads = threads;
+    report.seconds = state.seconds;
+    report.strategies = state.strategies;
+    return report;
+}
+
+void MatchRunner::print(const MatchReport& report, std::ostream& out) {
+    const size_t ranks = report.strategies.empty() ? 0 : report.strategies[0].rankCounts.size();
+
+    out << "\n=== " << report.matches << " MATCHES, " << report.rounds << " ROUNDS ("
+        << report.threads << " threads, " << std::fixed << std::setprecision(2) << report.seconds << " s, "
+        << std::setprecision(0) << report.matches / std::max(report.seconds, 1e-9) << " matches/s) ===\n";
+
+    out << std::left << std::setw(28) << "Strategy" << std::right << std::setw(6) << "seats"
+        << std::setw(17) << "match win %";
+    for (size_t r = 1; r <= ranks; ++r) out << std::setw(8) << ("rank" + std::to_string(r));
+    out << std::setw(11) << "pts/match" << std::setw(12) << "round wins" << std::setw(8) << "ties"
+        << std::setw(8) << "Elo" << '\n';
+
+    for (const StrategySummary& s : report.strategies) {
+        double n = static_cast<double>(std::max<uint64_t>(s.samples, 1));
+        std::ostringstream win;
+        win << std::fixed << std::setprecision(2) << 100.0 * s.winRate()
+            << " ±" << std::setprecision(2) << 100.0 * s.winRateCI95();
+
+        out << std::left << std::setw(28) << s.name << std::right << std::setw(6) << s.seatsPerMatch
+            << std::setw(17) << win.str();
+        for (uint64_t c : s.rankCounts) {
+            out << std::setw(7) << std::fixed << std::setprecision(1) << 100.0 * c / n << '%';
+        }
+        out << std::setw(11) << std::setprecision(2) << s.points / n
+            << std::setw(12) << std::setprecision(2) << s.roundWins / n
+            << std::setw(8) << std::setprecision(2) << s.roundTies / n
+            << std::setw(8) << std::setprecision(0) << s.rating << '\n';
+    }
+    out << "(rank distribution in % of the seat-matches; per-match averages; ± = 95% Wilson interval)\n";
+    out.unsetf(std::ios::floatfield);
+}
+
+} // namespace sevens
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "MyGameMapper.hpp"
+#include "StrategyLoader.hpp"
+#include "ResultsWriter.hpp"
+#include "Metrics.hpp"
+#include "DealCorpus.hpp"
+#include "WorkScheduler.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Settings of a batch of matches (see MatchRunner).
+ */
+struct MatchRunnerConfig {
+    std::vector<std::string> specs;   // one strategy per seat (.so path or builtin:<Name>)
+    uint64_t matches = 1000;
+    uint64_t maxScore = 50;           // a match ends when a player reaches it
+    unsigned threads = 0;             // 0 = std::thread::hardware_concurrency()
+    uint64_t seed = 0;                // master seed, every match seed is derived from it
+    bool rotateSeats = true;          // match m shifts the line-up by m seats
+    std::string deals;                // optional deal corpus, every match plays a range of its own (MatchRunner)
+    uint64_t dealsFingerprint = 0;    // DealCorpus::fingerprint of deals, set by MatchRunner (checkpoint identity)
+    std::string book;                 // optional opening book, see OpeningBook.hpp
+    ResultsWriter* results = nullptr; // optional per-game rows (strategy = index in strategyNames())
+    RunMetrics* metrics = nullptr;    // optional live counters (one worker slot per thread)
+    std::string checkpoint;           // optional checkpoint file, see Checkpoint.hpp
+    double checkpointSeconds = 60.0;
+    bool resume = false;              // start from the checkpoint file
+    unsigned interleave = 0;          // matches in flight per thread, decisions batched (0 = one at a time)
+    bool ponder = false;              // pondering seats think while the others decide (not with interleave)
+    bool hotReload = false;           // .so strategies rebuilt during the run are reloaded between matches
+};
+
+/**
+ * Everything known about one finished match.
+ */
+struct MatchOutcome {
+    uint64_t matchId = 0;
+    uint64_t seed = 0;                // engine seed of the match
+    std::vector<uint64_t> seatSpec;   // seat → index in MatchRunnerConfig::specs
+    std::vector<uint64_t> seatBuild;  // seat → build of its strategy (results rows only, not checkpointed)
+    MatchResult result;
+    std::vector<GameRow> rows;        // results rows of the match, handed to the writer when it completes
+};
+
+/**
+ * Aggregated results of one strategy over all its seats in all matches.
+ */
+struct StrategySummary {
+    std::string spec;
+    std::string name;
+    uint64_t seatsPerMatch = 0;       // same spec on several seats counts several times
+    uint64_t samples = 0;             // seat-matches played
+    std::vector<uint64_t> rankCounts; // rankCounts[r - 1] = matches finished at rank r
+    uint64_t points = 0;
+    uint64_t roundWins = 0;
+    uint64_t roundTies = 0;
+    double rating = 1500.0;           // Elo over the matches, in match order
+
+    double winRate() const;           // share of matches finished 1st (ties included)
+    double winRateCI95() const;       // half-width of the Wilson score interval
+};
+
+/**
+ * Aggregation state of a batch. Matches are folded in match-id order (the ratings depend on
+ * the order); outcomes finished ahead of their turn wait in pending. Seeds are derived from
+ * the match id, so nextMatch and pending are also the position of every random stream.
+ * This is what a checkpoint holds.
+ */
+struct RunState {
+    uint64_t nextMatch = 0;                     // every match < nextMatch is folded in
+    uint64_t rounds = 0;
+    double seconds = 0.0;                       // spent by the previous sessions (resume)
+    uint64_t resultsBytes = 0;                  // results file size: the rows of the completed matches
+    std::vector<StrategySummary> strategies;
+    std::map<uint64_t, MatchOutcome> pending;   // finished, not folded in yet
+};
+
+struct MatchReport {
+    uint64_t matches = 0;
+    uint64_t rounds = 0;
+    unsigned threads = 0;
+    double seconds = 0.0;
+    std::vector<StrategySummary> strategies;   // one entry per distinct spec, in seat order
+};
+
+/**
+ * Folds match outcomes into a RunState, in match order. It only needs the specs and the
+ * strategy names, so the distributed coordinator uses it without loading any strategy.
+ */
+class MatchAggregator {
+public:
+    // names: one per distinct spec, in seat order (MatchRunner::strategyNames)
+    MatchAggregator(std::vector<std::string> specs, std::vector<std::string> names);
+
+    RunState initialState() const;
+
+    // Adds a finished match and folds every match that is now in order.
+    // Returns false (and ignores it) when the match was already known.
+    bool complete(RunState& state, MatchOutcome&& outcome) const;
+
+    // config spec index → index of the distinct spec (identical specs share one)
+    static std::vector<uint64_t> groupSpecs(const std::vector<std::string>& specs);
+
+private:
+    std::vector<std::string> specs;
+    std::vector<std::string> names;
+    std::vector<uint64_t> specGroup;
+
+    void fold(RunState& state, const MatchOutcome& outcome) const;
+};
+
+/**
+ * Plays many complete matches (rounds until maxScore, like the tournament mode) in parallel
+ * and quietly. Every match gets its own engine seed and fresh, seeded strategy instances,
+ * all derived from (master seed, match id, seat), so a batch gives the same report whatever
+ * the number of threads.
+ *
+ * With a deal corpus, match m plays the deals [m * D, (m + 1) * D) in order, modulo the
+ * corpus size, where D bounds the rounds of a match: every round gives a point or more to
+ * all players but the winner. A corpus of matches * D deals or more gives every match deals
+ * of its own.
+ *
+ * With `interleave` = K > 0, each thread keeps K matches in flight instead of playing them
+ * one after the other. Every match is suspended at its next decision (MyGameMapper's
+ * start_match / play_turn); the thread gathers the waiting decisions, dispatches them to
+ * each strategy in one batch, plays the answers and refills the finished slots. A match
+ * only depends on its own seeds, so the report is the same as with K = 0.
+ *
+ * With `ponder`, seats played by a PonderingStrategy search on a thread of their own while
+ * the others decide (MyGameMapper::set_pondering). How far a search gets depends on the
+ * scheduling, so the report is no longer reproducible from the seed alone.
+ *
+ * With `hotReload`, a .so rebuilt during the run is loaded next to the previous build
+ * (a watched StrategyFactory) and the matches started from then on seat the new one, every
+ * seat of a match playing the same build of its strategy. The matches in progress finish on
+ * the build they started with; the build column of the results tells them apart.
+ */
+class MatchRunner {
+public:
+    explicit MatchRunner(MatchRunnerConfig config);
+
+    MatchReport run();
+
+    // Plays one match on a worker's copy of the engine (used by run() and by the distributed runners);
+    // with a results writer, its rows are in MatchOutcome::rows
+    MatchOutcome playMatch(MyGameMapper& game, uint64_t matchId, unsigned worker = 0) const;
+
+    // Plays matches [first, last) except skip (sorted) on threadCount() threads;
+    // done is called from the worker threads, in any order
+    void forEachMatch(uint64_t first, uint64_t last, const std::vector<uint64_t>& skip,
+                      const std::function<void(MatchOutcome&&)>& done) const;
+
+    // Worker threads used by run()
+    unsigned threadCount() const { return threads; }
+
+    const MatchAggregator& aggregator() const { return *agg; }
+
+    // One name per distinct spec, in seat order (dictionary of the results files)
+    std::vector<std::string> strategyNames() const;
+
+    // Prepared engine (deck and opening table read once), to be copied by each worker
+    const MyGameMapper& prototype() const { return proto; }
+
+    const MatchRunnerConfig& config() const { return cfg; }
+
+    // Results file opened once strategyNames() is known
+    void setResults(ResultsWriter* writer) { cfg.results = writer; }
+    void setMetrics(RunMetrics* metrics) { cfg.metrics = metrics; }
+
+    // splitmix64 of (master, match, stream): stream 0 is the engine, 1 + seat the strategies
+    static uint64_t deriveSeed(uint64_t master, uint64_t matchId, uint64_t stream);
+
+    static MatchReport makeReport(const RunState& state, unsigned threads);
+    static void print(const MatchReport& report, std::ostream& out);
+
+private:
+    MatchRunnerConfig cfg;
+    std::vector<StrategyFactory> factories;   // one per distinct spec
+    std::vector<uint64_t> specGroup;          // config spec index → factory / summary index
+    std::unique_ptr<MatchAggregator> agg;
+    MyGameMapper proto;
+    std::shared_ptr<const DealCorpus> corpus;   // mapped once, shared by the workers
+    uint64_t dealsPerMatch = 0;                 // length of the corpus range of a match
+    unsigned threads;
+
+    // Engine seed, seats and fresh strategy instances of match matchId; builds (optional)
+    // receives the build of every seat
+    MatchOutcome seatMatch(MyGameMapper& game, uint64_t matchId,
+                           std::vector<std::shared_ptr<const StrategyFactory::Build>>* builds = nullptr) const;
+
+    // forEachMatch worker with cfg.interleave matches in flight
+    void playInterleaved(WorkScheduler::Tasks& tasks, const std::vector<uint64_t>& skip,
+                         const std::function<void(MatchOutcome&&)>& done) const;
+};
+
+} // namespace sevens
@@ -0,0 +1,194 @@
+#include "Metrics.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace sevens {
+
+namespace {
+
+// Label value of the text exposition format: backslash, double quote and newline escaped
+std::string labelValue(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\') escaped += "\\\\";
+        else if (c == '"') escaped += "\\\"";
+        else if (c == '\n') escaped += "\\n";
+        else escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+RunMetrics::RunMetrics(unsigned workerCount_, std::vector<std::string> strategyNames, uint64_t plannedMatches,
+                       uint64_t decisionBudgetNs)
+    : workers(new Worker[workerCount_]), strategies(new Strategy[strategyNames.size()]),
+      workerCount(workerCount_), names(std::move(strategyNames)), planned(plannedMatches),
+      budgetNs(decisionBudgetNs), startNs(nowNs()) {
+    for (unsigned w = 0; w < workerCount; ++w) workers[w].lastProgressNs.store(startNs);
+}
+
+void RunMetrics::writePrometheus(std::ostream& out, std::vector<uint64_t>& previous, double interval) const {
+    const uint64_t now = nowNs();
+    previous.resize(workerCount, 0);
+
+    auto family = [&](const char* name, const char* type, const char* help) {
+        out << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+    };
+    auto perWorker = [&](const char* name, const char* type, const char* help,
+                         std::atomic<uint64_t> Worker::*field) {
+        family(name, type, help);
+        for (unsigned w = 0; w < workerCount; ++w) {
+            out << name << "{worker=\"" << w << "\"} " << (workers[w].*field).load(std::memory_order_relaxed) << '\n';
+        }
+    };
+    auto perStrategy = [&](const char* name, const char* type, const char* help,
+                           std::atomic<uint64_t> Strategy::*field, double scale) {
+        family(name, type, help);
+        for (size_t s = 0; s < names.size(); ++s) {
+            out << name << "{strategy=\"" << labelValue(names[s]) << "\"} "
+                << (strategies[s].*field).load(std::memory_order_relaxed) * scale << '\n';
+        }
+    };
+
+    family("sevens_uptime_seconds", "gauge", "Time since the start of the run.");
+    out << "sevens_uptime_seconds " << (now - startNs) * 1e-9 << '\n';
+    family("sevens_matches_planned", "gauge", "Matches requested for this run.");
+    out << "sevens_matches_planned " << planned << '\n';
+
+    perWorker("sevens_games_total", "counter", "Games (rounds) completed.", &Worker::games);
+    perWorker("sevens_matches_total", "counter", "Matches completed.", &Worker::matches);
+    perWorker("sevens_moves_total", "counter", "Cards played.", &Worker::moves);
+    perWorker("sevens_passes_total", "counter", "Passes.", &Worker::passes);
+
+    family("sevens_worker_games_per_second", "gauge", "Games per second over the last interval.");
+    for (unsigned w = 0; w < workerCount; ++w) {
+        uint64_t games = workers[w].games.load(std::memory_order_relaxed);
+        out << "sevens_worker_games_per_second{worker=\"" << w << "\"} "
+            << (interval > 0 ? (games - previous[w]) / interval : 0.0) << '\n';
+        previous[w] = games;
+    }
+    family("sevens_worker_idle_seconds", "gauge", "Time since the worker last completed a game (stall detection).");
+    for (unsigned w = 0; w < workerCount; ++w) {
+        uint64_t last = workers[w].lastProgressNs.load(std::memory_order_relaxed);
+        out << "sevens_worker_idle_seconds{worker=\"" << w << "\"} " << (now > last ? (now - last) * 1e-9 : 0.0) << '\n';
+    }
+
+    perStrategy("sevens_strategy_decisions_total", "counter", "selectCardToPlay calls.", &Strategy::decisions, 1.0);
+    perStrategy("sevens_strategy_decision_seconds_total", "counter", "Time spent in selectCardToPlay.",
+                &Strategy::decisionNs, 1e-9);
+    perStrategy("sevens_strategy_timeouts_total", "counter", "Decisions longer than the decision budget.",
+                &Strategy::timeouts, 1.0);
+    perStrategy("sevens_strategy_ponder_seconds_total", "counter", "CPU time spent pondering (batch --ponder).",
+                &Strategy::ponderNs, 1e-9);
+    family("sevens_decision_budget_seconds", "gauge", "Decision budget used for the timeouts.");
+    out << "sevens_decision_budget_seconds " << budgetNs * 1e-9 << '\n';
+}
+
+// -----------------------------------------------------------------------------
+// MetricsExporter
+// -----------------------------------------------------------------------------
+
+MetricsExporter::MetricsExporter(RunMetrics& m, Config config) : metrics(m), cfg(std::move(config)) {
+    if (cfg.port > 0) {
+        listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(cfg.port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);   // local only
+        if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(listenFd, 8) != 0) {
+            if (listenFd >= 0) ::close(listenFd);
+            throw std::runtime_error("Impossible d'ouvrir le port des métriques " + std::to_string(cfg.port));
+        }
+    }
+    thread = std::thread(&MetricsExporter::run, this);
+}
+
+MetricsExporter::~MetricsExporter() {
+    stopping.store(true);
+    thread.join();
+    if (listenFd >= 0) ::close(listenFd);
+}
+
+void MetricsExporter::run() {
+    // Lowest priority: the exporter must never take CPU time from the simulation threads
+    sched_param param{};
+    if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) != 0) {
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+    }
+
+    std::vector<uint64_t> previous;
+    auto last = std::chrono::steady_clock::now();
+    std::string text;
+
+    for (;;) {
+        bool finalPass = stopping.load();
+        auto now = std::chrono::steady_clock::now();
+        std::ostringstream out;
+        metrics.writePrometheus(out, previous, std::chrono::duration<double>(now - last).count());
+        last = now;
+        text = out.str();
+
+        if (!cfg.file.empty()) writeFile(text);
+        if (finalPass) return;
+
+        // Sleep until the next interval, answering HTTP requests meanwhile
+        auto deadline = now + std::chrono::duration<double>(cfg.intervalSeconds);
+        while (!stopping.load() && std::chrono::steady_clock::now() < deadline) {
+            if (listenFd >= 0) serve(100, text);
+            else std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+}
+
+void MetricsExporter::writeFile(const std::string& text) {
+    const std::string tmp = cfg.file + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::trunc);
+        f << text;
+        if (!f) return;   // keep the previous file, try again next interval
+    }
+    std::rename(tmp.c_str(), cfg.file.c_str());
+}
+
+void MetricsExporter::serve(int timeoutMs, const std::string& text) {
+    pollfd pfd{listenFd, POLLIN, 0};
+    if (::poll(&pfd, 1, timeoutMs) <= 0) return;
+
+    int client = ::accept(listenFd, nullptr, nullptr);
+    if (client < 0) return;
+
+    char request[1024];
+    pollfd cfd{client, POLLIN, 0};
+    if (::poll(&cfd, 1, 200) > 0) (void)::recv(client, request, sizeof(request), 0);   // request itself is ignored
+
+    std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                           std::to_string(text.size()) + "\r\nConnection: close\r\n\r\n" + text;
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t n = ::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) break;
+        sent += static_cast<size_t>(n);
+    }
+    ::close(client);
+}
+
+} // namespace sevens
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Live counters of a batch run, updated by the worker threads without locks
+ * (relaxed atomics, one cache line per worker / strategy) and read at any time
+ * by the MetricsExporter.
+ */
+class RunMetrics {
+public:
+    struct alignas(64) Worker {
+        std::atomic<uint64_t> games{0};          // rounds completed
+        std::atomic<uint64_t> matches{0};
+        std::atomic<uint64_t> moves{0};
+        std::atomic<uint64_t> passes{0};
+        std::atomic<uint64_t> lastProgressNs{0}; // steady clock of the last completed game
+    };
+
+    struct alignas(64) Strategy {
+        std::atomic<uint64_t> decisions{0};
+        std::atomic<uint64_t> decisionNs{0};
+        std::atomic<uint64_t> timeouts{0};
+        std::atomic<uint64_t> ponderNs{0};       // CPU time pondering while the others decide
+    };
+
+    RunMetrics(unsigned workers, std::vector<std::string> strategies, uint64_t plannedMatches,
+               uint64_t decisionBudgetNs);
+
+    Worker& worker(unsigned w) { return workers[w]; }
+    Strategy& strategy(size_t s) { return strategies[s]; }
+
+    uint64_t decisionBudgetNs() const { return budgetNs; }
+
+    static uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Prometheus text exposition format (version 0.0.4). previous holds the games
+     * counters of the last call, to report games/s per worker over the interval.
+     */
+    void writePrometheus(std::ostream& out, std::vector<uint64_t>& previous, double intervalSeconds) const;
+
+private:
+    std::unique_ptr<Worker[]> workers;
+    std::unique_ptr<Strategy[]> strategies;
+    unsigned workerCount;
+    std::vector<std::string> names;
+    uint64_t planned;
+    uint64_t budgetNs;
+    uint64_t startNs;
+};
+
+/**
+ * Low-priority thread publishing RunMetrics every intervalSeconds:
+ *  - file : rewritten atomically (tmp + rename), e.g. for node_exporter's textfile collector
+ *  - port : plain HTTP on 127.0.0.1, any request gets the current metrics
+ */
+class MetricsExporter {
+public:
+    struct Config {
+        std::string file;
+        int port = 0;                 // 0 = no HTTP endpoint
+        double intervalSeconds = 5.0;
+    };
+
+    MetricsExporter(RunMetrics& metrics, Config config);
+    ~MetricsExporter();   // publishes a last time, then stops
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+private:
+    RunMetrics& metrics;
+    Config cfg;
+    int listenFd = -1;
+    std::atomic<bool> stopping{false};
+    std::thread thread;
+
+    void run();
+    void writeFile(const std::string& text);
+    void serve(int timeoutMs, const std::string& text);
+};
+
+} // namespace sevens
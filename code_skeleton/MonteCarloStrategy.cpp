@@ -0,0 +1,261 @@
+#include "PlayerStrategy.hpp"
+#include "SevensRules.hpp"
+#include "Features.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Flat Monte Carlo search. Every playable card is tried in `rollouts` determinizations of
+ * the round (the cards we cannot see dealt at random to the others, hand sizes kept), the
+ * rest of the round played with random playable cards; the card with the fewest of our
+ * cards left on average is played. $SEVENS_MC_ROLLOUTS sets the rollouts per card and
+ * decision (default 24).
+ *
+ * It is also a PonderingStrategy (batch --ponder): while the others decide, it runs
+ * rollouts for the positions of its next turn, the table as last notified and every
+ * table one more card away (a card the player to move may lay, not in our hand). The
+ * statistics are kept per (table, hand) for the round, so when its turn comes the
+ * position it finds has usually been searched already and selectCardToPlay adds its own
+ * rollouts to them. Without pondering it plays exactly as the seed says.
+ *
+ * 52-card game of up to 8 seats only: variants get a random playable card.
+ */
+class MonteCarloStrategy : public PonderingStrategy {
+public:
+    MonteCarloStrategy() {
+        auto seed = static_cast<unsigned long>(
+            std::chrono::system_clock::now().time_since_epoch().count()
+        );
+        rng.seed(seed);
+        ponderRng.seed(seed + 1);
+        const char* n = std::getenv("SEVENS_MC_ROLLOUTS");
+        if (n && std::atoi(n) > 0) rollouts = static_cast<unsigned>(std::atoi(n));
+    }
+
+    ~MonteCarloStrategy() override = default;
+
+    void initialize(uint64_t playerID) override {
+        game.reset(playerID);
+        myID = playerID;
+        myHand = 0;
+        stats.clear();
+    }
+
+    int selectCardToPlay(
+        const std::vector<Card>& hand,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override
+    {
+        std::vector<int> playable;
+        bool variant = !game.followed();   // more than 8 seats
+        for (size_t i = 0; i < hand.size(); ++i) {
+            variant |= hand[i].suit < 0 || hand[i].suit > 3;
+            if (isPlayable(hand[i], tableLayout)) playable.push_back(static_cast<int>(i));
+        }
+        if (playable.empty()) return -1;
+        if (variant) return playable[rng() % playable.size()];
+
+        const FeatureInput in = game.decision(hand, tableLayout);
+        myHand = in.hand;
+        int best = playable[0];
+        if (playable.size() > 1) {
+            const Position pos = position(in.hand, in.table);
+            makeRoom(1);
+            Stats& s = stats[key(pos)];
+            const uint64_t legal = Features::legal(pos.hand, pos.table);
+            for (unsigned r = 0; r < rollouts; ++r) {
+                for (uint64_t m = legal; m; m &= m - 1) {
+                    const int card = __builtin_ctzll(m);
+                    s.left[card] += rollout(pos, card, rng);
+                    s.count[card]++;
+                }
+            }
+            double bestMean = 1e9;
+            for (int i : playable) {
+                const int card = hand[i].suit * 13 + hand[i].rank - 1;
+                const double mean = s.left[card] / std::max(1u, s.count[card]);
+                if (mean < bestMean) {
+                    bestMean = mean;
+                    best = i;
+                }
+            }
+        }
+        myHand &= ~(1ull << (hand[best].suit * 13 + hand[best].rank - 1));
+        return best;
+    }
+
+    void observeMove(uint64_t playerID, const Card& playedCard) override {
+        game.moved(playerID, playedCard);
+    }
+
+    void observePass(uint64_t playerID) override {
+        game.passed(playerID);
+    }
+
+    std::string getName() const override {
+        return "MonteCarloStrategy";
+    }
+
+    // Runs on the seat's pondering thread until stopPondering()
+    void startPondering() override {
+        std::vector<Position> next = predicted();
+        std::vector<Stats*> found;
+        makeRoom(next.size());
+        for (const Position& pos : next) found.push_back(&stats[key(pos)]);
+
+        // Nothing to choose at the next turn: give the processor back (a stop request that
+        // comes after this return is only seen by the next call, which then stops at once)
+        for (size_t k = 0; !next.empty() && !stop.load(std::memory_order_relaxed); k = (k + 1) % next.size()) {
+            const uint64_t legal = Features::legal(next[k].hand, next[k].table);
+            for (uint64_t m = legal; m; m &= m - 1) {
+                const int card = __builtin_ctzll(m);
+                found[k]->left[card] += rollout(next[k], card, ponderRng);
+                found[k]->count[card]++;
+            }
+        }
+        stop.store(false, std::memory_order_relaxed);   // cleared on the way out (see PonderingStrategy)
+    }
+
+    void stopPondering() override {
+        stop.store(true, std::memory_order_relaxed);
+    }
+
+    // Reproducible runs (see seedStrategy below)
+    void seed(uint64_t s) {
+        rng.seed(static_cast<std::mt19937::result_type>(s));
+        ponderRng.seed(static_cast<std::mt19937::result_type>(s ^ 0x9E3779B97F4A7C15ull));
+    }
+
+private:
+    static constexpr unsigned kMaxSeats = ObservedGame::kMaxSeats;
+
+    // Our next decision: sizes[i] = cards of the i-th player after us (0 = us)
+    struct Position {
+        uint64_t hand = 0;
+        uint64_t table = 0;
+        unsigned players = 4;
+        unsigned sizes[kMaxSeats] = {};
+    };
+
+    // Rollout totals of the cards (by card id) in one position of the round
+    struct Stats {
+        double left[52] = {};
+        unsigned count[52] = {};
+    };
+
+    static std::pair<uint64_t, uint64_t> key(const Position& pos) { return {pos.table, pos.hand}; }
+
+    // A round has a few hundred positions at most: the bound only guards against odd games
+    void makeRoom(size_t n) {
+        if (stats.size() + n > kMaxPositions) stats.clear();
+    }
+
+    // Our decision with this hand on this table; the others' hands sizes come from the
+    // notifications, the last one taking what is left (sizes are estimated from the deal)
+    Position position(uint64_t hand, uint64_t table) const {
+        Position pos;
+        pos.hand = hand;
+        pos.table = table;
+        pos.players = game.players();
+        unsigned unseen = 52 - static_cast<unsigned>(__builtin_popcountll(table | hand));
+        pos.sizes[0] = static_cast<unsigned>(__builtin_popcountll(hand));
+        for (unsigned i = 1; i < pos.players; ++i) {
+            pos.sizes[i] = std::min(unseen, game.cardsLeft(static_cast<unsigned>((myID + i) % pos.players)));
+            unseen -= pos.sizes[i];
+        }
+        pos.sizes[pos.players - 1] += unseen;
+        return pos;
+    }
+
+    // Positions the next turn may start from, as far as the notifications tell
+    std::vector<Position> predicted() const {
+        std::vector<Position> out;
+        if (!game.tableSeen() || !myHand || !game.followed()) return out;
+
+        const Position now = position(myHand, game.tableNow());
+        if (choice(now)) out.push_back(now);
+
+        // The player to move lays one more card: any playable one we do not hold
+        const unsigned mover = static_cast<unsigned>((game.lastToAct() + 1) % now.players);
+        const unsigned i = static_cast<unsigned>((mover + now.players - myID % now.players) % now.players);
+        if (i == 0 || now.sizes[i] == 0) return out;
+        const uint64_t theirs = Features::legal(~(now.table | now.hand) & kAllCards, now.table);
+        for (uint64_t m = theirs; m; m &= m - 1) {
+            Position after = now;
+            after.table |= m & -m;
+            after.sizes[i]--;
+            if (choice(after)) out.push_back(after);
+        }
+        return out;
+    }
+
+    static bool choice(const Position& pos) {
+        const uint64_t legal = Features::legal(pos.hand, pos.table);
+        return legal & (legal - 1);
+    }
+
+    // Our cards left at the end of the round after playing `card` in a random determinization
+    static unsigned rollout(const Position& pos, int card, std::mt19937& gen) {
+        int unseen[52];
+        unsigned nUnseen = 0;
+        for (int id = 0; id < 52; ++id) {
+            if (!((pos.table | pos.hand) >> id & 1)) unseen[nUnseen++] = id;
+        }
+        std::shuffle(unseen, unseen + nUnseen, gen);
+
+        uint64_t hands[kMaxSeats] = {pos.hand};
+        for (unsigned p = 1, next = 0; p < pos.players; ++p) {
+            for (unsigned n = 0; n < pos.sizes[p]; ++n) hands[p] |= 1ull << unseen[next++];
+        }
+
+        uint64_t table = pos.table | 1ull << card;
+        hands[0] &= ~(1ull << card);
+        for (unsigned p = 1, passes = 0; hands[0] && passes < pos.players; p = (p + 1) % pos.players) {
+            uint64_t legal = Features::legal(hands[p], table);
+            if (!legal) {
+                ++passes;
+                continue;
+            }
+            for (unsigned k = static_cast<unsigned>(gen() % __builtin_popcountll(legal)); k; --k) legal &= legal - 1;
+            const uint64_t bit = legal & -legal;
+            hands[p] &= ~bit;
+            table |= bit;
+            passes = 0;
+            if (!hands[p]) break;
+        }
+        return static_cast<unsigned>(__builtin_popcountll(hands[0]));
+    }
+
+    static constexpr uint64_t kAllCards = (1ull << 52) - 1;
+    static constexpr size_t kMaxPositions = 4096;
+
+    std::mt19937 rng;
+    std::mt19937 ponderRng;           // the pondering thread's own, the decisions stay seeded
+    unsigned rollouts = 24;
+    uint64_t myID = 0;
+    uint64_t myHand = 0;              // after our last decision
+    ObservedGame game;
+    std::map<std::pair<uint64_t, uint64_t>, Stats> stats;   // (table, hand) → rollouts of the round
+    std::atomic<bool> stop{false};
+};
+
+} // namespace sevens
+
+// Export function for the loader — DO NOT place in the namespace
+#ifndef SEVENS_STATIC_STRATEGIES // compiled into the binary instead, see BuiltinStrategies.hpp
+extern "C" sevens::PlayerStrategy* createStrategy() {
+    return new sevens::MonteCarloStrategy();
+}
+
+extern "C" void seedStrategy(sevens::PlayerStrategy* strategy, uint64_t seed) {
+    static_cast<sevens::MonteCarloStrategy*>(strategy)->seed(seed);
+}
+#endif
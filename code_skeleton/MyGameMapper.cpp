@@ -1,7 +1,13 @@
 #include "MyGameMapper.hpp"
 #include "MyCardParser.hpp"
 #include "MyGameParser.hpp"
+#include "SevensRules.hpp"
+#include "GameArena.hpp"
+#include "AllocTracker.hpp"
+#include "DealCorpus.hpp"
+#include "Ponderer.hpp"
 #include <iostream>
+#include <stdexcept>
 #include <algorithm>
 #include <random>
 #include <chrono>
@@ -90,7 +96,7 @@ void MyGameMapper::read_cards() {
  * Initialize game state - start with only 7 of diamonds on table
  */
 void MyGameMapper::read_game() {
-    MyGameParser g;
+    MyGameParser g(table_file);
     g.read_game(); 
     table_layout = g.get_table_layout();
 }
@@ -106,23 +112,68 @@ bool MyGameMapper::hasRegisteredStrategies() const {
  * Register a player strategy
  */
 void MyGameMapper::registerStrategy(uint64_t id, std::shared_ptr<PlayerStrategy> s) {
+    if (AllocTracker::enabled) alloc_ids[id] = AllocTracker::strategyId(s->getName());
+    if (pondering) {
+        PonderingStrategy* ps = dynamic_cast<PonderingStrategy*>(s.get());
+        if (ponderers.size() <= id) ponderers.resize(id + 1);
+        if (ps && !ponderers[id]) ponderers[id] = std::make_shared<Ponderer>();
+        if (ponderers[id]) {
+            ponderers[id]->pause();
+            ponderers[id]->attach(ps);
+        }
+    }
     strategies[id] = std::move(s);
 }
 
 /**
- * Determine if a card is playable based on game rules
- * - 7s can be played if not already on table
- * - Other cards can be played if adjacent card of same suit is on table
+ * Allocation-accounting id of a player's strategy (always 0 in regular builds)
  */
-static bool isPlayable(const Card& c, 
-                     const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& table) {
-    // 7s can be played if not already on table
-    if(c.rank == 7) return !table.count(c.suit) || !table.at(c.suit).count(7) || !table.at(c.suit).at(7);
-    
-    // Other cards need adjacent card of same suit on table
-    bool lower = c.rank > 1  && table.count(c.suit) && table.at(c.suit).count(c.rank-1) && table.at(c.suit).at(c.rank-1);
-    bool upper = c.rank < 13 && table.count(c.suit) && table.at(c.suit).count(c.rank+1) && table.at(c.suit).at(c.rank+1);
-    return lower || upper;
+uint32_t MyGameMapper::alloc_id(uint64_t id) const {
+    if (!AllocTracker::enabled) return 0;
+    auto it = alloc_ids.find(id);
+    return it == alloc_ids.end() ? 0 : it->second;
+}
+
+/**
+ * Re-seed the engine random number generator (shuffle and starting player)
+ * so that a sequence of games can be replayed, e.g. by sevens_bench.
+ */
+void MyGameMapper::seed(uint64_t s) {
+    rng.seed(static_cast<std::mt19937::result_type>(s));
+}
+
+/**
+ * Starting table read by read_game ("" = 7♦ only)
+ */
+void MyGameMapper::set_table_file(const std::string& path) {
+    table_file = path;
+}
+
+/**
+ * Play the deals of a corpus from deal `next` on (nullptr: shuffle again)
+ */
+void MyGameMapper::use_deals(const DealCorpus* corpus, uint64_t next) {
+    deals = corpus;
+    next_deal = next;
+}
+
+/**
+ * Hands of the next deal of the corpus, each by increasing card id, read straight from the
+ * mapped file. A deal with its own starting table (deal.hasTable()) replaces the opening
+ * table, which is left to the caller.
+ */
+DealCorpus::Deal MyGameMapper::deal_from_corpus(uint64_t nP, std::vector<std::vector<Card>>& hands) {
+    if (deals->players() != nP) {
+        throw std::runtime_error("Corpus " + deals->path() + " : donnes pour " + std::to_string(deals->players()) +
+                                 " joueurs, pas " + std::to_string(nP));
+    }
+    const DealCorpus::Deal deal = deals->deal(next_deal++ % deals->size());
+
+    for (int id = 0; id < 52; ++id) {
+        unsigned owner = deal.owner(id);
+        if (owner < nP) hands[owner].push_back(Card{id / 13, id % 13 + 1});
+    }
+    return deal;
 }
 
 
@@ -134,113 +185,277 @@ static bool isPlayable(const Card& c,
 
 
 // TODO: implement a quiet simulation
+// The round itself allocates nothing (play_round); the ranking returned by value is the
+// one allocation per call.
 std::vector<std::pair<uint64_t, uint64_t>>
 MyGameMapper::compute_game_progress(uint64_t nP) {
 
+    const std::vector<uint64_t>& scores = play_round(nP);
 
-    // Initialize Cards and Table
-    read_cards(); 
-    read_game(); 
+    // Calculate final rankings
+    std::vector<std::pair<uint64_t, uint64_t>> scoreWithId;
+    scoreWithId.reserve(nP);
+    for(uint64_t i = 0; i < nP; ++i) {
+        scoreWithId.emplace_back(i, scores[i]);
+    }
+    
+    // Sort by score (ascending - fewer cards is better)
+    std::sort(scoreWithId.begin(), scoreWithId.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+    
+    return scoreWithId;
+}
+
+/**
+ * Cards and opening table are read once, then reused for every round of play_round.
+ * Copies of a prepared mapper (one per worker thread) do not read them again.
+ */
+void MyGameMapper::prepare_rounds() {
+    if (deck_template.empty()) {
+        read_cards();
+        for (auto& [id, c] : cards_hashmap) deck_template.push_back(c);
+    }
+    if (opening_cards.empty()) {
+        read_game();
+        for (auto& [suit, ranks] : table_layout)
+            for (auto& [rank, on] : ranks)
+                if (on) opening_cards.push_back(Card{static_cast<int>(suit), static_cast<int>(rank)});
+    }
+}
 
+/**
+ * Quiet simulation of one round on the thread's GameArena (or the one of use_arena).
+ * Returns the number of cards left in each player's hand, indexed by player id; the
+ * reference stays valid until the next round played on the same arena.
+ * Apart from the first round of an arena, nothing is allocated here.
+ */
+const std::vector<uint64_t>& MyGameMapper::play_round(uint64_t nP) {
+    start_round(nP);
+    while (!round_over) end_turn(decide());
+    return arena().scores;
+}
 
-    // Distribute Cards to Players
-    // Prepare a shuffled deck (all 52 cards)
-    std::vector<Card> deck;
-    for (auto& [id, c] : cards_hashmap) deck.push_back(c);
+GameArena& MyGameMapper::arena() const {
+    return round_arena ? *round_arena : GameArena::forThisThread();
+}
 
-    // shuffle deck
-    std::shuffle(deck.begin(), deck.end(), rng);
+void MyGameMapper::use_arena(GameArena* a) {
+    round_arena = a;
+}
+
+/**
+ * Deals a round and initializes the strategies; the first decision is then the one of
+ * the player after the dealer.
+ */
+void MyGameMapper::start_round(uint64_t nP) {
 
-    // Choose a random starting player
-    int start_player = rng() % nP;
+    prepare_rounds();
 
-    // Deal cards to players starting from random player
-    std::vector<std::vector<Card>> hands(nP);
-    for (size_t i = 0; i < deck.size(); ++i) {
-        int player = (start_player + i) % nP;
-        hands[player].push_back(deck[i]);
+    GameArena& arena = this->arena();
+    arena.reset(nP);
+    for (const Card& c : opening_cards) arena.tableNodes.put(arena.table, c.suit, c.rank);
+
+    // Distribute Cards to Players
+    auto& hands = arena.hands;
+    int start_player;
+    if (deals) {
+        // Fixed deal of the corpus, no shuffling
+        const DealCorpus::Deal deal = deal_from_corpus(nP, hands);
+        if (deal.hasTable()) {
+            arena.clearTable();
+            for (int id = 0; id < 52; ++id) {
+                if ((deal.table() >> id) & 1) arena.tableNodes.put(arena.table, id / 13, id % 13 + 1);
+            }
+        }
+        start_player = static_cast<int>(deal.dealer() % nP);
+    } else {
+        // Prepare a shuffled deck (all 52 cards)
+        auto& deck = arena.deck;
+        deck = deck_template;
+
+        // shuffle deck
+        std::shuffle(deck.begin(), deck.end(), rng);
+
+        // Choose a random starting player
+        start_player = rng() % nP;
+
+        // Deal cards to players starting from random player
+        for (size_t i = 0; i < deck.size(); ++i) {
+            int player = (start_player + i) % nP;
+            hands[player].push_back(deck[i]);
+        }
     }
 
-    // Search for and remove 7♦ (suit=2, rank=7)
-    for (auto& hand : hands) {
-        auto it = std::find_if(hand.begin(), hand.end(), [](const Card& c) {
-            return c.suit == 2 && c.rank == 7;
-        });
-        if (it != hand.end()) {
-            hand.erase(it);
-            break; // Found and removed, done
+    // Search for and remove the opening cards (7♦, suit=2, rank=7)
+    for (const Card& open : opening_cards) {
+        for (uint64_t p = 0; p < nP; ++p) {
+            auto& hand = hands[p];
+            auto it = std::find_if(hand.begin(), hand.end(), [&open](const Card& c) {
+                return c.suit == open.suit && c.rank == open.rank;
+            });
+            if (it != hand.end()) {
+                hand.erase(it);
+                break; // Found and removed, done
+            }
         }
     }
 
 
+    arena.maskTable();
+
     // Initialize player scores and strategies
-    std::vector<uint64_t> scores(nP);
+    auto& scores = arena.scores;
     for(uint64_t i = 0; i < nP; ++i) {
-        if(strategies.count(i)) strategies[i]->initialize(i);
+        if(strategies.count(i)) {
+            AllocScope scope(alloc_id(i), StrategyCallback::Initialize);
+            strategies[i]->initialize(i);
+        }
         scores[i] = hands[i].size();
     }
 
-    // Main game loop
-    uint64_t current_player = (start_player + 1) % nP;  // the loops start with the player after the first player who played the opening 7 of diamond
-    bool game_over = false;
-    std::vector<bool> passed(nP, false);
+    round_players = nP;
+    round_player = (start_player + 1) % nP;  // the loops start with the player after the first player who played the opening 7 of diamond
+    round_over = false;
+}
 
-    while(!game_over) {
+/**
+ * The player to move calls selectCardToPlay() (timed when a decision budget is set) while
+ * the other pondering seats think; end_turn stops them.
+ */
+int MyGameMapper::decide() {
+    GameArena& arena = this->arena();
+    auto& strategy = strategies[round_player];
+    auto& hand = arena.hands[round_player];
+    if (pondering) {
+        for (uint64_t p = 0; p < ponderers.size(); ++p) {
+            if (ponderers[p] && p != round_player) ponderers[p]->resume();
+        }
+    }
+    AllocScope scope(alloc_id(round_player), StrategyCallback::SelectCardToPlay);
+    if (!decision_budget_ns) return strategy->selectCardToPlay(hand, arena.table);
+
+    if (pondering) {
+        // The pondering threads share the processors: wall-clock time would charge them here
+        const uint64_t t0 = Ponderer::threadCpuNs();
+        int selected_card_idx = strategy->selectCardToPlay(hand, arena.table);
+        record_decision_ns(Ponderer::threadCpuNs() - t0);
+        return selected_card_idx;
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    int selected_card_idx = strategy->selectCardToPlay(hand, arena.table);
+    record_decision_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - t0).count());
+    return selected_card_idx;
+}
 
-        // Load current player strategy and hand, and call the player's selectCardToPlay() method
-        auto& strategy = strategies[current_player];
-        auto& hand = hands[current_player];
-        int selected_card_idx = strategy->selectCardToPlay(hand, table_layout);
+/**
+ * Stops every pondering seat (the strategies are about to be notified) and books the CPU
+ * time they spent into the round
+ */
+void MyGameMapper::pause_pondering() {
+    if (!pondering) return;
+    GameArena& arena = this->arena();
+    for (uint64_t p = 0; p < ponderers.size(); ++p) {
+        if (!ponderers[p]) continue;
+        ponderers[p]->pause();
+        const uint64_t ns = ponderers[p]->takeCpuNs();
+        if (p < arena.ponderNs.size()) arena.ponderNs[p] += ns;
+    }
+}
 
-        // Check if the player played a valid card
-        bool played_successfully = false;
-        if(selected_card_idx >= 0 && (size_t)selected_card_idx < hand.size() && isPlayable(hand[selected_card_idx], table_layout)) {
-            
-            // Place card on table
-            Card played_card = hand[selected_card_idx];
-            table_layout[played_card.suit][played_card.rank] = true;
+void MyGameMapper::set_pondering(bool on) {
+    pause_pondering();
+    pondering = on;
+    if (!on) ponderers.clear();
+}
 
-            // Notify all players of the move
-            for(auto& [id, s] : strategies) s->observeMove(current_player, played_card);
+const std::vector<uint64_t>& MyGameMapper::round_ponder_ns() const {
+    return arena().ponderNs;
+}
 
-            // Remove card from hand
-            hand.erase(hand.begin() + selected_card_idx);
-            scores[current_player] = hand.size();
-            
-            // Check if player has emptied their hand (game ends)
-            if(hand.empty()) {
-                game_over = true;
-            }
-            
-            passed[current_player] = false;
-            played_successfully = true;
+/**
+ * Plays (or passes) the decision of the player to move and hands the turn over
+ */
+void MyGameMapper::end_turn(int selected_card_idx) {
+    GameArena& arena = this->arena();
+    auto& table = arena.table;
+    auto& strategy = strategies[round_player];
+    auto& hand = arena.hands[round_player];
+    auto& passed = arena.passed;
+
+    pause_pondering();
+
+    // Check if the player played a valid card
+    bool played_successfully = false;
+    if(selected_card_idx >= 0 && (size_t)selected_card_idx < hand.size() && isPlayable(hand[selected_card_idx], table)) {
+
+        // Place card on table
+        Card played_card = hand[selected_card_idx];
+        arena.put(played_card);
+
+        // Notify all players of the move
+        for(auto& [id, s] : strategies) {
+            AllocScope scope(alloc_id(id), StrategyCallback::ObserveMove);
+            s->observeMove(round_player, played_card);
         }
 
-        // Handle pass
-        if(!played_successfully) { 
-            strategy->observePass(current_player); 
-            passed[current_player] = true; 
+        // Remove card from hand
+        hand.erase(hand.begin() + selected_card_idx);
+        arena.scores[round_player] = hand.size();
+
+        // Check if player has emptied their hand (game ends)
+        if(hand.empty()) {
+            round_over = true;
         }
 
-        // Next player's turn
-        current_player = (current_player + 1) % nP;
+        passed[round_player] = false;
+        played_successfully = true;
+        arena.moves[round_player]++;
+        arena.history.push_back(MoveEvent{round_player, played_card});
+    }
 
-        // Check if all players have passed (game ends)
-        if(std::all_of(passed.begin(), passed.end(), [](bool p) { return p; })) {
-            game_over = true;
-        }
+    // Handle pass
+    if(!played_successfully) {
+        AllocScope scope(alloc_id(round_player), StrategyCallback::ObservePass);
+        strategy->observePass(round_player);
+        passed[round_player] = true;
+        arena.passes[round_player]++;
+        arena.history.push_back(MoveEvent{round_player, Card{-1, 0}});
     }
 
-    // Calculate final rankings
-    std::vector<std::pair<uint64_t, uint64_t>> scoreWithId;
-    for(uint64_t i = 0; i < nP; ++i) {
-        scoreWithId.emplace_back(i, scores[i]);
+    // Next player's turn
+    round_player = (round_player + 1) % round_players;
+
+    // Check if all players have passed (game ends)
+    if(std::all_of(passed.begin(), passed.end(), [](bool p) { return p; })) {
+        round_over = true;
     }
-    
-    // Sort by score (ascending - fewer cards is better)
-    std::sort(scoreWithId.begin(), scoreWithId.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
-    
-    return scoreWithId;
+}
+
+/**
+ * Cards played / passes per player during the last play_round on this arena
+ */
+const std::vector<uint64_t>& MyGameMapper::round_moves() const {
+    return arena().moves;
+}
+
+const std::vector<uint64_t>& MyGameMapper::round_passes() const {
+    return arena().passes;
+}
+
+/**
+ * Time spent in selectCardToPlay and decisions over the budget, per player, during the
+ * last play_round on this arena (zero unless set_decision_budget was called)
+ */
+const std::vector<uint64_t>& MyGameMapper::round_decision_ns() const {
+    return arena().decisionNs;
+}
+
+const std::vector<uint64_t>& MyGameMapper::round_timeouts() const {
+    return arena().timeouts;
+}
+
+void MyGameMapper::set_decision_budget(uint64_t ns) {
+    decision_budget_ns = ns;
 }
 
 
@@ -263,39 +478,52 @@ MyGameMapper::compute_and_display_game(uint64_t nP) {
 
 
     // Distribute Cards to Players
-    // Prepare a shuffled deck (all 52 cards)
-    std::vector<Card> deck;
-    for (auto& [id, c] : cards_hashmap) deck.push_back(c);
-
-    // shuffle deck
-    std::shuffle(deck.begin(), deck.end(), rng);
-
-    // Choose a random starting player
-    int start_player = rng() % nP;
-
-    // Deal cards to players starting from random player
     std::vector<std::vector<Card>> hands(nP);
-    for (size_t i = 0; i < deck.size(); ++i) {
-        int player = (start_player + i) % nP;
-        hands[player].push_back(deck[i]);
+    int start_player;
+    if (deals) {
+        // Fixed deal of the corpus (deck file)
+        const DealCorpus::Deal deal = deal_from_corpus(nP, hands);
+        if (deal.hasTable()) {
+            table_layout.clear();
+            for (int id = 0; id < 52; ++id) {
+                if ((deal.table() >> id) & 1) table_layout[id / 13][id % 13 + 1] = true;
+            }
+        }
+        start_player = static_cast<int>(deal.dealer() % nP);
+    } else {
+        // Prepare a shuffled deck (all 52 cards)
+        std::vector<Card> deck;
+        for (auto& [id, c] : cards_hashmap) deck.push_back(c);
+
+        // shuffle deck
+        std::shuffle(deck.begin(), deck.end(), rng);
+
+        // Choose a random starting player
+        start_player = rng() % nP;
+
+        // Deal cards to players starting from random player
+        for (size_t i = 0; i < deck.size(); ++i) {
+            int player = (start_player + i) % nP;
+            hands[player].push_back(deck[i]);
+        }
     }
 
-    // Search for and remove 7♦ (suit=2, rank=7)
+    // Search for and remove the cards of the starting table (7♦, suit=2, rank=7, unless a table file says otherwise)
     for (auto& hand : hands) {
-        auto it = std::find_if(hand.begin(), hand.end(), [](const Card& c) {
-            return c.suit == 2 && c.rank == 7;
-        });
-        if (it != hand.end()) {
-            hand.erase(it);
-            break; // Found and removed, done
-        }
+        hand.erase(std::remove_if(hand.begin(), hand.end(), [this](const Card& c) {
+            auto s = table_layout.find(c.suit);
+            return s != table_layout.end() && s->second.count(c.rank) && s->second.at(c.rank);
+        }), hand.end());
     }
 
 
     // Initialize player scores and strategies
     std::vector<uint64_t> scores(nP);
     for(uint64_t i = 0; i < nP; ++i) {
-        if(strategies.count(i)) strategies[i]->initialize(i);
+        if(strategies.count(i)) {
+            AllocScope scope(alloc_id(i), StrategyCallback::Initialize);
+            strategies[i]->initialize(i);
+        }
         scores[i] = hands[i].size();
     }
 
@@ -317,7 +545,11 @@ MyGameMapper::compute_and_display_game(uint64_t nP) {
         // Load current player strategy and hand, and call the player's selectCardToPlay() method
         auto& strategy = strategies[current_player];
         auto& hand = hands[current_player];
-        int selected_card_idx = strategy->selectCardToPlay(hand, table_layout);
+        int selected_card_idx;
+        {
+            AllocScope scope(alloc_id(current_player), StrategyCallback::SelectCardToPlay);
+            selected_card_idx = strategy->selectCardToPlay(hand, table_layout);
+        }
 
         // Check if the player played a valid card
         bool played_successfully = false;
@@ -334,7 +566,10 @@ MyGameMapper::compute_and_display_game(uint64_t nP) {
             printTable(table_layout);
 
             // Notify all players of the move
-            for(auto& [id, s] : strategies) s->observeMove(current_player, played_card);
+            for(auto& [id, s] : strategies) {
+                AllocScope scope(alloc_id(id), StrategyCallback::ObserveMove);
+                s->observeMove(current_player, played_card);
+            }
 
             // Remove card from hand
             hand.erase(hand.begin() + selected_card_idx);
@@ -352,6 +587,7 @@ MyGameMapper::compute_and_display_game(uint64_t nP) {
 
         // Handle pass
         if(!played_successfully) { 
+            AllocScope scope(alloc_id(current_player), StrategyCallback::ObservePass);
             strategy->observePass(current_player); 
             passed[current_player] = true; 
         }
@@ -422,6 +658,119 @@ MyGameMapper::compute_and_display_game(const std::vector<std::string>& names) {
 
 
 
+/**
+ * Final standings of a match: sort by lowest total score first, highest win count second.
+ * Players with the same score and win count share a rank.
+ */
+struct MatchStanding {
+    uint64_t id;
+    uint64_t score;
+    uint64_t wins;
+    uint64_t rank;
+};
+
+static std::vector<MatchStanding> rank_match(const std::vector<uint64_t>& totals,
+                                             const std::vector<uint64_t>& wins) {
+    std::vector<MatchStanding> players;
+    for (uint64_t i = 0; i < totals.size(); ++i) {
+        players.push_back({i, totals[i], wins[i], 0});
+    }
+
+    // Sort by: lowest score first, highest win count second
+    std::sort(players.begin(), players.end(), [](const MatchStanding& a, const MatchStanding& b) {
+        if (a.score != b.score) return a.score < b.score;
+        return a.wins > b.wins;
+    });
+
+    for (size_t i = 0; i < players.size(); ++i) {
+        players[i].rank = i + 1;
+
+        // Handle ties (same score and win count)
+        if (i > 0 && players[i].score == players[i - 1].score &&
+                    players[i].wins  == players[i - 1].wins) {
+            players[i].rank = players[i - 1].rank;
+        }
+    }
+    return players;
+}
+
+/**
+ * Quiet version of compute_multiple_rounds_to_score: same rounds, same scoring and
+ * ranking, nothing printed. Used by the parallel MatchRunner.
+ */
+MatchResult MyGameMapper::play_match(uint64_t numPlayers, uint64_t maxScore, RoundObserver* observer) {
+    start_match(numPlayers, maxScore, observer);
+    while (!match_done) play_turn(decide());
+    return match;
+}
+
+void MyGameMapper::start_match(uint64_t numPlayers, uint64_t maxScore, RoundObserver* observer) {
+    match = MatchResult();
+    match.totals.assign(numPlayers, 0);
+    match.wins.assign(numPlayers, 0);
+    match.ties.assign(numPlayers, 0);
+    match_max_score = maxScore;
+    match_observer = observer;
+    match_done = false;
+    start_round(numPlayers);
+}
+
+void MyGameMapper::play_turn(int selectedCardIdx) {
+    end_turn(selectedCardIdx);
+    if (!round_over) return;
+
+    const uint64_t numPlayers = round_players;
+    const std::vector<uint64_t>& left = arena().scores;
+    match.rounds++;
+
+    uint64_t bestScore = *std::min_element(left.begin(), left.begin() + numPlayers);
+    uint64_t winners = std::count(left.begin(), left.begin() + numPlayers, bestScore);
+    if (match_observer) match_observer->onRound(match.rounds, left, round_moves(), round_passes());
+
+    bool gameOver = false;
+    for (uint64_t i = 0; i < numPlayers; ++i) {
+        match.totals[i] += left[i];
+        if (left[i] == bestScore) {
+            match.wins[i]++;                 // player won this round
+            if (winners > 1) match.ties[i]++; // ... ex aequo
+        }
+        if (match.totals[i] >= match_max_score) gameOver = true;
+    }
+
+    if (!gameOver) {
+        start_round(numPlayers);
+        return;
+    }
+    match.ranks.assign(numPlayers, 0);
+    for (const MatchStanding& p : rank_match(match.totals, match.wins)) {
+        match.ranks[p.id] = p.rank;
+    }
+    match_done = true;
+}
+
+const std::vector<Card>& MyGameMapper::hand_to_play() const {
+    return arena().hands[round_player];
+}
+
+const TableLayout& MyGameMapper::round_table() const {
+    return arena().table;
+}
+
+const std::vector<MoveEvent>& MyGameMapper::round_history() const {
+    return arena().history;
+}
+
+void MyGameMapper::record_decision_ns(uint64_t ns) {
+    if (!decision_budget_ns) return;
+    GameArena& arena = this->arena();
+    arena.decisionNs[round_player] += ns;
+    if (ns > decision_budget_ns) arena.timeouts[round_player]++;
+}
+
+PlayerStrategy& MyGameMapper::strategy_to_play() {
+    return *strategies[round_player];
+}
+
 /**
  * Multi-round game mode that continues until a player reaches maxScore
  * Each round, players accumulate points based on cards left in hand
@@ -482,35 +831,14 @@ MyGameMapper::compute_multiple_rounds_to_score(uint64_t numPlayers, uint64_t max
     uint64_t totalRounds = roundNumber - 1;
 
     // --- Prepare final ranking info ---
-    struct PlayerStats {
-        uint64_t id;
-        uint64_t score;
-        uint64_t wins;
-    };
-
-    std::vector<PlayerStats> players;
-    for (uint64_t i = 0; i < numPlayers; ++i) {
-        players.push_back({i, totalScores[i], winCounts[i]});
-    }
-
-    // Sort by: lowest score first, highest win count second
-    std::sort(players.begin(), players.end(), [](const PlayerStats& a, const PlayerStats& b) {
-        if (a.score != b.score) return a.score < b.score;
-        return a.wins > b.wins;
-    });
+    std::vector<MatchStanding> players = rank_match(totalScores, winCounts);
 
     // --- Display Final Results ---
     std::cout << "\n=== FINAL RESULTS AFTER " << totalRounds << " ROUNDS ===\n";
 
     std::vector<std::pair<uint64_t, uint64_t>> finalResults;  // {playerId, rank}
     for (size_t i = 0; i < players.size(); ++i) {
-        uint64_t rank = i + 1;
-
-        // Handle ties (same score and win count)
-        if (i > 0 && players[i].score == players[i - 1].score &&
-                    players[i].wins  == players[i - 1].wins) {
-            rank = finalResults.back().second;
-        }
+        uint64_t rank = players[i].rank;
 
         finalResults.emplace_back(players[i].id, rank);
 
@@ -6,6 +6,7 @@
 #include "Generic_game_parser.hpp"
 #include "MyCardParser.hpp"
 #include "MyGameParser.hpp"
+#include "DealCorpus.hpp"
 
 #include <random>
 #include <unordered_map>
@@ -15,6 +16,31 @@
 
 namespace sevens {
 
+struct GameArena;
+class Ponderer;
+
+/**
+ * Outcome of one match (rounds until a player reaches maxScore), see play_match.
+ * All vectors are indexed by player id.
+ */
+struct MatchResult {
+    uint64_t rounds = 0;
+    std::vector<uint64_t> totals;   // points = cards left, summed over the rounds
+    std::vector<uint64_t> wins;     // rounds with the lowest score (ties included)
+    std::vector<uint64_t> ties;     // rounds won ex aequo with another player
+    std::vector<uint64_t> ranks;    // final rank, 1 = best (ties share a rank)
+};
+
+/**
+ * Receives every round of play_match (per-game results), all vectors indexed by player id.
+ */
+class RoundObserver {
+public:
+    virtual ~RoundObserver() = default;
+    virtual void onRound(uint64_t round, const std::vector<uint64_t>& cardsLeft,
+                         const std::vector<uint64_t>& moves, const std::vector<uint64_t>& passes) = 0;
+};
+
 /**
  * Enhanced Sevens simulation with strategy support:
  *  - Possibly internal mode or competition mode
@@ -36,10 +62,58 @@ public:
     std::vector<std::pair<std::string, uint64_t>>
     compute_and_display_game(const std::vector<std::string>& playerNames) override;
 
+    // Quiet round on the per-thread GameArena: cards left per player id (no allocation once warm)
+    const std::vector<uint64_t>& play_round(uint64_t numPlayers);
+
+    // Rounds are played on the thread's GameArena; a match kept in flight while the thread
+    // plays others (interleaved batch) needs its own. nullptr = the thread's again.
+    void use_arena(GameArena* arena);
+
+    // Cards played / passes per player id during the last play_round on this arena
+    const std::vector<uint64_t>& round_moves() const;
+    const std::vector<uint64_t>& round_passes() const;
+
+    // Times every selectCardToPlay of play_round; a decision longer than ns counts as a
+    // timeout (the move is still played, a .so cannot be interrupted). 0 = no timing.
+    void set_decision_budget(uint64_t ns);
+    const std::vector<uint64_t>& round_decision_ns() const;
+    const std::vector<uint64_t>& round_timeouts() const;
+
+    // Seats whose strategy is a PonderingStrategy think on a thread of their own while the
+    // others decide (see Ponderer.hpp); their CPU time is round_ponder_ns(), and decisions
+    // are then timed in CPU time of the engine thread. Set before registering the strategies;
+    // copies of the mapper share its pondering threads. Not for the one-turn-at-a-time API
+    // when decisions are answered in batches.
+    void set_pondering(bool on);
+    const std::vector<uint64_t>& round_ponder_ns() const;
+
     // New method for playing multiple rounds until a player reaches 50 points
     std::vector<std::pair<uint64_t, uint64_t>>
     compute_multiple_rounds_to_score(uint64_t numPlayers, uint64_t maxScore);
 
+    // Quiet, structured version of compute_multiple_rounds_to_score
+    MatchResult play_match(uint64_t numPlayers, uint64_t maxScore, RoundObserver* observer = nullptr);
+
+    // play_match one decision at a time, for the engines that interleave many matches on one
+    // thread: start_match deals the first round, then each play_turn gives the choice of the
+    // player to move (decide() or a batched answer) until match_over(); match_result() is
+    // then what play_match returns.
+    void start_match(uint64_t numPlayers, uint64_t maxScore, RoundObserver* observer = nullptr);
+    bool match_over() const { return match_done; }
+    uint64_t to_play() const { return round_player; }
+    PlayerStrategy& strategy_to_play();
+    const std::vector<Card>& hand_to_play() const;
+    const TableLayout& round_table() const;
+    const std::vector<MoveEvent>& round_history() const;
+    int decide();                                  // selectCardToPlay of to_play(), timed as in play_round
+    void record_decision_ns(uint64_t ns);          // time of a decision answered in a batch instead
+    uint32_t alloc_id_to_play() const { return alloc_id(round_player); }   // AllocScope of a batched answer
+    void play_turn(int selectedCardIdx);
+    const MatchResult& match_result() const { return match; }
+
+    // Reads the deck and the opening table used by play_round (done lazily otherwise)
+    void prepare_rounds();
+
     // Required by Generic_card_parser and Generic_game_parser
     void read_cards() override;
     void read_game() override;
@@ -49,6 +123,18 @@ public:
     void registerStrategy(uint64_t playerID, std::shared_ptr<PlayerStrategy> strategy) override;
     bool hasRegisteredStrategies() const override;
 
+    // Reproducible runs: re-seed the shuffle / starting player generator
+    void seed(uint64_t s);
+
+    // Starting table read by read_game / prepare_rounds: a text file of rank:suit cards
+    // (e.g. "7:2 6:2"), "" = the 7♦ only
+    void set_table_file(const std::string& path);
+
+    // Fixed deals (DealCorpus.hpp) instead of shuffling: the next round plays deal `next`
+    // (modulo the corpus size), the one after deal next + 1, ... nullptr = random deals again.
+    // The corpus must outlive the rounds and have been generated for this number of players.
+    void use_deals(const DealCorpus* corpus, uint64_t next = 0);
+
 private:
     // data structures needed to track the game
 
@@ -61,8 +147,48 @@ private:
     // Table Layout
     std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>> table_layout;
 
+    // Deck order and opening cards (7♦), read once for play_round
+    std::vector<Card> deck_template;
+    std::vector<Card> opening_cards;
+
+    // Starting table file, see set_table_file
+    std::string table_file;
+
+    // Fixed deals, see use_deals
+    const DealCorpus* deals = nullptr;
+    uint64_t next_deal = 0;
+
+    // Fills the hands from the next deal; returns it (dealer, starting table)
+    DealCorpus::Deal deal_from_corpus(uint64_t nP, std::vector<std::vector<Card>>& hands);
+
+    // Decision timing of play_round (live metrics), 0 = off
+    uint64_t decision_budget_ns = 0;
+
+    // Round and match in progress (play_round, play_match and the one-turn-at-a-time API)
+    GameArena* round_arena = nullptr;   // nullptr = GameArena::forThisThread()
+    uint64_t round_players = 0;
+    uint64_t round_player = 0;          // player to move
+    bool round_over = true;
+    MatchResult match;
+    uint64_t match_max_score = 0;
+    RoundObserver* match_observer = nullptr;
+    bool match_done = true;
+
+    GameArena& arena() const;
+    void start_round(uint64_t nP);
+    void end_turn(int selectedCardIdx);
+
     // Players strategies
     std::unordered_map<uint64_t, std::shared_ptr<PlayerStrategy>> strategies;
+
+    // Pondering threads by player id, see set_pondering (after strategies: stopped first)
+    bool pondering = false;
+    std::vector<std::shared_ptr<Ponderer>> ponderers;
+    void pause_pondering();
+
+    // Allocation accounting ids (instrumentation build, see AllocTracker.hpp)
+    std::unordered_map<uint64_t, uint32_t> alloc_ids;
+    uint32_t alloc_id(uint64_t playerID) const;
 };
 
 } // namespace sevens
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
 
 namespace sevens {
 
@@ -11,6 +12,30 @@ void MyGameParser::read_game() {
 
     table_layout.clear();
 
+    if (!table_file.empty()) {
+        std::ifstream in(table_file);
+        if (!in) throw std::runtime_error("Impossible de lire la table de départ : " + table_file);
+        std::cout << "[MyGameParser::read_game] // Starting table read from " << table_file << "\n";
+
+        // rank:suit tokens, separated by spaces, commas or new lines
+        std::string token;
+        while (in >> token) {
+            std::stringstream items(token);
+            std::string item;
+            while (std::getline(items, item, ',')) {
+                if (item.empty()) continue;
+                int rank = 0, suit = -1;
+                char colon = 0;
+                std::stringstream card(item);
+                if (!(card >> rank >> colon >> suit) || colon != ':' || rank < 1 || rank > 13 || suit < 0 || suit > 3) {
+                    throw std::runtime_error("Carte invalide dans " + table_file + " : " + item);
+                }
+                table_layout[suit][rank] = true;
+            }
+        }
+        return;
+    }
+
     std::cout << "[MyGameParser::read_game] // We start with the 7♦ on the table (suit 2 = diamonds)\n";
 
     table_layout[2][7] = true;
@@ -2,6 +2,9 @@
 
 #include "Generic_game_parser.hpp"
 
+#include <string>
+#include <utility>
+
 namespace sevens {
 
 /**
@@ -11,11 +14,16 @@ namespace sevens {
 class MyGameParser : public Generic_game_parser {
 public:
     MyGameParser() = default;
+    // Starting table from a text file of rank:suit cards, e.g. "7:2 6:2 8:2" ("" = 7♦ only)
+    explicit MyGameParser(std::string tableFile) : table_file(std::move(tableFile)) {}
     ~MyGameParser() = default;
 
     void read_cards() override; // dummy override, because Generic_game_parser inherits from Generic_card_parser so the method must be defined
     void read_game() override;
 
+private:
+    std::string table_file;
+
 };
 
 } // namespace sevens
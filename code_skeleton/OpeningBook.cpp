@@ -0,0 +1,175 @@
+#include "OpeningBook.hpp"
+#include "VariantGame.hpp"
+#include "StrategyLoader.hpp"
+#include "MatchRunner.hpp"
+#include "WorkScheduler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <unordered_map>
+
+namespace sevens {
+
+namespace {
+
+struct MoveStats {
+    uint64_t cardsLeft = 0;
+    uint64_t samples = 0;
+};
+
+using BookStats = std::unordered_map<uint32_t, std::array<MoveStats, OpeningBook::kMoves>>;
+
+/**
+ * StrategySeats that watches one seat: at its decision-th decision it records the key and
+ * the playable cards, then plays `forced` (or, when forced < 0, what the strategy picks).
+ */
+class SampledSeats {
+public:
+    SampledSeats(std::vector<std::shared_ptr<PlayerStrategy>> strategies, unsigned target, unsigned decision,
+                 int forced)
+        : inner(std::move(strategies)), target(target), decision(decision), forced(forced) {}
+
+    void begin(const std::vector<CardSet<1>>& hands, const CardSet<1>& opening) {
+        inner.begin(hands, opening);
+        table = opening.word(0);
+    }
+
+    int choose(uint64_t player, const CardSet<1>& hand, const CardSet<1>& playable) {
+        if (player != target || seen++ != decision) return inner.choose(player, hand, playable);
+        reached = true;
+        key = OpeningBook::key(hand.word(0), table, order);
+        options = playable.word(0);
+        chosen = forced >= 0 ? forced : inner.choose(player, hand, playable);
+        return chosen;
+    }
+
+    void played(uint64_t player, int card) {
+        table |= 1ull << card;
+        inner.played(player, card);
+    }
+
+    void passed(uint64_t player) { inner.passed(player); }
+
+    bool reached = false;
+    uint32_t key = 0;
+    std::array<int, 4> order{};
+    uint64_t options = 0;
+    int chosen = -1;
+
+private:
+    StrategySeats<1> inner;
+    unsigned target;
+    unsigned decision;
+    int forced;
+    unsigned seen = 0;
+    uint64_t table = 0;
+};
+
+} // namespace
+
+OpeningBookStats buildOpeningBook(const std::string& path, const OpeningBookConfig& cfg) {
+    if (cfg.specs.empty()) throw std::invalid_argument("Il faut au moins une stratégie");
+    if (cfg.players < 2 || cfg.players > 8) {
+        throw std::invalid_argument("Nombre de joueurs invalide (2 à 8) : " + std::to_string(cfg.players));
+    }
+    if (cfg.depth < 1) throw std::invalid_argument("La profondeur doit être d'au moins une décision");
+
+    std::vector<StrategyFactory> factories;
+    for (const std::string& spec : cfg.specs) factories.emplace_back(spec);
+    RulesConfig rules;
+    rules.players = cfg.players;
+    rules.validate();
+
+    // One round of deal d, `forced` played at the target's decision-th decision
+    auto rollout = [&](uint64_t d, unsigned decision, int forced, uint64_t& left) {
+        std::vector<std::shared_ptr<PlayerStrategy>> seats;
+        for (unsigned p = 0; p < cfg.players; ++p) {
+            seats.push_back(factories[p % factories.size()].create(MatchRunner::deriveSeed(cfg.seed, d, 1 + p)));
+        }
+        SampledSeats sampled(std::move(seats), static_cast<unsigned>(d % cfg.players), decision, forced);
+        VariantGame<1> game(rules);   // fresh pack order: the same seed deals the same cards
+        std::mt19937_64 rng(MatchRunner::deriveSeed(cfg.seed, d, 0));
+        left = game.play(sampled, rng)[d % cfg.players];
+        return sampled;
+    };
+
+    BookStats stats;
+    OpeningBookStats totals;
+    std::mutex merge;
+
+    WorkScheduler scheduler(0, cfg.deals, cfg.threads);
+    scheduler.run([&](WorkScheduler::Tasks& tasks) {
+        BookStats local;
+        uint64_t decisions = 0, rollouts = 0;
+        for (uint64_t d; tasks.next(d);) {
+            for (unsigned k = 0; k < cfg.depth; ++k) {
+                uint64_t left;
+                SampledSeats base = rollout(d, k, -1, left);
+                ++rollouts;
+                if (!base.reached) break;
+                ++decisions;
+
+                auto& moves = local[base.key];
+                for (unsigned m = 0; m < OpeningBook::kMoves; ++m) {
+                    const int card = OpeningBook::moveCard(m, base.order);
+                    if (!((base.options >> card) & 1)) continue;
+                    uint64_t cardsLeft = left;
+                    if (card != base.chosen) {
+                        rollout(d, k, card, cardsLeft);
+                        ++rollouts;
+                    }
+                    moves[m].cardsLeft += cardsLeft;
+                    moves[m].samples++;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(merge);
+        for (const auto& [key, moves] : local) {
+            auto& into = stats[key];
+            for (unsigned m = 0; m < OpeningBook::kMoves; ++m) {
+                into[m].cardsLeft += moves[m].cardsLeft;
+                into[m].samples += moves[m].samples;
+            }
+        }
+        totals.decisions += decisions;
+        totals.rollouts += rollouts;
+    });
+
+    // Fewest cards left on average, among the moves tried often enough
+    std::vector<unsigned char> book(size_t(1) << OpeningBook::kKeyBits, OpeningBook::kNoMove);
+    for (const auto& [key, moves] : stats) {
+        int best = -1;
+        for (unsigned m = 0; m < OpeningBook::kMoves; ++m) {
+            const MoveStats& s = moves[m];
+            if (s.samples < cfg.minSamples) continue;
+            if (best < 0 || s.cardsLeft * moves[best].samples < moves[best].cardsLeft * s.samples) best = static_cast<int>(m);
+        }
+        if (best >= 0) {
+            book[key] = static_cast<unsigned char>(best);
+            totals.keys++;
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Impossible d'écrire le livre d'ouvertures : " + path);
+    unsigned char header[OpeningBook::kHeaderSize] = {};
+    auto put = [&](size_t at, uint64_t v, size_t bytes) {
+        for (size_t i = 0; i < bytes; ++i) header[at + i] = static_cast<unsigned char>(v >> (8 * i));
+    };
+    std::memcpy(header, "SVNSBOOK", 8);
+    put(8, OpeningBook::kVersion, 4);
+    put(12, cfg.players, 4);
+    put(16, cfg.depth, 4);
+    put(24, cfg.deals, 8);
+    put(32, totals.keys, 8);
+    put(40, cfg.seed, 8);
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(book.data()), static_cast<std::streamsize>(book.size()));
+    out.flush();
+    if (!out) throw std::runtime_error("Impossible d'écrire le livre d'ouvertures : " + path);
+    return totals;
+}
+
+} // namespace sevens
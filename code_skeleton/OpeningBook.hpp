@@ -0,0 +1,211 @@
+#pragma once
+
+#include "SevensRules.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Opening book: the best of the first moves of a round, learned by simulation (mode
+ * `book`) and read by the strategies from a memory-mapped file.
+ *
+ * A decision is abstracted to 6 bits per suit (only the four suits of the 52-card game):
+ *   bits 0-1  suit length (0-1, 2-3, 4-5, 6+ cards)
+ *   bits 2-4  6, 7, 8 of the suit held
+ *   bit  5    7 of the suit on the table
+ * The abstraction does not tell suits apart, so the key lists the four digits in increasing
+ * order (suit symmetry, 24 times fewer keys to learn). The book answers with one of the 12
+ * cards "6, 7 or 8 of the i-th suit of the key" (all of them are playable or not for every
+ * hand of a key). The 24-bit key indexes a flat array:
+ *
+ *   0   header  "SVNSBOOK", u32 version, u32 players, u32 depth (decisions covered per
+ *               round), u32 reserved, u64 deals simulated, u64 keys answered, u64 seed
+ *               (padded to 64 bytes)
+ *   64  moves   2^24 bytes: i * 3 + rank - 6, or kNoMove
+ *
+ * Header-only, like ScratchArena: every strategy .so gets its own copy. The book in use is
+ * process-wide (activate(), before the games start); a .so strategy exports
+ *   extern "C" void useOpeningBook(const char* path);
+ * which StrategyFactory::useOpeningBook() calls.
+ */
+class OpeningBook {
+public:
+    static constexpr uint32_t kVersion = 1;
+    static constexpr unsigned kKeyBits = 24;
+    static constexpr size_t kHeaderSize = 64;
+    static constexpr uint8_t kNoMove = 0xFF;
+    static constexpr unsigned kMoves = 12;
+
+    // Maps the file read-only; throws std::runtime_error when it is not a valid book
+    explicit OpeningBook(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Livre d'ouvertures introuvable : " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != kHeaderSize + (size_t(1) << kKeyBits)) {
+            ::close(fd);
+            throw std::runtime_error("Livre d'ouvertures invalide : " + path);
+        }
+        mapSize = static_cast<size_t>(st.st_size);
+        map = ::mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            map = nullptr;
+            throw std::runtime_error("Impossible de projeter le livre d'ouvertures en mémoire : " + path);
+        }
+        const unsigned char* h = static_cast<const unsigned char*>(map);
+        if (std::memcmp(h, "SVNSBOOK", 8) != 0 || read32(h + 8) != kVersion) {
+            ::munmap(map, mapSize);
+            map = nullptr;
+            throw std::runtime_error("Livre d'ouvertures " + path + " : format inconnu");
+        }
+        nPlayers = read32(h + 12);
+        nDepth = read32(h + 16);
+        moves = h + kHeaderSize;
+    }
+
+    ~OpeningBook() {
+        if (map) ::munmap(map, mapSize);
+    }
+
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    unsigned players() const { return nPlayers; }
+    unsigned depth() const { return nDepth; }
+
+    // Opening hand sizes of the book's player count (51 cards dealt)
+    bool dealtFor(size_t openingHandSize) const {
+        return nPlayers && (openingHandSize == 51 / nPlayers || openingHandSize == (51 + nPlayers - 1) / nPlayers);
+    }
+
+    /**
+     * Key of a decision; hand and table as card masks (bit suit * 13 + rank - 1).
+     * order[i] = the suit that comes i-th in the key.
+     */
+    static uint32_t key(uint64_t hand, uint64_t table, std::array<int, 4>& order) {
+        unsigned digits[4];
+        for (unsigned s = 0; s < 4; ++s) {
+            const unsigned held = static_cast<unsigned>(hand >> (13 * s)) & 0x1FFF;
+            const unsigned length = static_cast<unsigned>(__builtin_popcount(held));
+            digits[s] = (length >= 6 ? 3 : length / 2) | ((held >> 5) & 7) << 2 |
+                        static_cast<unsigned>((table >> (13 * s + 6)) & 1) << 5;
+        }
+        for (int s = 0; s < 4; ++s) {
+            int i = s;
+            while (i > 0 && digits[order[i - 1]] > digits[s]) {
+                order[i] = order[i - 1];
+                --i;
+            }
+            order[i] = s;
+        }
+        uint32_t k = 0;
+        for (unsigned i = 0; i < 4; ++i) k |= digits[order[i]] << (6 * i);
+        return k;
+    }
+
+    // Card id of move m for a key's suit order
+    static int moveCard(unsigned m, const std::array<int, 4>& order) { return order[m / 3] * 13 + 5 + m % 3; }
+
+    uint8_t move(uint32_t key) const { return moves[key & ((1u << kKeyBits) - 1)]; }
+
+    /**
+     * Index in hand of the book move, -1 when the book has none for this decision (or the
+     * game is not the 52-card one).
+     */
+    int choose(const std::vector<Card>& hand, const TableLayout& table) const {
+        uint64_t held = 0, onTable = 0;
+        for (const Card& c : hand) {
+            if (c.suit < 0 || c.suit > 3) return -1;
+            held |= 1ull << (c.suit * 13 + c.rank - 1);
+        }
+        for (int s = 0; s < 4; ++s) {
+            auto row = table.find(s);
+            if (row == table.end()) continue;
+            for (const auto& [rank, on] : row->second) {
+                if (on && rank >= 1 && rank <= 13) onTable |= 1ull << (s * 13 + rank - 1);
+            }
+        }
+        std::array<int, 4> order;
+        const uint8_t m = move(key(held, onTable, order));
+        if (m >= kMoves) return -1;
+        const int id = moveCard(m, order);
+        const Card c{id / 13, id % 13 + 1};
+        for (size_t i = 0; i < hand.size(); ++i) {
+            if (hand[i].suit == c.suit && hand[i].rank == c.rank) return isPlayable(c, table) ? static_cast<int>(i) : -1;
+        }
+        return -1;
+    }
+
+    // Book of the process (null when none); set before the strategies are created
+    static std::shared_ptr<const OpeningBook> active() {
+        std::lock_guard<std::mutex> lock(state().mutex);
+        return state().book;
+    }
+
+    static void activate(const std::string& path) {
+        auto book = path.empty() ? nullptr : std::make_shared<const OpeningBook>(path);
+        std::lock_guard<std::mutex> lock(state().mutex);
+        state().book = std::move(book);
+    }
+
+private:
+    struct Active {
+        std::mutex mutex;
+        std::shared_ptr<const OpeningBook> book;
+    };
+
+    static Active& state() {
+        static Active s;
+        return s;
+    }
+
+    static uint32_t read32(const unsigned char* at) {
+        return uint32_t(at[0]) | uint32_t(at[1]) << 8 | uint32_t(at[2]) << 16 | uint32_t(at[3]) << 24;
+    }
+
+    void* map = nullptr;
+    size_t mapSize = 0;
+    const unsigned char* moves = nullptr;
+    unsigned nPlayers = 0;
+    unsigned nDepth = 0;
+};
+
+/**
+ * Simulation behind a book (mode `book`): in deal d, seat d % players is followed for its
+ * first `depth` decisions. At each one, every book move it could play (6, 7, 8 of a suit)
+ * is tried on the same deal with the same strategy seeds, the rest of the round played
+ * by the strategies, and its cards left at the end are summed per key and move. Deals
+ * run in parallel; sums are integers, so the book does not depend on the thread count.
+ */
+struct OpeningBookConfig {
+    std::vector<std::string> specs;   // seat p plays specs[p % specs.size()]
+    unsigned players = 4;
+    uint64_t deals = 100000;
+    unsigned depth = 1;
+    unsigned threads = 0;             // 0 = std::thread::hardware_concurrency()
+    uint64_t seed = 0;
+    uint64_t minSamples = 8;          // per move, below that the key gets no answer
+};
+
+struct OpeningBookStats {
+    uint64_t decisions = 0;           // decisions sampled
+    uint64_t rollouts = 0;
+    uint64_t keys = 0;                // keys answered in the book
+};
+
+OpeningBookStats buildOpeningBook(const std::string& path, const OpeningBookConfig& cfg);
+
+} // namespace sevens
@@ -33,7 +33,63 @@ public:
     virtual std::string getName() const = 0;
 };
 
+/**
+ * Optional extension for search strategies: think while the others play (batch --ponder).
+ *
+ * The engine gives every pondering seat a thread of its own. While another seat decides,
+ * it calls startPondering() on that thread: the strategy searches the positions it expects
+ * (its own hand and the table as last notified) until stopPondering() is called from the
+ * engine thread, then returns (it may return earlier when there is nothing to search). Before any other call to the strategy (initialize,
+ * selectCardToPlay, observeMove, observePass) the engine calls stopPondering() and waits
+ * for startPondering() to return, so the two never run at the same time and the search
+ * results can be kept in plain members for the next selectCardToPlay.
+ * stopPondering() may come before the search has started: keep the stop request until
+ * startPondering() returns (clear the flag on the way out, not on the way in).
+ * The CPU time spent pondering is counted apart from the decisions.
+ */
+class PonderingStrategy : public PlayerStrategy {
+public:
+    virtual void startPondering() = 0;
+    virtual void stopPondering() = 0;
+};
+
 // Type for strategy factory functions (for dynamic loading)
 typedef PlayerStrategy* (*CreateStrategyFn)();
 
+// Optional export for reproducible runs (detected by StrategyLoader):
+//   extern "C" void seedStrategy(sevens::PlayerStrategy* strategy, uint64_t seed);
+// re-seeds the random generator of an instance returned by createStrategy().
+typedef void (*SeedStrategyFn)(PlayerStrategy*, uint64_t);
+
+// Optional export (Sentinel7, CalculativeStrategy):
+//   extern "C" void useOpeningBook(const char* path);
+// maps an opening book (OpeningBook.hpp) for every instance created afterwards ("" = none).
+typedef void (*UseOpeningBookFn)(const char*);
+
+// One move of the round so far: the card played, or a pass (card.suit = -1)
+struct MoveEvent {
+    uint64_t playerID;
+    Card card;
+};
+
+// A decision of one game, as handed to selectCardsBatch
+struct DecisionRequest {
+    PlayerStrategy* strategy;                 // instance seated in that game (created by createStrategy)
+    uint64_t playerID;
+    const std::vector<Card>* hand;
+    const TableLayout* table;
+    const int* legal;                         // indices in hand of the playable cards
+    size_t legalCount;
+    const MoveEvent* history;                 // moves and passes of the round, oldest first
+    size_t historySize;
+};
+
+// Optional export (LearnedStrategy), detected by StrategyLoader:
+//   extern "C" void selectCardsBatch(const sevens::DecisionRequest* requests, int* choices, size_t count);
+// answers count decisions of independent games at once: choices[i] is what
+// requests[i].strategy->selectCardToPlay(*hand, *table) would return. The runners use it
+// when several games wait on the strategy (batch --interleave); the instances still receive
+// every initialize / observeMove / observePass, so both entry points can be mixed.
+typedef void (*SelectCardsBatchFn)(const DecisionRequest*, int*, size_t);
+
 } // namespace sevens
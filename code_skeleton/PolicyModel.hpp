@@ -0,0 +1,351 @@
+#pragma once
+
+#include "Features.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sevens {
+
+/**
+ * Move scoring model over the standard feature vector (Features.hpp): a linear model, or an
+ * MLP with one ReLU hidden layer. A move's score is computed on the kInputs floats of
+ * [state, move]; the policy plays the best-scored playable card.
+ *
+ * The state half of the first layer is computed once per decision and only the 16 move
+ * inputs per candidate, with SSE2 (4 hidden units per instruction). A quantized model keeps
+ * the first layer in int8 (one scale for the layer) and runs it on 16-bit integer
+ * multiply-adds, two inputs per instruction; the rest stays in float. Its weights are
+ * int8 in the file but held widened to int16 in memory, the operand of pmaddwd (SSE2 has
+ * no int8 multiply-add); each move's accumulators then stay in registers, which makes it
+ * faster than the float layer from 32 hidden units on (sevens_bench policy/choose).
+ *
+ * File (little-endian, written by `train`):
+ *   0   header  "SVNSMODL", u32 version, u32 kind (0 linear, 1 MLP), u32 inputs (kInputs),
+ *               u32 hidden units (0 for linear), u32 quantized, f32 int8 scale of the first
+ *               layer (padded to 64 bytes)
+ *   64  first layer  inputs x hidden, by input (linear: inputs weights), f32 or int8
+ *       then   f32 b1[hidden], f32 w2[hidden], f32 b2
+ *
+ * Header-only, like OpeningBook: every strategy .so gets its own copy.
+ */
+class PolicyModel {
+public:
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kHeaderSize = 64;
+    static constexpr unsigned kMaxHidden = 256;
+    static constexpr float kInputScale = 64.0f;   // inputs as int16 in the quantized layer
+
+    // Linear model (hidden == 0, w1 has kInputs weights) or MLP (w1 is kInputs x hidden)
+    PolicyModel(unsigned hidden, std::vector<float> w1, std::vector<float> b1, std::vector<float> w2, float b2,
+                bool quantize = false)
+        : nHidden(hidden), w1(std::move(w1)), b1(std::move(b1)), w2(std::move(w2)), b2(b2) {
+        check();
+        if (quantize) this->quantize();
+    }
+
+    // Reads a model file; throws std::runtime_error when it is missing or invalid
+    explicit PolicyModel(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("Modèle introuvable : " + path);
+        unsigned char h[kHeaderSize];
+        if (!in.read(reinterpret_cast<char*>(h), sizeof(h)) || std::memcmp(h, "SVNSMODL", 8) != 0 ||
+            read32(h + 8) != kVersion || read32(h + 16) != Features::kInputs) {
+            throw std::runtime_error("Modèle " + path + " : format inconnu");
+        }
+        const bool mlp = read32(h + 12) == 1;
+        nHidden = mlp ? read32(h + 20) : 0;
+        const bool quantized = read32(h + 24) != 0;
+        const uint32_t scaleBits = read32(h + 28);
+        if (mlp && (nHidden == 0 || nHidden > kMaxHidden || nHidden % 4)) {
+            throw std::runtime_error("Modèle " + path + " : couche cachée invalide");
+        }
+
+        const size_t first = static_cast<size_t>(Features::kInputs) * (mlp ? nHidden : 1);
+        w1.assign(first, 0.0f);
+        if (quantized && mlp) {
+            std::vector<int8_t> q(first);
+            in.read(reinterpret_cast<char*>(q.data()), static_cast<std::streamsize>(q.size()));
+            std::memcpy(&w1Scale, &scaleBits, sizeof(w1Scale));
+            for (size_t i = 0; i < first; ++i) w1[i] = q[i] / w1Scale;
+        } else {
+            readFloats(in, w1.data(), first);
+        }
+        b1.assign(nHidden, 0.0f);
+        w2.assign(nHidden, 0.0f);
+        readFloats(in, b1.data(), nHidden);
+        readFloats(in, w2.data(), nHidden);
+        readFloats(in, &b2, 1);
+        if (!in) throw std::runtime_error("Modèle " + path + " : fichier tronqué");
+        if (quantized && mlp) quantize();
+    }
+
+    unsigned hidden() const { return nHidden; }
+    bool quantized() const { return !w1q.empty(); }
+    const std::vector<float>& firstLayer() const { return w1; }
+    const std::vector<float>& hiddenBias() const { return b1; }
+    const std::vector<float>& outputLayer() const { return w2; }
+    float outputBias() const { return b2; }
+
+    /**
+     * Scores of n moves laid out as by Features::decision (the state is read from the
+     * first row only).
+     */
+    void score(const float* inputs, unsigned n, float* out) const {
+        if (nHidden == 0) {
+            float base = 0.0f;
+            for (unsigned i = 0; i < Features::kState; ++i) base += w1[i] * inputs[i];
+            for (unsigned k = 0; k < n; ++k) {
+                const float* m = inputs + k * Features::kInputs + Features::kState;
+                float s = base;
+                for (unsigned i = 0; i < Features::kMove; ++i) s += w1[Features::kState + i] * m[i];
+                out[k] = s;
+            }
+            return;
+        }
+
+        alignas(16) float base[kMaxHidden];
+        alignas(16) float z[kMaxHidden];
+        if (quantized()) {
+            // State half once per decision, dequantized with the bias into base; then per
+            // move, its non-zero input pairs summed in registers, 4 hidden units at a time
+            alignas(16) int32_t acc[kMaxHidden];
+            std::fill(acc, acc + nHidden, 0);
+            accumulateQ(inputs, 0, Features::kState / 2, acc);
+            const float dequant = 1.0f / (kInputScale * w1Scale);
+            for (unsigned j = 0; j < nHidden; ++j) base[j] = static_cast<float>(acc[j]) * dequant + b1[j];
+            for (unsigned k = 0; k < n; ++k) {
+                const float* x = inputs + k * Features::kInputs;
+                uint32_t xs[Features::kMove / 2];
+                const int16_t* ws[Features::kMove / 2];
+                unsigned m = 0;
+                for (unsigned pair = Features::kState / 2; pair < Features::kInputs / 2; ++pair) {
+                    const int16_t x0 = toInt16(x[2 * pair]), x1 = toInt16(x[2 * pair + 1]);
+                    if ((x0 | x1) == 0) continue;
+                    xs[m] = static_cast<uint16_t>(x0) | static_cast<uint32_t>(static_cast<uint16_t>(x1)) << 16;
+                    ws[m++] = &w1q[static_cast<size_t>(pair) * nHidden * 2];
+                }
+#if defined(__SSE2__)
+                __m128i xp[Features::kMove / 2];
+                for (unsigned t = 0; t < m; ++t) xp[t] = _mm_set1_epi32(static_cast<int32_t>(xs[t]));
+                const __m128 dq = _mm_set1_ps(dequant);
+                const __m128 zero = _mm_setzero_ps();
+                __m128 sum = zero;
+                for (unsigned j = 0; j < nHidden; j += 4) {
+                    __m128i a = _mm_setzero_si128();
+                    for (unsigned t = 0; t < m; ++t) {
+                        a = _mm_add_epi32(a, _mm_madd_epi16(xp[t], _mm_loadu_si128(reinterpret_cast<const __m128i*>(ws[t] + 2 * j))));
+                    }
+                    const __m128 zj = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(a), dq), _mm_load_ps(base + j));
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&w2[j]), _mm_max_ps(zj, zero)));
+                }
+                alignas(16) float lanes[4];
+                _mm_store_ps(lanes, sum);
+                out[k] = b2 + (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+                for (unsigned j = 0; j < nHidden; ++j) {
+                    int32_t a = 0;
+                    for (unsigned t = 0; t < m; ++t) {
+                        a += static_cast<int16_t>(xs[t]) * ws[t][2 * j] + static_cast<int16_t>(xs[t] >> 16) * ws[t][2 * j + 1];
+                    }
+                    z[j] = static_cast<float>(a) * dequant + base[j];
+                }
+                out[k] = output(z);
+#endif
+            }
+            return;
+        }
+
+        std::copy(b1.begin(), b1.end(), base);
+        accumulate(inputs, 0, Features::kState, base);
+        for (unsigned k = 0; k < n; ++k) {
+            std::copy(base, base + nHidden, z);
+            accumulate(inputs + k * Features::kInputs, Features::kState, Features::kInputs, z);
+            out[k] = output(z);
+        }
+    }
+
+    // Best-scored playable card of a decision (card id), -1 when nothing is playable
+    int choose(const FeatureInput& in) const {
+        alignas(16) float inputs[Features::kMaxMoves * Features::kInputs];
+        int cards[Features::kMaxMoves];
+        float scores[Features::kMaxMoves];
+        const unsigned n = Features::decision(in, inputs, cards);
+        if (n == 0) return -1;
+        if (n == 1) return cards[0];
+        score(inputs, n, scores);
+        return cards[std::max_element(scores, scores + n) - scores];
+    }
+
+    void save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("Impossible d'écrire le modèle : " + path);
+        unsigned char h[kHeaderSize] = {};
+        std::memcpy(h, "SVNSMODL", 8);
+        write32(h + 8, kVersion);
+        write32(h + 12, nHidden ? 1 : 0);
+        write32(h + 16, Features::kInputs);
+        write32(h + 20, nHidden);
+        write32(h + 24, quantized() ? 1 : 0);
+        uint32_t scaleBits;
+        std::memcpy(&scaleBits, &w1Scale, sizeof(scaleBits));
+        write32(h + 28, scaleBits);
+        out.write(reinterpret_cast<const char*>(h), sizeof(h));
+        if (quantized()) {
+            std::vector<int8_t> q(w1.size());
+            for (size_t i = 0; i < w1.size(); ++i) q[i] = quantizeWeight(w1[i]);
+            out.write(reinterpret_cast<const char*>(q.data()), static_cast<std::streamsize>(q.size()));
+        } else {
+            out.write(reinterpret_cast<const char*>(w1.data()), static_cast<std::streamsize>(w1.size() * sizeof(float)));
+        }
+        out.write(reinterpret_cast<const char*>(b1.data()), static_cast<std::streamsize>(b1.size() * sizeof(float)));
+        out.write(reinterpret_cast<const char*>(w2.data()), static_cast<std::streamsize>(w2.size() * sizeof(float)));
+        out.write(reinterpret_cast<const char*>(&b2), sizeof(b2));
+        if (!out) throw std::runtime_error("Impossible d'écrire le modèle : " + path);
+    }
+
+    // One model per path and per process, read on first use (null when it cannot be read)
+    static std::shared_ptr<const PolicyModel> shared(const std::string& path) {
+        static std::mutex mutex;
+        static std::map<std::string, std::shared_ptr<const PolicyModel>> models;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = models.find(path);
+        if (it == models.end()) {
+            std::shared_ptr<const PolicyModel> model;
+            try {
+                model = std::make_shared<const PolicyModel>(path);
+            } catch (const std::exception& e) {
+                std::cerr << "[PolicyModel] " << e.what() << '\n';
+            }
+            it = models.emplace(path, std::move(model)).first;
+        }
+        return it->second;
+    }
+
+private:
+    void check() const {
+        if (nHidden > kMaxHidden || nHidden % 4) throw std::invalid_argument("Couche cachée invalide (multiple de 4, 256 au plus)");
+        const size_t first = static_cast<size_t>(Features::kInputs) * (nHidden ? nHidden : 1);
+        if (w1.size() != first || b1.size() != nHidden || w2.size() != nHidden) {
+            throw std::invalid_argument("Dimensions du modèle incohérentes");
+        }
+    }
+
+    // First layer in int8 (scale = 127 / largest weight), as 16-bit pairs of consecutive
+    // inputs for each hidden unit: w1q[(pair * hidden + j) * 2 + 0/1]
+    void quantize() {
+        if (nHidden == 0) return;
+        float largest = 0.0f;
+        for (float w : w1) largest = std::max(largest, std::fabs(w));
+        w1Scale = largest > 0.0f ? 127.0f / largest : 1.0f;
+        w1q.assign(w1.size(), 0);
+        for (unsigned pair = 0; pair < Features::kInputs / 2; ++pair) {
+            for (unsigned j = 0; j < nHidden; ++j) {
+                w1q[(pair * nHidden + j) * 2] = quantizeWeight(w1[(2 * pair) * nHidden + j]);
+                w1q[(pair * nHidden + j) * 2 + 1] = quantizeWeight(w1[(2 * pair + 1) * nHidden + j]);
+            }
+        }
+        // What the int8 model computes, for the float readers (firstLayer(), save())
+        for (float& w : w1) w = quantizeWeight(w) / w1Scale;
+    }
+
+    int8_t quantizeWeight(float w) const {
+        return static_cast<int8_t>(std::max(-127.0f, std::min(127.0f, std::nearbyint(w * w1Scale))));
+    }
+
+    // h[j] += sum over inputs i in [from, to) of x[i] * w1[i][j]
+    void accumulate(const float* x, unsigned from, unsigned to, float* h) const {
+        for (unsigned i = from; i < to; ++i) {
+            if (x[i] == 0.0f) continue;   // most inputs of a decision are 0
+            const float* w = &w1[static_cast<size_t>(i) * nHidden];
+#if defined(__SSE2__)
+            const __m128 xi = _mm_set1_ps(x[i]);
+            for (unsigned j = 0; j < nHidden; j += 4) {
+                _mm_store_ps(h + j, _mm_add_ps(_mm_load_ps(h + j), _mm_mul_ps(xi, _mm_loadu_ps(w + j))));
+            }
+#else
+            for (unsigned j = 0; j < nHidden; ++j) h[j] += x[i] * w[j];
+#endif
+        }
+    }
+
+    // Same on the int8 layer, inputs rounded to int16 (x * kInputScale), pairs [from, to)
+    void accumulateQ(const float* x, unsigned from, unsigned to, int32_t* acc) const {
+        for (unsigned pair = from; pair < to; ++pair) {
+            const int16_t x0 = toInt16(x[2 * pair]), x1 = toInt16(x[2 * pair + 1]);
+            if ((x0 | x1) == 0) continue;
+            const int16_t* w = &w1q[static_cast<size_t>(pair) * nHidden * 2];
+#if defined(__SSE2__)
+            const __m128i xp = _mm_set1_epi32(static_cast<int32_t>(static_cast<uint16_t>(x0) |
+                                                                   static_cast<uint32_t>(static_cast<uint16_t>(x1)) << 16));
+            for (unsigned j = 0; j < nHidden; j += 4) {
+                const __m128i wj = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + 2 * j));
+                __m128i* a = reinterpret_cast<__m128i*>(acc + j);
+                _mm_store_si128(a, _mm_add_epi32(_mm_load_si128(a), _mm_madd_epi16(xp, wj)));
+            }
+#else
+            for (unsigned j = 0; j < nHidden; ++j) acc[j] += x0 * w[2 * j] + x1 * w[2 * j + 1];
+#endif
+        }
+    }
+
+    // Rounded to nearest by hand: std::nearbyint is a library call without SSE4.1
+    static int16_t toInt16(float x) {
+        const float v = std::max(-32767.0f, std::min(32767.0f, x * kInputScale));
+        return static_cast<int16_t>(v + (v < 0.0f ? -0.5f : 0.5f));
+    }
+
+    // b2 + sum of w2[j] * relu(z[j])
+    float output(const float* z) const {
+#if defined(__SSE2__)
+        const __m128 zero = _mm_setzero_ps();
+        __m128 sum = zero;
+        for (unsigned j = 0; j < nHidden; j += 4) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&w2[j]), _mm_max_ps(_mm_load_ps(z + j), zero)));
+        }
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, sum);
+        return b2 + (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+        float s = b2;
+        for (unsigned j = 0; j < nHidden; ++j) s += w2[j] * std::max(0.0f, z[j]);
+        return s;
+#endif
+    }
+
+    static uint32_t read32(const unsigned char* at) {
+        return uint32_t(at[0]) | uint32_t(at[1]) << 8 | uint32_t(at[2]) << 16 | uint32_t(at[3]) << 24;
+    }
+
+    static void write32(unsigned char* at, uint32_t v) {
+        for (int i = 0; i < 4; ++i) at[i] = static_cast<unsigned char>(v >> (8 * i));
+    }
+
+    static void readFloats(std::ifstream& in, float* to, size_t n) {
+        in.read(reinterpret_cast<char*>(to), static_cast<std::streamsize>(n * sizeof(float)));
+    }
+
+    unsigned nHidden = 0;
+    std::vector<float> w1;        // kInputs x hidden, by input (linear: kInputs)
+    std::vector<float> b1;
+    std::vector<float> w2;
+    float b2 = 0.0f;
+    std::vector<int16_t> w1q;     // quantized first layer (int8 values), empty for a float model
+    float w1Scale = 1.0f;
+};
+
+} // namespace sevens
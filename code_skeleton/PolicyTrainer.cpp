@@ -0,0 +1,198 @@
+#include "PolicyTrainer.hpp"
+#include "SelfPlay.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace sevens {
+
+namespace {
+
+/**
+ * Weights being trained, in the PolicyModel layout (w1 by input), and the forward /
+ * backward pass of one decision.
+ */
+class Network {
+public:
+    Network(unsigned hidden, std::mt19937_64& rng)
+        : hidden(hidden), w1(Features::kInputs * (hidden ? hidden : 1)), b1(hidden), w2(hidden) {
+        if (hidden == 0) return;   // linear: starts from 0
+        std::uniform_real_distribution<float> first(-1.0f, 1.0f), second(-1.0f, 1.0f);
+        const float r1 = std::sqrt(6.0f / (Features::kInputs + hidden)), r2 = std::sqrt(6.0f / (hidden + 1));
+        for (float& w : w1) w = first(rng) * r1;
+        for (float& w : w2) w = second(rng) * r2;
+    }
+
+    // Scores of the n moves; keeps the hidden activations for backward()
+    void forward(const float* inputs, unsigned n, float* out) {
+        for (unsigned k = 0; k < n; ++k) {
+            const float* x = inputs + k * Features::kInputs;
+            if (hidden == 0) {
+                float s = 0.0f;
+                for (unsigned i = 0; i < Features::kInputs; ++i) s += w1[i] * x[i];
+                out[k] = s;
+                continue;
+            }
+            float* z = &zs[k * PolicyModel::kMaxHidden];
+            std::copy(b1.begin(), b1.end(), z);
+            for (unsigned i = 0; i < Features::kInputs; ++i) {
+                if (x[i] == 0.0f) continue;
+                const float* w = &w1[static_cast<size_t>(i) * hidden];
+                for (unsigned j = 0; j < hidden; ++j) z[j] += x[i] * w[j];
+            }
+            float s = b2;
+            for (unsigned j = 0; j < hidden; ++j) s += w2[j] * std::max(0.0f, z[j]);
+            out[k] = s;
+        }
+    }
+
+    // SGD step for d(loss)/d(score k) = grad[k]
+    void backward(const float* inputs, unsigned n, const float* grad, float lr) {
+        for (unsigned k = 0; k < n; ++k) {
+            const float g = grad[k] * lr;
+            if (g == 0.0f) continue;
+            const float* x = inputs + k * Features::kInputs;
+            if (hidden == 0) {
+                for (unsigned i = 0; i < Features::kInputs; ++i) w1[i] -= g * x[i];
+                continue;
+            }
+            const float* z = &zs[k * PolicyModel::kMaxHidden];
+            float dz[PolicyModel::kMaxHidden];
+            for (unsigned j = 0; j < hidden; ++j) {
+                dz[j] = z[j] > 0.0f ? g * w2[j] : 0.0f;
+                w2[j] -= g * std::max(0.0f, z[j]);
+                b1[j] -= dz[j];
+            }
+            b2 -= g;
+            for (unsigned i = 0; i < Features::kInputs; ++i) {
+                if (x[i] == 0.0f) continue;
+                float* w = &w1[static_cast<size_t>(i) * hidden];
+                for (unsigned j = 0; j < hidden; ++j) w[j] -= x[i] * dz[j];
+            }
+        }
+    }
+
+    PolicyModel model(bool quantize) const {
+        return PolicyModel(hidden, w1, b1, w2, b2, quantize);
+    }
+
+private:
+    unsigned hidden;
+    std::vector<float> w1, b1, w2;
+    float b2 = 0.0f;
+    float zs[Features::kMaxMoves * PolicyModel::kMaxHidden];
+};
+
+// An example: two playable cards or more, a card played
+bool isExample(const SelfPlayRecord& r, int strategy) {
+    if (r.chosen == SelfPlayRecord::kPass || (r.legal & (r.legal - 1)) == 0) return false;
+    return strategy < 0 || r.strategy == strategy;
+}
+
+// Softmax of the scores into p; index of the card played in cards (n when absent)
+unsigned softmax(const float* scores, const int* cards, unsigned n, int chosen, float* p) {
+    const float top = *std::max_element(scores, scores + n);
+    float sum = 0.0f;
+    unsigned target = n;
+    for (unsigned k = 0; k < n; ++k) {
+        p[k] = std::exp(scores[k] - top);
+        sum += p[k];
+        if (cards[k] == chosen) target = k;
+    }
+    for (unsigned k = 0; k < n; ++k) p[k] /= sum;
+    return target;
+}
+
+} // namespace
+
+PolicyModel trainPolicy(const std::vector<std::string>& paths, const PolicyTrainerConfig& cfg,
+                        PolicyTrainerStats& stats, const std::function<void(const PolicyEpoch&)>& onEpoch) {
+    if (paths.empty()) throw std::invalid_argument("Il faut au moins un fragment de self-play");
+    if (cfg.hidden > PolicyModel::kMaxHidden || cfg.hidden % 4) {
+        throw std::invalid_argument("Couche cachée invalide (multiple de 4, 256 au plus) : " + std::to_string(cfg.hidden));
+    }
+    if (cfg.validationEvery == 0) throw std::invalid_argument("validationEvery doit être positif");
+
+    std::vector<std::unique_ptr<SelfPlayShard>> shards;
+    for (const std::string& path : paths) shards.push_back(std::make_unique<SelfPlayShard>(path));
+
+    // Examples of each shard, the held-out ones apart
+    std::vector<std::vector<uint32_t>> train(shards.size());
+    std::vector<const SelfPlayRecord*> held;
+    stats = PolicyTrainerStats{};
+    for (size_t s = 0; s < shards.size(); ++s) {
+        const SelfPlayShard& shard = *shards[s];
+        for (uint64_t i = 0; i < shard.size(); ++i) {
+            const SelfPlayRecord& r = shard[i];
+            if (!isExample(r, cfg.strategy)) continue;
+            if (r.game % cfg.validationEvery == 0) {
+                held.push_back(&r);
+            } else {
+                train[s].push_back(static_cast<uint32_t>(i));
+            }
+        }
+        stats.training += train[s].size();
+    }
+    stats.validation = held.size();
+    if (stats.training == 0) throw std::runtime_error("Aucune décision à apprendre dans les fragments");
+
+    std::mt19937_64 rng(cfg.seed);
+    auto net = std::make_unique<Network>(cfg.hidden, rng);
+    alignas(16) float inputs[Features::kMaxMoves * Features::kInputs];
+    int cards[Features::kMaxMoves];
+    float scores[Features::kMaxMoves], p[Features::kMaxMoves];
+
+    std::vector<size_t> order(shards.size());
+    std::iota(order.begin(), order.end(), 0);
+    for (unsigned epoch = 1; epoch <= cfg.epochs; ++epoch) {
+        PolicyEpoch report;
+        report.epoch = epoch;
+        double lossSum = 0.0, weightSum = 0.0;
+        std::shuffle(order.begin(), order.end(), rng);
+        for (size_t s : order) {
+            std::shuffle(train[s].begin(), train[s].end(), rng);
+            for (uint32_t i : train[s]) {
+                const SelfPlayRecord& r = (*shards[s])[i];
+                const unsigned n = Features::decision(FeatureInput::of(r), inputs, cards);
+                net->forward(inputs, n, scores);
+                const unsigned target = softmax(scores, cards, n, r.chosen, p);
+                if (target == n) continue;
+
+                const float weight = static_cast<float>(r.players - r.rank + 1) / r.players;
+                lossSum -= weight * std::log(std::max(1e-30f, p[target]));
+                for (unsigned k = 0; k < n; ++k) p[k] = weight * (p[k] - (k == target));
+                net->backward(inputs, n, p, static_cast<float>(cfg.learningRate));
+                weightSum += weight;
+                ++report.examples;
+            }
+        }
+        report.loss = weightSum > 0.0 ? lossSum / weightSum : 0.0;
+
+        uint64_t right = 0;
+        double heldLoss = 0.0;
+        for (const SelfPlayRecord* r : held) {
+            const unsigned n = Features::decision(FeatureInput::of(*r), inputs, cards);
+            net->forward(inputs, n, scores);
+            const unsigned target = softmax(scores, cards, n, r->chosen, p);
+            if (target == n) continue;
+            heldLoss -= std::log(std::max(1e-30f, p[target]));
+            right += cards[std::max_element(scores, scores + n) - scores] == r->chosen;
+        }
+        report.validationLoss = held.empty() ? 0.0 : heldLoss / held.size();
+        report.validationAccuracy = held.empty() ? 0.0 : static_cast<double>(right) / held.size();
+        if (onEpoch) onEpoch(report);
+    }
+
+    // Accuracy of what is saved, int8 layer included
+    PolicyModel model = net->model(cfg.quantize);
+    uint64_t right = 0;
+    for (const SelfPlayRecord* r : held) right += model.choose(FeatureInput::of(*r)) == r->chosen;
+    stats.accuracy = held.empty() ? 0.0 : static_cast<double>(right) / held.size();
+    return model;
+}
+
+} // namespace sevens
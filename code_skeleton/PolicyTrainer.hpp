@@ -0,0 +1,53 @@
+#pragma once
+
+#include "PolicyModel.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Offline training of a PolicyModel on self-play shards (mode `train`).
+ *
+ * Every decision with a choice (two playable cards or more, card played) is an example:
+ * softmax over the scores of the playable cards, cross-entropy towards the card that was
+ * played, weighted by how the game ended for the decider ((players - rank + 1) / players:
+ * the moves of the winners count most). Plain SGD, shards in random order and the records
+ * of a shard shuffled, one pass per epoch. The games with game % validationEvery == 0 are
+ * held out and give the loss and the accuracy (best-scored card == card played) of each
+ * epoch.
+ *
+ * Single-threaded: the records are read in place from the mapped shards.
+ */
+struct PolicyTrainerConfig {
+    unsigned hidden = 32;             // 0 = linear model
+    unsigned epochs = 4;
+    double learningRate = 0.05;
+    bool quantize = false;            // int8 first layer in the saved model
+    int strategy = -1;                // imitate this strategy index only, -1 = every decision
+    uint64_t seed = 0;
+    uint64_t validationEvery = 20;
+};
+
+struct PolicyEpoch {
+    unsigned epoch = 0;
+    uint64_t examples = 0;
+    double loss = 0.0;                // weighted training loss, mean over the epoch
+    double validationLoss = 0.0;
+    double validationAccuracy = 0.0;
+};
+
+struct PolicyTrainerStats {
+    uint64_t training = 0;            // examples per epoch
+    uint64_t validation = 0;
+    double accuracy = 0.0;            // validation accuracy of the returned model (quantized or not)
+};
+
+PolicyModel trainPolicy(const std::vector<std::string>& shards, const PolicyTrainerConfig& cfg,
+                        PolicyTrainerStats& stats,
+                        const std::function<void(const PolicyEpoch&)>& onEpoch = nullptr);
+
+} // namespace sevens
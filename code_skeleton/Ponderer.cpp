@@ -0,0 +1,83 @@
+#include "Ponderer.hpp"
+#include "PlayerStrategy.hpp"
+
+#include <time.h>
+
+namespace sevens {
+
+Ponderer::Ponderer() : thread(&Ponderer::loop, this) {}
+
+Ponderer::~Ponderer() {
+    pause();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        state = State::Quit;
+    }
+    changed.notify_all();
+    thread.join();
+}
+
+void Ponderer::attach(PonderingStrategy* s) {
+    std::lock_guard<std::mutex> lock(mutex);
+    strategy = s;
+}
+
+void Ponderer::resume() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!strategy || state != State::Idle) return;
+        state = State::Requested;
+    }
+    changed.notify_all();
+}
+
+void Ponderer::pause() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (state == State::Requested) state = State::Idle;   // not started: nothing to stop
+    if (state != State::Running) return;
+
+    // stopPondering may be slow or take locks of its own: not under ours
+    lock.unlock();
+    strategy->stopPondering();
+    lock.lock();
+    changed.wait(lock, [this] { return state != State::Running; });
+}
+
+uint64_t Ponderer::takeCpuNs() {
+    std::lock_guard<std::mutex> lock(mutex);
+    const uint64_t ns = cpuNs;
+    cpuNs = 0;
+    return ns;
+}
+
+uint64_t Ponderer::threadCpuNs() {
+    timespec ts;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void Ponderer::loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        changed.wait(lock, [this] { return state == State::Requested || state == State::Quit; });
+        if (state == State::Quit) return;
+        state = State::Running;
+        PonderingStrategy* s = strategy;
+        lock.unlock();
+
+        const uint64_t t0 = threadCpuNs();
+        try {
+            s->startPondering();
+        } catch (...) {
+            // a failed search only costs the seat its pondering: the decisions do not depend on it
+        }
+        const uint64_t t1 = threadCpuNs();
+
+        lock.lock();
+        cpuNs += t1 - t0;
+        state = State::Idle;
+        changed.notify_all();
+    }
+}
+
+} // namespace sevens
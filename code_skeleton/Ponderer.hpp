@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace sevens {
+
+class PonderingStrategy;
+
+/**
+ * Thread of a pondering seat (MyGameMapper::set_pondering): runs the seat's
+ * PonderingStrategy::startPondering() between resume() and pause().
+ *
+ * resume() only wakes the thread, the engine thread goes on with the decision of the seat
+ * to move. pause() calls stopPondering() and waits until startPondering() has returned, so
+ * once it is back the strategy belongs to the engine thread again. A resume() the thread
+ * has not picked up yet is cancelled without calling the strategy at all.
+ *
+ * The thread's CPU time (CLOCK_THREAD_CPUTIME_ID) is measured around startPondering() and
+ * summed until takeCpuNs(): pondering is accounted apart from the decisions, and the time
+ * the thread waits for the processor does not count.
+ */
+class Ponderer {
+public:
+    Ponderer();
+    ~Ponderer();   // pauses, then ends the thread
+
+    Ponderer(const Ponderer&) = delete;
+    Ponderer& operator=(const Ponderer&) = delete;
+
+    // Strategy pondered by resume(), nullptr = none; only while paused
+    void attach(PonderingStrategy* strategy);
+
+    void resume();
+    void pause();
+
+    // CPU time spent pondering since the last call
+    uint64_t takeCpuNs();
+
+    // CPU time of the calling thread
+    static uint64_t threadCpuNs();
+
+private:
+    enum class State { Idle, Requested, Running, Quit };
+
+    void loop();
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    State state = State::Idle;
+    PonderingStrategy* strategy = nullptr;
+    uint64_t cpuNs = 0;
+    std::thread thread;
+};
+
+} // namespace sevens
@@ -1,21 +1,15 @@
 #include "PlayerStrategy.hpp"
+#include "ScratchArena.hpp"
 #include <algorithm>
+#include <array>
 #include <vector>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <random>
 #include <chrono>
 
 namespace sevens {
 
-// Custom hash function for std::pair<uint64_t, uint64_t>
-struct PairHash {
-    std::size_t operator()(const std::pair<uint64_t, uint64_t>& p) const {
-        return std::hash<uint64_t>()(p.first) ^ (std::hash<uint64_t>()(p.second) << 1);
-    }
-};
-
 class PrudentStrategy : public PlayerStrategy {
 public:
     PrudentStrategy() {
@@ -29,15 +23,16 @@ public:
 
     void initialize(uint64_t playerID) override {
         myID = playerID;
-        playedCards.clear();
-        playerPassCount.clear();
+        playedCards.fill(0);
+        for (auto& [id, count] : playerPassCount) count = 0; // keep the nodes between games
     }
 
     int selectCardToPlay(
         const std::vector<Card>& hand,
         const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override 
     {
-        std::vector<std::pair<int, int>> scoredChoices; // (index in hand, score)
+        ScratchScope scratch; // per-call temporaries, no heap allocation
+        std::pmr::vector<std::pair<int, int>> scoredChoices(scratch.resource()); // (index in hand, score)
 
         for (size_t i = 0; i < hand.size(); ++i) {
             const Card& card = hand[i];
@@ -91,7 +86,7 @@ public:
 
     void observeMove(uint64_t playerID, const Card& playedCard) override {
         (void)playerID;
-        playedCards.insert({playedCard.suit, playedCard.rank});
+        if (playedCard.suit < 16) playedCards[playedCard.suit / 4] |= 1ull << (playedCard.suit % 4 * 13 + playedCard.rank - 1);
     }
 
     void observePass(uint64_t playerID) override {
@@ -102,19 +97,24 @@ public:
         return "PrudentStrategy";
     }
 
+    // Reproducible runs (see seedStrategy below)
+    void seed(uint64_t s) {
+        rng.seed(static_cast<std::mt19937::result_type>(s));
+    }
+
 private:
     uint64_t myID;
     std::mt19937 rng;
 
     // Data tracking
-    std::unordered_set<std::pair<uint64_t, uint64_t>, PairHash> playedCards;
+    std::array<uint64_t, 4> playedCards{}; // one word per deck (up to 4 combined decks), bit (suit % 4) * 13 + rank - 1
     std::unordered_map<uint64_t, int> playerPassCount;
 
     // Utility to count how many cards of a suit are in hand
     int countSuit(const std::vector<Card>& hand, uint64_t suit) {
         int count = 0;
         for (const Card& c : hand) {
-            if (c.suit == suit) count++;
+            if (static_cast<uint64_t>(c.suit) == suit) count++;
         }
         return count;
     }
@@ -122,6 +122,12 @@ private:
 
 } // namespace sevens
 
+#ifndef SEVENS_STATIC_STRATEGIES // compiled into the binary instead, see BuiltinStrategies.hpp
 extern "C" sevens::PlayerStrategy* createStrategy() {
     return new sevens::PrudentStrategy();
 }
+
+extern "C" void seedStrategy(sevens::PlayerStrategy* strategy, uint64_t seed) {
+    static_cast<sevens::PrudentStrategy*>(strategy)->seed(seed);
+}
+#endif
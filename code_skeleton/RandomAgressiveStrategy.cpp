@@ -1,4 +1,5 @@
 #include "PlayerStrategy.hpp"
+#include "ScratchArena.hpp"
 #include <algorithm>
 #include <vector>
 #include <string>
@@ -26,7 +27,8 @@ public:
         const std::vector<Card>& hand,
         const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override 
     {
-        std::vector<int> playable_indices;
+        ScratchScope scratch; // per-call temporaries, no heap allocation
+        std::pmr::vector<int> playable_indices(scratch.resource());
 
         for (size_t i = 0; i < hand.size(); ++i) {
             const Card& card = hand[i];
@@ -91,6 +93,11 @@ public:
         return "RandomAgressiveStrategy";
     }
 
+    // Reproducible runs (see seedStrategy below)
+    void seed(uint64_t s) {
+        rng.seed(static_cast<std::mt19937::result_type>(s));
+    }
+
 private:
     uint64_t myID;
     std::mt19937 rng;
@@ -99,6 +106,12 @@ private:
 } // namespace sevens
 
 // Export function for the loader — DO NOT place in the namespace
+#ifndef SEVENS_STATIC_STRATEGIES // compiled into the binary instead, see BuiltinStrategies.hpp
 extern "C" sevens::PlayerStrategy* createStrategy() {
     return new sevens::RandomAgressiveStrategy();
-}
\ No newline at end of file
+}
+
+extern "C" void seedStrategy(sevens::PlayerStrategy* strategy, uint64_t seed) {
+    static_cast<sevens::RandomAgressiveStrategy*>(strategy)->seed(seed);
+}
+#endif
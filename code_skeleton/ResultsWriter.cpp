@@ -0,0 +1,365 @@
+#include "ResultsWriter.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace sevens {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'V', 'N', 'S', 'R', 'E', 'S', '2'};
+constexpr uint32_t kColumns = static_cast<uint32_t>(ResultColumn::Count);
+
+const char* const kColumnNames[kColumns] = {
+    "match", "round", "seed", "seat", "strategy", "cards_left", "rank", "moves", "passes", "build"
+};
+
+uint64_t field(const GameRow& r, uint32_t c) {
+    switch (static_cast<ResultColumn>(c)) {
+        case ResultColumn::Match:     return r.match;
+        case ResultColumn::Round:     return r.round;
+        case ResultColumn::Seed:      return r.seed;
+        case ResultColumn::Seat:      return r.seat;
+        case ResultColumn::Strategy:  return r.strategy;
+        case ResultColumn::CardsLeft: return r.cardsLeft;
+        case ResultColumn::Rank:      return r.rank;
+        case ResultColumn::Moves:     return r.moves;
+        case ResultColumn::Passes:    return r.passes;
+        case ResultColumn::Build:     return r.build;
+        default:                      return 0;
+    }
+}
+
+void setField(GameRow& r, uint32_t c, uint64_t v) {
+    switch (static_cast<ResultColumn>(c)) {
+        case ResultColumn::Match:     r.match = v; break;
+        case ResultColumn::Round:     r.round = v; break;
+        case ResultColumn::Seed:      r.seed = v; break;
+        case ResultColumn::Seat:      r.seat = v; break;
+        case ResultColumn::Strategy:  r.strategy = v; break;
+        case ResultColumn::CardsLeft: r.cardsLeft = v; break;
+        case ResultColumn::Rank:      r.rank = v; break;
+        case ResultColumn::Moves:     r.moves = v; break;
+        case ResultColumn::Passes:    r.passes = v; break;
+        case ResultColumn::Build:     r.build = v; break;
+        default: break;
+    }
+}
+
+void putU32(std::vector<uint8_t>& b, uint32_t v) {
+    for (int i = 0; i < 4; ++i) b.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void putVarint(std::vector<uint8_t>& b, uint64_t v) {
+    while (v >= 0x80) {
+        b.push_back(static_cast<uint8_t>(v) | 0x80);
+        v >>= 7;
+    }
+    b.push_back(static_cast<uint8_t>(v));
+}
+
+uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+bool readU32(std::istream& in, uint32_t& v) {
+    uint8_t b[4];
+    if (!in.read(reinterpret_cast<char*>(b), 4)) return false;
+    v = b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
+    return true;
+}
+
+// Decodes one column of `rows` values, appending to out
+void decodeColumn(const std::vector<uint8_t>& bytes, uint32_t rows, std::vector<uint64_t>& out) {
+    size_t pos = 0;
+    uint64_t prev = 0;
+    for (uint32_t i = 0; i < rows; ++i) {
+        uint64_t v = 0;
+        int shift = 0;
+        for (;;) {
+            if (pos >= bytes.size() || shift > 63) throw std::runtime_error("corrupted results column");
+            uint8_t byte = bytes[pos++];
+            v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+            shift += 7;
+        }
+        prev += static_cast<uint64_t>(unzigzag(v));
+        out.push_back(prev);
+    }
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string r;
+    for (char c : s) {
+        if (c == '"' || c == '\\') r += '\\';
+        r += c;
+    }
+    return r;
+}
+
+} // namespace
+
+const char* columnName(ResultColumn column) {
+    uint32_t c = static_cast<uint32_t>(column);
+    return c < kColumns ? kColumnNames[c] : "?";
+}
+
+bool parseColumn(const std::string& name, ResultColumn& column) {
+    for (uint32_t c = 0; c < kColumns; ++c) {
+        if (name == kColumnNames[c]) {
+            column = static_cast<ResultColumn>(c);
+            return true;
+        }
+    }
+    return false;
+}
+
+ResultsFormat formatFromPath(const std::string& path) {
+    auto endsWith = [&](const std::string& ext) {
+        return path.size() >= ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0;
+    };
+    if (endsWith(".csv")) return ResultsFormat::Csv;
+    if (endsWith(".jsonl") || endsWith(".json")) return ResultsFormat::Jsonl;
+    return ResultsFormat::Columnar;
+}
+
+// -----------------------------------------------------------------------------
+// ResultsWriter
+// -----------------------------------------------------------------------------
+
+namespace {
+
+// Cuts an existing results file back to keepBytes; false when it has to be started over
+bool keepPrefix(const std::string& path, uint64_t keepBytes) {
+    if (keepBytes == ResultsWriter::kNewFile || keepBytes == 0) return false;
+    std::error_code ec;
+    const uint64_t size = std::filesystem::file_size(path, ec);
+    if (ec || size < keepBytes) {
+        throw std::runtime_error("Fichier de résultats " + path + " plus court que le checkpoint (" +
+                                 std::to_string(keepBytes) + " octets)");
+    }
+    std::filesystem::resize_file(path, keepBytes, ec);
+    if (ec) throw std::runtime_error("Impossible de tronquer le fichier de résultats : " + path);
+    return true;
+}
+
+} // namespace
+
+ResultsWriter::ResultsWriter(const std::string& path, std::vector<std::string> strategies, ResultsFormat fmt,
+                             uint64_t keepBytes)
+    : out(path, std::ios::binary | (keepPrefix(path, keepBytes) ? std::ios::app : std::ios::trunc)), format(fmt),
+      names(std::move(strategies)) {
+    if (!out) throw std::runtime_error("Impossible d'ouvrir le fichier de résultats : " + path);
+
+    out.seekp(0, std::ios::end);
+    if (out.tellp() > 0) {
+        // appending to a previous session: header already there (and checked, columnar)
+        if (format == ResultsFormat::Columnar) ResultsReader{path};
+    } else if (format == ResultsFormat::Columnar) {
+        std::vector<uint8_t> header(kMagic, kMagic + sizeof(kMagic));
+        putU32(header, kColumns);
+        putU32(header, static_cast<uint32_t>(names.size()));
+        for (const std::string& n : names) {
+            putU32(header, static_cast<uint32_t>(n.size()));
+            header.insert(header.end(), n.begin(), n.end());
+        }
+        out.write(reinterpret_cast<const char*>(header.data()), header.size());
+    } else if (format == ResultsFormat::Csv) {
+        ResultsReader::writeText(out, format, {}, names, true);
+    }
+
+    thread = std::thread(&ResultsWriter::run, this);
+}
+
+ResultsWriter::~ResultsWriter() {
+    close();
+}
+
+void ResultsWriter::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closing) return;
+        closing = true;
+    }
+    ready.notify_one();
+    thread.join();
+    out.flush();
+    out.close();
+}
+
+uint64_t ResultsWriter::sync() {
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [&] { return queue.empty() && !writing; });
+    out.flush();   // the writer thread only touches out with writing set
+    if (!out) throw std::runtime_error("Écriture du fichier de résultats impossible");
+    return static_cast<uint64_t>(out.tellp());
+}
+
+void ResultsWriter::submit(std::vector<GameRow>& rows) {
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [&] { return queue.size() < kMaxQueued; });
+    queue.push_back(std::move(rows));
+
+    if (!pool.empty()) {
+        rows = std::move(pool.back());
+        pool.pop_back();
+    } else {
+        rows = std::vector<GameRow>();
+        rows.reserve(kChunkRows);
+    }
+    lock.unlock();
+    ready.notify_one();
+}
+
+void ResultsWriter::run() {
+    for (;;) {
+        std::vector<GameRow> chunk;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [&] { return !queue.empty() || closing; });
+            if (queue.empty()) return;   // closing and nothing left
+            chunk = std::move(queue.front());
+            queue.pop_front();
+            writing = true;
+        }
+        drained.notify_all();
+
+        if (format == ResultsFormat::Columnar) writeColumnar(chunk);
+        else writeText(chunk);
+        written += chunk.size();
+
+        // Back to the pool for the next Buffer::flush
+        chunk.clear();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pool.push_back(std::move(chunk));
+            writing = false;
+        }
+        drained.notify_all();   // sync
+    }
+}
+
+void ResultsWriter::writeColumnar(const std::vector<GameRow>& rows) {
+    columns.resize(kColumns);
+    encoded.clear();
+    putU32(encoded, static_cast<uint32_t>(rows.size()));
+
+    for (uint32_t c = 0; c < kColumns; ++c) {
+        std::vector<uint8_t>& col = columns[c];
+        col.clear();
+        uint64_t prev = 0;
+        for (const GameRow& r : rows) {
+            uint64_t v = field(r, c);
+            putVarint(col, zigzag(static_cast<int64_t>(v - prev)));
+            prev = v;
+        }
+        putU32(encoded, static_cast<uint32_t>(col.size()));
+    }
+    for (uint32_t c = 0; c < kColumns; ++c) encoded.insert(encoded.end(), columns[c].begin(), columns[c].end());
+
+    out.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+}
+
+void ResultsWriter::writeText(const std::vector<GameRow>& rows) {
+    ResultsReader::writeText(out, format, rows, names, false);
+}
+
+ResultsWriter::Buffer::Buffer(ResultsWriter& w) : writer(w) {
+    rows.reserve(kChunkRows);
+}
+
+ResultsWriter::Buffer::~Buffer() {
+    flush();
+}
+
+void ResultsWriter::Buffer::flush() {
+    if (!rows.empty()) writer.submit(rows);
+}
+
+// -----------------------------------------------------------------------------
+// ResultsReader
+// -----------------------------------------------------------------------------
+
+ResultsReader::ResultsReader(const std::string& path) : in(path, std::ios::binary) {
+    if (!in) throw std::runtime_error("Impossible d'ouvrir le fichier de résultats : " + path);
+
+    char magic[sizeof(kMagic)];
+    uint32_t columns = 0, count = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !readU32(in, columns) || columns != kColumns || !readU32(in, count)) {
+        throw std::runtime_error(path + " n'est pas un fichier de résultats colonnaire");
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t len = 0;
+        if (!readU32(in, len)) throw std::runtime_error("corrupted results header");
+        std::string name(len, '\0');
+        in.read(&name[0], len);
+        names.push_back(name);
+    }
+    firstBlock = in.tellg();
+}
+
+std::vector<uint64_t> ResultsReader::column(ResultColumn column) {
+    const uint32_t wanted = static_cast<uint32_t>(column);
+    std::vector<uint64_t> values;
+    std::vector<uint8_t> bytes;
+
+    in.clear();
+    in.seekg(firstBlock);
+    uint32_t rows = 0;
+    while (readU32(in, rows)) {
+        uint32_t sizes[kColumns];
+        for (uint32_t c = 0; c < kColumns; ++c) {
+            if (!readU32(in, sizes[c])) throw std::runtime_error("truncated results block");
+        }
+        uint64_t before = 0;
+        for (uint32_t c = 0; c < wanted; ++c) before += sizes[c];
+        uint64_t after = 0;
+        for (uint32_t c = wanted + 1; c < kColumns; ++c) after += sizes[c];
+
+        in.seekg(static_cast<std::streamoff>(before), std::ios::cur);
+        bytes.resize(sizes[wanted]);
+        if (!in.read(reinterpret_cast<char*>(bytes.data()), bytes.size())) {
+            throw std::runtime_error("truncated results block");
+        }
+        decodeColumn(bytes, rows, values);
+        in.seekg(static_cast<std::streamoff>(after), std::ios::cur);
+    }
+    return values;
+}
+
+std::vector<GameRow> ResultsReader::rows() {
+    std::vector<GameRow> all;
+    for (uint32_t c = 0; c < kColumns; ++c) {
+        std::vector<uint64_t> values = column(static_cast<ResultColumn>(c));
+        if (c == 0) all.resize(values.size());
+        for (size_t i = 0; i < values.size(); ++i) setField(all[i], c, values[i]);
+    }
+    return all;
+}
+
+void ResultsReader::writeText(std::ostream& out, ResultsFormat format, const std::vector<GameRow>& rows,
+                              const std::vector<std::string>& strategies, bool header) {
+    auto name = [&](uint64_t s) { return s < strategies.size() ? strategies[s] : std::to_string(s); };
+
+    if (format == ResultsFormat::Csv) {
+        if (header) {
+            for (uint32_t c = 0; c < kColumns; ++c) out << (c ? "," : "") << kColumnNames[c];
+            out << '\n';
+        }
+        for (const GameRow& r : rows) {
+            out << r.match << ',' << r.round << ',' << r.seed << ',' << r.seat << ','
+                << name(r.strategy) << ',' << r.cardsLeft << ',' << r.rank << ','
+                << r.moves << ',' << r.passes << ',' << r.build << '\n';
+        }
+    } else {
+        for (const GameRow& r : rows) {
+            out << "{\"match\":" << r.match << ",\"round\":" << r.round << ",\"seed\":" << r.seed
+                << ",\"seat\":" << r.seat << ",\"strategy\":\"" << jsonEscape(name(r.strategy))
+                << "\",\"cards_left\":" << r.cardsLeft << ",\"rank\":" << r.rank
+                << ",\"moves\":" << r.moves << ",\"passes\":" << r.passes << ",\"build\":" << r.build << "}\n";
+        }
+    }
+}
+
+} // namespace sevens
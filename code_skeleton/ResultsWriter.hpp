@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * One row per player and per game (round) of a batch run.
+ * A game is identified by (match, round).
+ */
+struct GameRow {
+    uint64_t match;
+    uint64_t round;      // 1-based, inside the match
+    uint64_t seed;       // engine seed of the match
+    uint64_t seat;
+    uint64_t strategy;   // index in the strategy dictionary of the file
+    uint64_t cardsLeft;
+    uint64_t rank;       // rank in this game, 1 = fewest cards left (ties share a rank)
+    uint64_t moves;      // cards played
+    uint64_t passes;
+    uint64_t build;      // build of the strategy (batch --hot-reload), 0 = the one loaded at start
+};
+
+enum class ResultColumn : uint32_t {
+    Match, Round, Seed, Seat, Strategy, CardsLeft, Rank, Moves, Passes, Build, Count
+};
+
+const char* columnName(ResultColumn column);
+bool parseColumn(const std::string& name, ResultColumn& column);
+
+enum class ResultsFormat {
+    Columnar,   // binary, see ResultsWriter
+    Csv,
+    Jsonl
+};
+
+// ".csv" → Csv, ".jsonl" / ".json" → Jsonl, anything else → Columnar
+ResultsFormat formatFromPath(const std::string& path);
+
+/**
+ * Buffered background writer for per-game results.
+ *
+ * Simulation threads fill a Buffer (one per thread, no locking); full chunks of rows are
+ * handed over to the writer thread, which encodes and writes them while the simulation goes on.
+ * Chunks are recycled, so a long run does not allocate once the pool is warm; the writer
+ * only makes producers wait when kMaxQueued chunks are already pending.
+ *
+ * Columnar file layout (little endian):
+ *   header : "SVNSRES2", u32 column count, u32 strategy count, { u32 length, name bytes }...
+ *   blocks : u32 rows, u32 byte size of each column, then the columns one after another;
+ *            every column is delta encoded, zigzag'ed and written as LEB128 varints.
+ * A reader can therefore skip every column it does not need (ResultsReader::column).
+ * Rows keep the order in which chunks were completed, which depends on the threads.
+ * A resumed run first cuts the file back to the size recorded by its checkpoint (sync),
+ * dropping the rows written after it.
+ */
+class ResultsWriter {
+public:
+    static constexpr size_t kChunkRows = 1 << 14;
+    static constexpr size_t kMaxQueued = 8;
+    static constexpr uint64_t kNewFile = ~0ull;
+
+    // keepBytes: continue an existing file cut back to that size (resumed run, see sync);
+    // the header is only written to an empty file
+    ResultsWriter(const std::string& path, std::vector<std::string> strategies,
+                  ResultsFormat format = ResultsFormat::Columnar, uint64_t keepBytes = kNewFile);
+    ~ResultsWriter();
+
+    ResultsWriter(const ResultsWriter&) = delete;
+    ResultsWriter& operator=(const ResultsWriter&) = delete;
+
+    // Waits for the pending chunks and closes the file (buffers must be flushed before)
+    void close();
+
+    uint64_t rowsWritten() const { return written; }
+
+    // Waits until every submitted chunk is on disk and returns the size of the file
+    // (what a checkpoint records; buffers must be flushed before)
+    uint64_t sync();
+
+    /**
+     * Per-thread row buffer, flushed when full and on destruction.
+     */
+    class Buffer {
+    public:
+        explicit Buffer(ResultsWriter& writer);
+        ~Buffer();
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+
+        void add(const GameRow& row) {
+            rows.push_back(row);
+            if (rows.size() == kChunkRows) flush();
+        }
+        void flush();
+
+    private:
+        ResultsWriter& writer;
+        std::vector<GameRow> rows;
+    };
+
+private:
+    std::ofstream out;
+    ResultsFormat format;
+    std::vector<std::string> names;
+
+    std::mutex mutex;
+    std::condition_variable ready;    // writer thread: a chunk is queued (or closing)
+    std::condition_variable drained;  // producers: room in the queue
+    std::deque<std::vector<GameRow>> queue;
+    std::vector<std::vector<GameRow>> pool;
+    bool closing = false;
+    bool writing = false;             // writer thread busy with a chunk taken off the queue
+    std::atomic<uint64_t> written{0};
+    std::thread thread;
+
+    std::vector<uint8_t> encoded;     // writer thread only
+    std::vector<std::vector<uint8_t>> columns;
+
+    void submit(std::vector<GameRow>& rows);   // rows is swapped with an empty recycled chunk
+    void run();
+    void writeColumnar(const std::vector<GameRow>& rows);
+    void writeText(const std::vector<GameRow>& rows);
+};
+
+/**
+ * Reads the columnar files of ResultsWriter.
+ */
+class ResultsReader {
+public:
+    explicit ResultsReader(const std::string& path);
+
+    const std::vector<std::string>& strategies() const { return names; }
+
+    // Decodes a single column of the whole file, the other columns are skipped
+    std::vector<uint64_t> column(ResultColumn column);
+
+    // Every row, e.g. to export a small run as CSV / JSON lines
+    std::vector<GameRow> rows();
+
+    static void writeText(std::ostream& out, ResultsFormat format, const std::vector<GameRow>& rows,
+                          const std::vector<std::string>& strategies, bool header);
+
+private:
+    std::ifstream in;
+    std::streampos firstBlock;
+    std::vector<std::string> names;
+};
+
+} // namespace sevens
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Bump allocator for the per-call temporaries of a strategy
+ * (playable cards, scored moves, ...).
+ *
+ *   int selectCardToPlay(...) override {
+ *       ScratchScope scope;                                   // rewinds on return
+ *       std::pmr::vector<int> playable(&scratchArena());
+ *       ...
+ *   }
+ *
+ * Blocks obtained from the heap are kept when the arena is rewound, so once the
+ * largest call has been seen the strategy runs without any heap allocation.
+ * deallocate() is a no-op: memory comes back when the enclosing ScratchScope ends.
+ * One arena per thread; header-only so every strategy .so gets its own.
+ */
+class ScratchArena : public std::pmr::memory_resource {
+public:
+    struct Mark {
+        size_t block;
+        size_t offset;
+    };
+
+    explicit ScratchArena(size_t firstBlockSize = 16 * 1024) : blockSize(firstBlockSize) {}
+
+    ~ScratchArena() override {
+        for (auto& b : blocks) ::operator delete(b.data);
+    }
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    Mark mark() const { return Mark{current, offset}; }
+
+    void rewind(Mark m) {
+        current = m.block;
+        offset = m.offset;
+    }
+
+    void reset() { rewind(Mark{0, 0}); }
+
+    // Bytes obtained from the heap so far (kept across rewinds)
+    size_t capacity() const {
+        size_t total = 0;
+        for (const auto& b : blocks) total += b.size;
+        return total;
+    }
+
+private:
+    struct Block {
+        std::byte* data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t current = 0;   // block being filled
+    size_t offset = 0;    // first free byte in that block
+    size_t blockSize;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        for (;;) {
+            if (current < blocks.size()) {
+                Block& b = blocks[current];
+                size_t aligned = (offset + alignment - 1) & ~(alignment - 1);
+                if (aligned + bytes <= b.size) {
+                    offset = aligned + bytes;
+                    return b.data + aligned;
+                }
+                if (current + 1 < blocks.size()) {   // reuse the next retained block
+                    ++current;
+                    offset = 0;
+                    continue;
+                }
+            }
+            size_t size = blockSize;
+            while (size < bytes + alignment) size *= 2;
+            blockSize = size * 2;
+            blocks.push_back(Block{static_cast<std::byte*>(::operator new(size)), size});
+            current = blocks.size() - 1;
+            offset = 0;
+        }
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Per-thread scratch arena handed to strategies
+inline ScratchArena& scratchArena() {
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+// Rewinds the thread's scratch arena to where it was when the scope was entered
+class ScratchScope {
+public:
+    ScratchScope() : arena(scratchArena()), start(arena.mark()) {}
+    ~ScratchScope() { arena.rewind(start); }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    std::pmr::memory_resource* resource() { return &arena; }
+
+private:
+    ScratchArena& arena;
+    ScratchArena::Mark start;
+};
+
+} // namespace sevens
@@ -0,0 +1,278 @@
+#include "SelfPlay.hpp"
+#include "VariantGame.hpp"
+#include "StrategyLoader.hpp"
+#include "MatchRunner.hpp"
+#include "WorkScheduler.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+namespace sevens {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'V', 'N', 'S', 'S', 'E', 'L', 'F'};
+
+template <typename T>
+void put(unsigned char* at, T v) {
+    for (size_t i = 0; i < sizeof(T); ++i) at[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+template <typename T>
+T get(const unsigned char* at) {
+    T v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) v |= static_cast<T>(at[i]) << (8 * i);
+    return v;
+}
+
+// Seats of one line-up: the strategies and, per seat, the index of its spec
+struct LineUp {
+    StrategySeats<1> seats;
+    std::vector<uint8_t> strategyOf;
+};
+
+/**
+ * Seats policy around a line-up that appends a record per decision, the outcome filled
+ * in by finish(). One per worker, pointed at the game to play by start().
+ */
+class RecordingSeats {
+public:
+    explicit RecordingSeats(std::vector<SelfPlayRecord>& out) : out(out) {}
+
+    void start(LineUp& lineUp, uint64_t gameNumber) {
+        inner = &lineUp.seats;
+        strategyOf = &lineUp.strategyOf;
+        game = gameNumber;
+    }
+
+    void begin(const std::vector<CardSet<1>>& hands, const CardSet<1>& opening) {
+        inner->begin(hands, opening);
+        table = opening.word(0);
+        for (size_t p = 0; p < hands.size(); ++p) {
+            sizes[p] = static_cast<uint8_t>(hands[p].count());
+            passes[p] = turns[p] = 0;
+        }
+        inARow = 0;
+        first = out.size();
+    }
+
+    int choose(uint64_t player, const CardSet<1>& hand, const CardSet<1>& playable) {
+        const unsigned nP = static_cast<unsigned>(strategyOf->size());
+        SelfPlayRecord r{};
+        r.hand = hand.word(0);
+        r.table = table;
+        r.legal = playable.word(0);
+        r.game = game;
+        for (unsigned i = 0; i < nP; ++i) {
+            const unsigned p = static_cast<unsigned>((player + i) % nP);
+            r.handSizes[i] = sizes[p];
+            r.passes[i] = passes[p];
+        }
+        r.players = static_cast<uint8_t>(nP);
+        r.seat = static_cast<uint8_t>(player);
+        r.strategy = (*strategyOf)[player];
+        r.turn = turns[player]++;
+        r.passesInARow = inARow;
+
+        const int card = inner->choose(player, hand, playable);
+        r.chosen = card >= 0 && card < 52 && playable.test(card) ? static_cast<uint8_t>(card) : SelfPlayRecord::kPass;
+        out.push_back(r);
+        return card;
+    }
+
+    void played(uint64_t player, int card) {
+        table |= 1ull << card;
+        --sizes[player];
+        inARow = 0;
+        inner->played(player, card);
+    }
+
+    void passed(uint64_t player) {
+        ++passes[player];
+        ++inARow;
+        inner->passed(player);
+    }
+
+    // Outcome of the game for every record it produced
+    void finish(const std::vector<uint64_t>& left) {
+        for (size_t i = first; i < out.size(); ++i) {
+            SelfPlayRecord& r = out[i];
+            r.cardsLeft = static_cast<uint8_t>(left[r.seat]);
+            r.rank = 1;
+            for (uint64_t l : left) r.rank += l < left[r.seat];
+        }
+    }
+
+private:
+    std::vector<SelfPlayRecord>& out;
+    StrategySeats<1>* inner = nullptr;
+    const std::vector<uint8_t>* strategyOf = nullptr;
+    uint64_t game = 0;
+    size_t first = 0;
+    uint64_t table = 0;
+    uint8_t sizes[SelfPlayRecord::kMaxPlayers] = {};
+    uint8_t passes[SelfPlayRecord::kMaxPlayers] = {};
+    uint8_t turns[SelfPlayRecord::kMaxPlayers] = {};
+    uint8_t inARow = 0;
+};
+
+} // namespace
+
+std::string selfPlayShardPath(const std::string& prefix, uint64_t shard) {
+    char digits[24];
+    std::snprintf(digits, sizeof(digits), "%05llu", static_cast<unsigned long long>(shard));
+    return prefix + "-" + digits + ".svs";
+}
+
+SelfPlayStats runSelfPlay(const std::string& prefix, const SelfPlayConfig& cfg) {
+    if (cfg.specs.empty()) throw std::invalid_argument("Il faut au moins une stratégie");
+    if (cfg.specs.size() > 255) throw std::invalid_argument("Trop de stratégies (255 au plus)");
+    if (cfg.players < 2 || cfg.players > SelfPlayRecord::kMaxPlayers) {
+        throw std::invalid_argument("Nombre de joueurs invalide (2 à 8) : " + std::to_string(cfg.players));
+    }
+    if (cfg.shardGames == 0) throw std::invalid_argument("Un fragment doit contenir au moins une partie");
+
+    std::vector<StrategyFactory> factories;
+    for (const std::string& spec : cfg.specs) factories.emplace_back(spec);
+    RulesConfig rules;
+    rules.players = cfg.players;
+    rules.validate();
+
+    const uint64_t shards = (cfg.games + cfg.shardGames - 1) / cfg.shardGames;
+    SelfPlayStats totals;
+    std::mutex merge;
+
+    WorkScheduler scheduler(0, shards, cfg.threads);
+    scheduler.run([&](WorkScheduler::Tasks& tasks) {
+        std::vector<SelfPlayRecord> records;
+        records.reserve(8192);
+        RecordingSeats recording(records);
+        uint64_t games = 0, written = 0, done = 0;
+        for (uint64_t s; tasks.next(s);) {
+            const uint64_t firstGame = s * cfg.shardGames;
+            const uint64_t lastGame = std::min(cfg.games, firstGame + cfg.shardGames);
+            const std::string path = selfPlayShardPath(prefix, s);
+            const std::string tmp = path + ".tmp";
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out) throw std::runtime_error("Impossible d'écrire le fragment : " + tmp);
+            unsigned char header[SelfPlayShard::kHeaderSize] = {};
+            out.write(reinterpret_cast<const char*>(header), sizeof(header));   // rewritten at the end
+
+            // Strategy instances live for the shard, as for a match in batch (creating them
+            // costs more than a game of the simple ones): one per seat and spec, seeded from
+            // (seed, shard, 1 + seat * specs + spec); line-up r seats spec (p + r) % specs at p.
+            const size_t nSpecs = factories.size();
+            std::vector<std::vector<std::shared_ptr<PlayerStrategy>>> instances(cfg.players);
+            for (unsigned p = 0; p < cfg.players; ++p) {
+                for (size_t f = 0; f < nSpecs; ++f) {
+                    instances[p].push_back(factories[f].create(MatchRunner::deriveSeed(cfg.seed, s, 1 + p * nSpecs + f)));
+                }
+            }
+            std::vector<LineUp> lineUps;
+            for (size_t r = 0; r < (cfg.fixedSeats ? 1 : nSpecs); ++r) {
+                std::vector<std::shared_ptr<PlayerStrategy>> seats;
+                std::vector<uint8_t> strategyOf;
+                for (unsigned p = 0; p < cfg.players; ++p) {
+                    const size_t f = (p + r) % nSpecs;
+                    seats.push_back(instances[p][f]);
+                    strategyOf.push_back(static_cast<uint8_t>(f));
+                }
+                lineUps.push_back(LineUp{StrategySeats<1>(std::move(seats)), std::move(strategyOf)});
+            }
+            VariantGame<1> game(rules);
+            std::mt19937_64 rng(MatchRunner::deriveSeed(cfg.seed, s, 0));
+
+            uint64_t count = 0;
+            for (uint64_t g = firstGame; g < lastGame; ++g) {
+                recording.start(lineUps[g % lineUps.size()], g);
+                recording.finish(game.play(recording, rng));
+
+                // Whole games only, so finish() never reaches flushed records
+                if (records.size() >= 4096 || g + 1 == lastGame) {
+                    out.write(reinterpret_cast<const char*>(records.data()),
+                              static_cast<std::streamsize>(records.size() * sizeof(SelfPlayRecord)));
+                    count += records.size();
+                    records.clear();
+                }
+            }
+
+            std::memcpy(header, kMagic, sizeof(kMagic));
+            put<uint32_t>(header + 8, SelfPlayShard::kVersion);
+            put<uint32_t>(header + 12, sizeof(SelfPlayRecord));
+            put<uint64_t>(header + 16, count);
+            put<uint64_t>(header + 24, firstGame);
+            put<uint64_t>(header + 32, lastGame - firstGame);
+            put<uint64_t>(header + 40, cfg.seed);
+            put<uint32_t>(header + 48, cfg.players);
+            put<uint32_t>(header + 52, static_cast<uint32_t>(s));
+            out.seekp(0);
+            out.write(reinterpret_cast<const char*>(header), sizeof(header));
+            out.close();
+            if (!out) throw std::runtime_error("Impossible d'écrire le fragment : " + tmp);
+            if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+                throw std::runtime_error("Impossible de renommer le fragment : " + tmp);
+            }
+            games += lastGame - firstGame;
+            written += count;
+            ++done;
+        }
+
+        std::lock_guard<std::mutex> lock(merge);
+        totals.games += games;
+        totals.records += written;
+        totals.shards += done;
+    });
+    return totals;
+}
+
+SelfPlayShard::SelfPlayShard(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Fragment de self-play introuvable : " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kHeaderSize) {
+        ::close(fd);
+        throw std::runtime_error("Fragment de self-play invalide : " + path);
+    }
+    mapSize = static_cast<size_t>(st.st_size);
+    map = ::mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        map = nullptr;
+        throw std::runtime_error("Impossible de projeter le fragment en mémoire : " + path);
+    }
+
+    const unsigned char* h = static_cast<const unsigned char*>(map);
+    auto fail = [&](const std::string& why) {
+        ::munmap(map, mapSize);
+        map = nullptr;
+        throw std::runtime_error("Fragment " + path + " : " + why);
+    };
+    if (std::memcmp(h, kMagic, sizeof(kMagic)) != 0) fail("ce n'est pas un fragment de self-play");
+    if (get<uint32_t>(h + 8) != kVersion) fail("version inconnue");
+    if (get<uint32_t>(h + 12) != sizeof(SelfPlayRecord)) fail("taille d'enregistrement invalide");
+    count = get<uint64_t>(h + 16);
+    first = get<uint64_t>(h + 24);
+    nGames = get<uint64_t>(h + 32);
+    runSeed = get<uint64_t>(h + 40);
+    nPlayers = get<uint32_t>(h + 48);
+    if ((mapSize - kHeaderSize) / sizeof(SelfPlayRecord) != count) fail("fichier tronqué");
+
+    records = reinterpret_cast<const SelfPlayRecord*>(h + kHeaderSize);
+    // Trainers stream the records in order
+    ::madvise(map, mapSize, MADV_SEQUENTIAL);
+}
+
+SelfPlayShard::~SelfPlayShard() {
+    if (map) ::munmap(map, mapSize);
+}
+
+} // namespace sevens
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * One decision of a self-play game, seen by the player who made it. Fixed size, read in
+ * place from a mapped shard (little-endian). Card masks use the card id as bit
+ * (suit * 13 + rank - 1); seat-indexed arrays start at the decider and follow the turn
+ * order (index 1 = the next player to move), unused entries are 0.
+ */
+struct SelfPlayRecord {
+    static constexpr uint8_t kPass = 0xFF;
+    static constexpr unsigned kMaxPlayers = 8;
+
+    uint64_t hand;                       // decider's cards
+    uint64_t table;                      // cards on the table
+    uint64_t legal;                      // playable cards of the hand (never empty)
+    uint64_t game;                       // game number in the run (one game = one round)
+    uint8_t handSizes[kMaxPlayers];      // cards in hand per seat
+    uint8_t passes[kMaxPlayers];         // passes per seat so far in the game
+    uint8_t players;
+    uint8_t seat;                        // decider's seat at the table
+    uint8_t strategy;                    // index of its strategy on the command line
+    uint8_t chosen;                      // card played, kPass when it passed
+    uint8_t turn;                        // decisions it made earlier in the game
+    uint8_t passesInARow;                // passes since the last card played
+    uint8_t cardsLeft;                   // outcome: its cards left at the end of the game
+    uint8_t rank;                        // outcome: 1 + players with fewer cards left
+    uint8_t reserved[8];
+};
+
+static_assert(sizeof(SelfPlayRecord) == 64, "self-play records are 64 bytes");
+
+/**
+ * Self-play run (mode `selfplay`): games of the 52-card game among the listed strategies,
+ * every decision recorded. Seat p of game g plays specs[(p + g) % specs.size()]
+ * (specs[p % size] with fixedSeats).
+ *
+ * Games are cut into shards of shardGames games, played like the matches of batch: shard
+ * k deals from MatchRunner::deriveSeed(seed, k, 0) and its strategy instances, seeded from
+ * (seed, k, ...), play all its games. A worker takes the next shard, plays it and writes it
+ * alone (no lock, no shared buffer), so writing scales with the cores, and the same seed
+ * and shardGames give the same files whatever the thread count.
+ *
+ * Shard k is written to "<prefix>-<k>.svs" (k on 5 digits) through a temporary file, so a
+ * shard on disk is always complete:
+ *
+ *   0   header   "SVNSSELF", u32 version, u32 record size, u64 records, u64 first game,
+ *                u64 games, u64 seed, u32 players, u32 shard (padded to 64 bytes)
+ *   64  records  records x SelfPlayRecord, by game then by move
+ */
+struct SelfPlayConfig {
+    std::vector<std::string> specs;
+    unsigned players = 4;
+    uint64_t games = 1000000;
+    uint64_t shardGames = 16384;
+    unsigned threads = 0;   // 0 = std::thread::hardware_concurrency()
+    uint64_t seed = 0;
+    bool fixedSeats = false;
+};
+
+struct SelfPlayStats {
+    uint64_t games = 0;
+    uint64_t records = 0;
+    uint64_t shards = 0;
+};
+
+SelfPlayStats runSelfPlay(const std::string& prefix, const SelfPlayConfig& cfg);
+
+// "<prefix>-00042.svs"
+std::string selfPlayShardPath(const std::string& prefix, uint64_t shard);
+
+/**
+ * A shard, mapped read-only; records are read in place.
+ */
+class SelfPlayShard {
+public:
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kHeaderSize = 64;
+
+    // Throws std::runtime_error when the file is not a complete shard
+    explicit SelfPlayShard(const std::string& path);
+    ~SelfPlayShard();
+
+    SelfPlayShard(const SelfPlayShard&) = delete;
+    SelfPlayShard& operator=(const SelfPlayShard&) = delete;
+
+    uint64_t size() const { return count; }
+    const SelfPlayRecord& operator[](uint64_t i) const { return records[i]; }
+    const SelfPlayRecord* begin() const { return records; }
+    const SelfPlayRecord* end() const { return records + count; }
+
+    unsigned players() const { return nPlayers; }
+    uint64_t firstGame() const { return first; }
+    uint64_t games() const { return nGames; }
+    uint64_t seed() const { return runSeed; }
+
+private:
+    void* map = nullptr;
+    size_t mapSize = 0;
+    const SelfPlayRecord* records = nullptr;
+    uint64_t count = 0;
+    uint64_t first = 0;
+    uint64_t nGames = 0;
+    uint64_t runSeed = 0;
+    unsigned nPlayers = 0;
+};
+
+} // namespace sevens
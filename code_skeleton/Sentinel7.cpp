@@ -1,9 +1,11 @@
 #include "PlayerStrategy.hpp"
+#include "ScratchArena.hpp"
+#include "OpeningBook.hpp"
+#include "Features.hpp"
 #include <algorithm>
+#include <array>
 #include <vector>
 #include <string>
-#include <map>
-#include <set>
 #include <unordered_map>
 #include <cmath>
 #include <random>
@@ -19,6 +21,7 @@ public:
             std::chrono::system_clock::now().time_since_epoch().count()
         );
         rng.seed(seed);
+        book = OpeningBook::active();
     }
 
     ~Sentinel7() override = default;
@@ -27,30 +30,28 @@ public:
         myID = playerID;
         
         // Initialize data structures for tracking
-        playerHands.clear();
-        playerPasses.clear();
+        // (reset in place: the map nodes are kept from one game to the next)
+        for (auto& [id, cards] : playerHands) cards.clear();
+        for (auto& [id, passes] : playerPasses) passes = 0;
         playedCards.clear();
         
         // Track suits that players seem to have or lack
-        playerSuitStrengths.clear();
-        playerSuitWeaknesses.clear();
+        for (auto& [id, suits] : playerSuitStrengths) suits = 0;
+        for (auto& [id, suits] : playerSuitWeaknesses) suits = 0;
         
         // Track critical cards (7s, 8s, 6s)
-        playerHasCriticalCards.clear();
-        
-        // Track the number of cards each player has
-        playerCardCounts.clear();
+        for (auto& [id, cards] : playerPlayedCriticalCards) cards = 0;
         
         // Reset game progression tracking
         gameProgress = 0;
-        cardsPlayedPerSuit.clear();
-        
-        // Initialize estimated hand sizes
-        for (uint64_t pid = 0; pid < 8; ++pid) { // assuming max 8 players
-            if (pid != myID) {
-                playerCardCounts[pid] = 13; // initial estimate (may vary by player count)
-            }
-        }
+        cardsPlayedPerSuit.fill(0);
+        
+        // Estimated hand sizes: every opponent starts from the size of our own hand at
+        // our first turn, less the cards seen played (entries kept, any player count)
+        for (auto& [id, played] : playerCardsPlayed) played = 0;
+        openingHandSize = 0;
+        highestSeat = playerID;
+        bookDecisions = 0;
     }
 
     int selectCardToPlay(
@@ -59,20 +60,28 @@ public:
     {
         // Update our tracked hand
         myHand = hand;
+        if (openingHandSize == 0) dealt(hand, tableLayout);
         
-        // Update game progress (0-100%)
+        // Update game progress (0-100%), and the table as one row of bits per suit
         updateGameProgress(tableLayout);
         
-        // Track what suits we have
-        std::map<int, int> mySuitCounts;
+        // Track what suits we have (counts, and rows of bits for Features)
+        std::array<int, kMaxSuits> mySuitCounts{};
+        handRows.fill(0);
         for (const auto& card : hand) {
-            mySuitCounts[card.suit]++;
+            if (card.suit < kMaxSuits) {
+                mySuitCounts[card.suit]++;
+                handRows[card.suit] |= 1u << (card.rank - 1);
+            }
         }
         
+        // Per-call temporaries live in the scratch arena (no heap allocation)
+        ScratchScope scratch;
+        
         // Get all playable cards and their indices
-        std::vector<std::pair<int, Card>> playableCards;
+        std::pmr::vector<std::pair<int, Card>> playableCards(scratch.resource());
         for (size_t i = 0; i < hand.size(); ++i) {
-            if (isPlayable(hand[i], tableLayout)) {
+            if (isPlayable(hand[i])) {
                 playableCards.emplace_back(static_cast<int>(i), hand[i]);
             }
         }
@@ -81,11 +90,20 @@ public:
             return -1; // No playable cards, must pass
         }
         
+        // First decisions of the round: the opening book, when one is loaded for this player count
+        if (book && bookDecisions < book->depth()) {
+            ++bookDecisions;
+            if (book->dealtFor(static_cast<size_t>(openingHandSize))) {
+                int idx = book->choose(hand, tableLayout);
+                if (idx >= 0) return idx;
+            }
+        }
+        
         // SCORING SYSTEM FOR EACH PLAYABLE CARD
-        std::vector<std::pair<double, int>> scoredMoves; // score, index
+        std::pmr::vector<std::pair<double, int>> scoredMoves(scratch.resource()); // score, index
         
         for (const auto& [idx, card] : playableCards) {
-            double score = calculateMoveScore(card, hand, tableLayout, mySuitCounts);
+            double score = calculateMoveScore(card, hand, mySuitCounts, playableCards.size());
             scoredMoves.emplace_back(score, idx);
         }
         
@@ -97,7 +115,7 @@ public:
         // but within top 20% of scores to avoid being predictable
         if (scoredMoves.size() > 1) {
             double topScore = scoredMoves[0].first;
-            std::vector<int> topIndices;
+            std::pmr::vector<int> topIndices(scratch.resource());
             
             for (const auto& [score, idx] : scoredMoves) {
                 // Consider moves within 20% of the top score
@@ -126,7 +144,7 @@ public:
         playedCards.emplace_back(playedCard);
         
         // Player revealed they have this suit
-        playerSuitStrengths[playerID].insert(playedCard.suit);
+        playerSuitStrengths[playerID] |= 1u << playedCard.suit;
         
         // Update our model of each player's hand
         auto& playerHand = playerHands[playerID];
@@ -142,13 +160,12 @@ public:
         
         // Track special cards (7s, 6s, and 8s)
         if (playedCard.rank == 7 || playedCard.rank == 6 || playedCard.rank == 8) {
-            playerHasCriticalCards[playerID][playedCard.suit][playedCard.rank] = false; // They no longer have this card
+            playerPlayedCriticalCards[playerID] |= criticalBit(playedCard.suit, playedCard.rank); // They no longer have this card
         }
         
         // Update estimated card count for the player
-        if (playerCardCounts.count(playerID) > 0) {
-            playerCardCounts[playerID]--;
-        }
+        playerCardsPlayed[playerID]++;
+        highestSeat = std::max(highestSeat, playerID);
         
         // Reset pass count since they played a card
         playerPasses[playerID] = 0;
@@ -171,6 +188,11 @@ public:
         return "Sentinel7";
     }
 
+    // Reproducible runs (see seedStrategy below)
+    void seed(uint64_t s) {
+        rng.seed(static_cast<std::mt19937::result_type>(s));
+    }
+
 private:
     uint64_t myID;
     std::mt19937 rng;
@@ -181,74 +203,93 @@ private:
     std::unordered_map<uint64_t, int> playerPasses;
     std::vector<Card> playedCards;
     
-    // Track which suits each player seems to have or lack
-    std::unordered_map<uint64_t, std::set<int>> playerSuitStrengths;
-    std::unordered_map<uint64_t, std::set<int>> playerSuitWeaknesses;
+    // Track which suits each player seems to have or lack (bit s set for suit s)
+    std::unordered_map<uint64_t, unsigned> playerSuitStrengths;
+    std::unordered_map<uint64_t, unsigned> playerSuitWeaknesses;
     
-    // Track players who have critical cards (7s, 6s, 8s)
-    std::unordered_map<uint64_t, std::unordered_map<int, std::unordered_map<int, bool>>> playerHasCriticalCards;
+    // Critical cards (7s, 6s, 8s) each player has already played (see criticalBit)
+    std::unordered_map<uint64_t, uint64_t> playerPlayedCriticalCards;
     
-    // Track estimated number of cards each player has
-    std::unordered_map<uint64_t, int> playerCardCounts;
+    // Track estimated number of cards each player has (see cardsLeft)
+    std::unordered_map<uint64_t, int> playerCardsPlayed;
+    int openingHandSize = 0;
+    uint64_t highestSeat = 0;
+    
+    // Opening book of the process (OpeningBook::activate), decisions it answered this round
+    std::shared_ptr<const OpeningBook> book;
+    unsigned bookDecisions = 0;
     
     // Game progression (0-100%)
     int gameProgress;
     
+    // Suits of the largest variant (4 combined decks, see VariantGame.hpp)
+    static constexpr int kMaxSuits = 16;
+    
     // Cards played per suit (to avoid recounting)
-    std::unordered_map<int, int> cardsPlayedPerSuit;
+    std::array<int, kMaxSuits> cardsPlayedPerSuit{};
+    
+    // Cards in the game, set from the deal at our first turn (see dealt)
+    int deckCards = 52;
+    
+    // Our hand and the table of the current decision, bit rank - 1 of each suit's row
+    std::array<unsigned, kMaxSuits> handRows{};
+    std::array<unsigned, kMaxSuits> tableRows{};
+    
+    // One bit per critical card (6, 7 or 8) of each of the 16 suits
+    static uint64_t criticalBit(int suit, int rank) {
+        return 1ull << (suit * 3 + rank - 6);
+    }
+    
+    int cardsLeft(int played) const {
+        return openingHandSize - played;
+    }
+    
+    // At our first turn: our hand size, and the pack size from the decks of the table
+    // (a variant's table lists every suit of every deck, 52 cards per 4 suits) or from
+    // the hands dealt to the seats seen so far, whichever is larger
+    void dealt(const std::vector<Card>& hand,
+               const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) {
+        openingHandSize = static_cast<int>(hand.size());
+        uint64_t suits = 4;
+        for (const auto& entry : tableLayout) suits = std::max(suits, entry.first + 1);
+        deckCards = static_cast<int>(std::max((suits + 3) / 4 * 52, (highestSeat + 1) * hand.size()));
+    }
     
     // Update game progression based on cards played
     void updateGameProgress(const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) {
         int playedCardCount = 0;
-        cardsPlayedPerSuit.clear();
+        cardsPlayedPerSuit.fill(0);
+        tableRows.fill(0);
         
+        // Only entries set to true are on the table
         for (const auto& [suit, ranks] : tableLayout) {
-            cardsPlayedPerSuit[suit] = ranks.size();
-            playedCardCount += ranks.size();
+            int onTable = 0;
+            unsigned row = 0;
+            for (const auto& [rank, on] : ranks) {
+                onTable += on;
+                if (on && rank >= 1 && rank <= 13) row |= 1u << (rank - 1);
+            }
+            if (suit < cardsPlayedPerSuit.size()) {
+                cardsPlayedPerSuit[suit] = onTable;
+                tableRows[suit] = row;
+            }
+            playedCardCount += onTable;
         }
         
         // Estimate game progress (0-100%)
-        gameProgress = std::min(100, static_cast<int>(playedCardCount * 100.0 / 52.0));
+        gameProgress = std::min(100, static_cast<int>(playedCardCount * 100.0 / deckCards));
     }
     
-    // Helper function to check if a card has an adjacent card on the table
-    bool hasAdjacent(const Card& card, 
-                    const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) const {
-        bool hasLower = false;
-        if (card.rank > 1 && tableLayout.count(card.suit) > 0) {
-            hasLower = tableLayout.at(card.suit).count(card.rank - 1) > 0 && 
-                      tableLayout.at(card.suit).at(card.rank - 1);
-        }
-        
-        bool hasUpper = false;
-        if (card.rank < 13 && tableLayout.count(card.suit) > 0) {
-            hasUpper = tableLayout.at(card.suit).count(card.rank + 1) > 0 && 
-                      tableLayout.at(card.suit).at(card.rank + 1);
-        }
-        
-        return hasLower || hasUpper;
-    }
-    
-    // Helper function to check if a card is playable
-    bool isPlayable(const Card& card, 
-                   const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) const {
-        // Check if it's a 7
-        if (card.rank == 7) {
-            // If the 7 is not on the table, it can be played
-            return tableLayout.count(card.suit) == 0 || 
-                   tableLayout.at(card.suit).count(7) == 0 || 
-                   !tableLayout.at(card.suit).at(7);
-        }
-        
-        // Check for cards adjacent to this one
-        return hasAdjacent(card, tableLayout);
+    // Helper function to check if a card is playable (a 7 not on the table, or a neighbour)
+    bool isPlayable(const Card& card) const {
+        return card.suit < kMaxSuits && ((Features::playable(tableRows[card.suit]) >> (card.rank - 1)) & 1);
     }
     
     // Calculate card play score - higher is better
     double calculateMoveScore(const Card& card, 
                              const std::vector<Card>& hand,
-                             const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout,
-                             const std::map<int, int>& mySuitCounts) {
+                             const std::array<int, kMaxSuits>& mySuitCounts,
+                             size_t playableCount) {
         double score = 0.0;
         
         // PRIORITY 1: Play higher value cards (10-King) first when possible
@@ -262,11 +303,11 @@ private:
         
         // PRIORITY 3: Play cards that unlock opportunities for more plays
         // Check if playing this card will enable us to play more cards
-        int unlockedCards = countCardsUnlockedByPlaying(card, hand, tableLayout);
+        int unlockedCards = countCardsUnlockedByPlaying(card);
         score += unlockedCards * 20; // Very high bonus for unlocking our own cards
         
         // PRIORITY 4: Consider suit strategy
-        int suitCount = mySuitCounts.at(card.suit);
+        int suitCount = card.suit < kMaxSuits ? mySuitCounts[card.suit] : 0;
         
         // Try to get rid of suits with few cards
         if (suitCount <= 2) {
@@ -280,7 +321,7 @@ private:
         // PRIORITY 5: Block opponents if they seem to specialize in a suit
         bool isSuitStrengthForOpponent = false;
         for (const auto& [playerID, strengths] : playerSuitStrengths) {
-            if (playerID != myID && strengths.count(card.suit) > 0) {
+            if (playerID != myID && ((strengths >> card.suit) & 1)) {
                 isSuitStrengthForOpponent = true;
                 break;
             }
@@ -289,7 +330,7 @@ private:
         if (isSuitStrengthForOpponent) {
             // This is a key suit for an opponent - check if playing this would
             // create a gap that blocks them
-            bool createsGap = wouldCreateBlockingGap(card, tableLayout);
+            bool createsGap = wouldCreateBlockingGap(card);
             if (createsGap) {
                 score += 25; // Very high bonus for blocking opponents
             }
@@ -299,19 +340,12 @@ private:
         // But adjust based on game state and opponents' card counts
         if (card.rank == 7 || card.rank == 6 || card.rank == 8) {
             // Only hold onto critical cards if we have alternatives and it's not end game
-            std::vector<std::pair<int, Card>> playableCards;
-            for (size_t i = 0; i < hand.size(); ++i) {
-                if (isPlayable(hand[i], tableLayout)) {
-                    playableCards.emplace_back(static_cast<int>(i), hand[i]);
-                }
-            }
-            
-            bool hasAlternatives = playableCards.size() > 1;
+            bool hasAlternatives = playableCount > 1;
             
             // Check if any opponent is close to winning (has few cards)
             bool opponentIsCloseToWinning = false;
-            for (const auto& [playerID, cardCount] : playerCardCounts) {
-                if (playerID != myID && cardCount <= 3) {
+            for (const auto& [playerID, played] : playerCardsPlayed) {
+                if (playerID != myID && cardsLeft(played) <= 3) {
                     opponentIsCloseToWinning = true;
                     break;
                 }
@@ -345,7 +379,7 @@ private:
         }
         
         // NEW PRIORITY: Play cards that create runs we can follow up on
-        int potentialRun = calculatePotentialRun(card, hand, tableLayout);
+        int potentialRun = calculatePotentialRun(card);
         if (potentialRun >= 2) {
             score += potentialRun * 8; // Bonus for potential to play a run next turn
         }
@@ -370,117 +404,31 @@ private:
         return score;
     }
     
-    // Calculate how many cards in a potential run we can play
-    int calculatePotentialRun(const Card& card, 
-                           const std::vector<Card>& hand,
-                           const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) {
-        // Simulate playing this card
-        auto newTableLayout = tableLayout;
-        newTableLayout[card.suit][card.rank] = true;
-        
-        // Check if we have cards that would form a run after playing this one
-        int runSize = 1; // Start with the card we're playing
-        
-        // Look for ascending sequence (current rank + 1, +2, etc.)
-        runSize += runLength(card.suit, card.rank, 1, hand, newTableLayout);
-        
-        // Look for descending sequence (current rank - 1, -2, etc.)
-        runSize += runLength(card.suit, card.rank, -1, hand, newTableLayout);
-        
-        return runSize;
-    }
-    
-    // Helper method to calculate run length in a specific direction
-    int runLength(int suit, int startRank, int direction, 
-                 const std::vector<Card>& hand,
-                 std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>> layout) {
-        int length = 0;
-        int rank = startRank + direction;
-        
-        // Define bounds based on direction
-        int maxRank = (direction > 0) ? 14 : 0;
-        
-        while (rank != maxRank) {
-            bool haveCard = false;
-            for (const auto& handCard : hand) {
-                if (handCard.suit == suit && handCard.rank == rank) {
-                    // Check if this would be playable after we play our card
-                    if (isPlayable(handCard, layout)) {
-                        haveCard = true;
-                        break;
-                    }
-                }
-            }
-            if (haveCard) {
-                length++;
-                // Update simulated table for next iteration
-                layout[suit][rank] = true;
-                rank += direction;
-            } else {
-                break;
-            }
-        }
-        
-        return length;
+    // Calculate how many cards in a potential run we can play: the card, then our cards
+    // of consecutive ranks on both sides (each one is playable once the previous is down)
+    int calculatePotentialRun(const Card& card) const {
+        return 1 + static_cast<int>(Features::run(handRows[card.suit], card.rank - 1));
     }
     
     // Count how many of our cards would become playable after playing this card
-    int countCardsUnlockedByPlaying(const Card& card, 
-                                   const std::vector<Card>& hand,
-                                   const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>> tableLayout) {
-        int count = 0;
-        
-        // Create a copy of the table layout with this card added
-        auto newTableLayout = tableLayout;
-        newTableLayout[card.suit][card.rank] = true;
-        
-        // Check which cards would become playable that weren't before
-        for (const auto& potentialCard : hand) {
-            // Skip the card we're playing
-            if (potentialCard.suit == card.suit && potentialCard.rank == card.rank) {
-                continue;
-            }
-            
-            // If it wasn't playable before but would be after, count it
-            if (!isPlayable(potentialCard, tableLayout) && 
-                 isPlayable(potentialCard, newTableLayout)) {
-                count++;
-            }
-        }
-        
-        return count;
+    int countCardsUnlockedByPlaying(const Card& card) const {
+        return static_cast<int>(Features::unlocks(handRows[card.suit], tableRows[card.suit], 1u << (card.rank - 1)));
     }
     
     // Check if playing a card would create a gap that blocks opponents
-    bool wouldCreateBlockingGap(const Card& card, 
-                               const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) {
+    bool wouldCreateBlockingGap(const Card& card) const {
         // The blocking happens when we create a discontinuity like: 5 6 8 9
         // Where the 7 is missing and blocks progress
+        const unsigned row = tableRows[card.suit];
+        auto has = [row](int rank) { return rank >= 1 && rank <= 13 && ((row >> (rank - 1)) & 1); };
         
-        // Check for potential blocking gaps
         if (card.rank <= 5) { // Playing lower card - check for gaps above it
-            bool hasRankPlus1 = tableLayout.count(card.suit) > 0 && 
-                              tableLayout.at(card.suit).count(card.rank + 1) > 0 && 
-                              tableLayout.at(card.suit).at(card.rank + 1);
-                              
-            bool hasRankPlus2 = card.rank <= 11 && tableLayout.count(card.suit) > 0 && 
-                               tableLayout.at(card.suit).count(card.rank + 2) > 0 && 
-                               tableLayout.at(card.suit).at(card.rank + 2);
-                               
             // This would create a gap like: card, card+2 (missing card+1)
-            return !hasRankPlus1 && hasRankPlus2;
+            return !has(card.rank + 1) && has(card.rank + 2);
         }
         else if (card.rank >= 9) { // Playing higher card - check for gaps below it
-            bool hasRankMinus1 = tableLayout.count(card.suit) > 0 && 
-                               tableLayout.at(card.suit).count(card.rank - 1) > 0 && 
-                               tableLayout.at(card.suit).at(card.rank - 1);
-                               
-            bool hasRankMinus2 = card.rank >= 3 && tableLayout.count(card.suit) > 0 && 
-                                tableLayout.at(card.suit).count(card.rank - 2) > 0 && 
-                                tableLayout.at(card.suit).at(card.rank - 2);
-                                
             // This would create a gap like: card-2, card (missing card-1)
-            return !hasRankMinus1 && hasRankMinus2;
+            return !has(card.rank - 1) && has(card.rank - 2);
         }
         
         return false;
@@ -499,17 +447,23 @@ private:
         // they might be out of that suit or missing specific ranks
         
         // For now, just mark suits they've never played as potential weaknesses
-        for (int suit = 0; suit < 4; ++suit) {
-            if (strengths.count(suit) == 0) {
-                weaknesses.insert(suit);
-            }
-        }
+        weaknesses |= ~strengths & ((1u << kMaxSuits) - 1);
     }
 };
 
 } // namespace sevens
 
 // Export function for the loader — DO NOT place in the namespace
+#ifndef SEVENS_STATIC_STRATEGIES // compiled into the binary instead, see BuiltinStrategies.hpp
 extern "C" sevens::PlayerStrategy* createStrategy() {
     return new sevens::Sentinel7();
-}
\ No newline at end of file
+}
+
+extern "C" void seedStrategy(sevens::PlayerStrategy* strategy, uint64_t seed) {
+    static_cast<sevens::Sentinel7*>(strategy)->seed(seed);
+}
+
+extern "C" void useOpeningBook(const char* path) {
+    sevens::OpeningBook::activate(path);
+}
+#endif
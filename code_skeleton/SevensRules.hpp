@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Generic_card_parser.hpp"
+
+namespace sevens {
+
+/**
+ * Determine if a card is playable based on game rules
+ * - 7s can be played if not already on table
+ * - Other cards can be played if adjacent card of same suit is on table
+ *
+ * Shared by the engine (MyGameMapper) and the tools (sevens_bench, ...).
+ */
+inline bool isPlayable(const Card& c, const TableLayout& table) {
+    // 7s can be played if not already on table
+    if(c.rank == 7) return !table.count(c.suit) || !table.at(c.suit).count(7) || !table.at(c.suit).at(7);
+
+    // Other cards need adjacent card of same suit on table
+    bool lower = c.rank > 1  && table.count(c.suit) && table.at(c.suit).count(c.rank-1) && table.at(c.suit).at(c.rank-1);
+    bool upper = c.rank < 13 && table.count(c.suit) && table.at(c.suit).count(c.rank+1) && table.at(c.suit).at(c.rank+1);
+    return lower || upper;
+}
+
+} // namespace sevens
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "PlayerStrategy.hpp"
+#include "SevensRules.hpp"
+#include "AllocTracker.hpp"
+#include "GameArena.hpp"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Compile-time composed Sevens engine for large self-play runs.
+ *
+ *   StaticGame<Sentinel7, PrudentStrategy, PrudentStrategy> game(seed);
+ *   auto cardsLeft = game.play();
+ *
+ * The strategies are held by value and called with qualified (non-virtual) calls, so the
+ * compiler sees through selectCardToPlay / observeMove and can inline them. The player
+ * count is sizeof...(S) and the turn loop is a fold over the seats, i.e. unrolled.
+ * Rules and dealing are those of MyGameMapper::compute_game_progress.
+ */
+template <typename... S>
+class StaticGame {
+public:
+    static constexpr size_t kPlayers = sizeof...(S);
+    static_assert(kPlayers >= 2, "Sevens needs at least two players");
+
+    explicit StaticGame(uint64_t seed) : rng(static_cast<std::mt19937::result_type>(seed)) {
+        for (int suit = 0; suit < 4; ++suit)
+            for (int rank = 1; rank <= 13; ++rank) deck[suit * 13 + rank - 1] = Card{suit, rank};
+        if (AllocTracker::enabled) {
+            size_t i = 0;
+            std::apply([&](auto&... strat) { ((allocIds[i++] = AllocTracker::strategyId(strat.getName())), ...); }, seats);
+        }
+    }
+
+    void seed(uint64_t s) { rng.seed(static_cast<std::mt19937::result_type>(s)); }
+
+    std::tuple<S...>& strategies() { return seats; }
+
+    /**
+     * Plays one round and returns the number of cards left in each seat's hand.
+     */
+    std::array<uint64_t, kPlayers> play() {
+        deal();
+        initializeAll(std::index_sequence_for<S...>{});
+
+        passed.fill(false);
+        firstSeat = (startPlayer + 1) % kPlayers;  // the player after the one who opened with 7♦
+        gameOver = false;
+        while (!gameOver) {
+            playCycle(std::index_sequence_for<S...>{});
+            firstSeat = 0;
+        }
+
+        std::array<uint64_t, kPlayers> left{};
+        for (size_t i = 0; i < kPlayers; ++i) left[i] = hands[i].size();
+        return left;
+    }
+
+private:
+    std::tuple<S...> seats;
+    std::mt19937 rng;
+    std::array<Card, 52> deck;
+    std::array<std::vector<Card>, kPlayers> hands;
+    std::array<bool, kPlayers> passed{};
+    TableLayout table;
+    TableNodes tableNodes;
+    std::array<uint32_t, kPlayers> allocIds{};   // allocation accounting (AllocTracker.hpp)
+    size_t startPlayer = 0;
+    size_t firstSeat = 0;
+    bool gameOver = false;
+
+    void deal() {
+        std::shuffle(deck.begin(), deck.end(), rng);
+        startPlayer = rng() % kPlayers;
+        for (auto& h : hands) h.clear();
+        for (size_t i = 0; i < deck.size(); ++i) {
+            const Card& c = deck[i];
+            if (c.suit == 2 && c.rank == 7) continue;  // 7♦ starts on the table
+            hands[(startPlayer + i) % kPlayers].push_back(c);
+        }
+        // Sparse table, its nodes reused from one game to the next (see GameArena)
+        tableNodes.clear(table);
+        tableNodes.put(table, 2, 7);
+    }
+
+    template <size_t I>
+    using Strategy = std::tuple_element_t<I, std::tuple<S...>>;
+
+    template <size_t I>
+    Strategy<I>& seat() { return std::get<I>(seats); }
+
+    template <size_t I>
+    void initializeSeat() {
+        using T = Strategy<I>;
+        AllocScope scope(allocIds[I], StrategyCallback::Initialize);
+        seat<I>().T::initialize(I);
+    }
+
+    template <size_t... I>
+    void initializeAll(std::index_sequence<I...>) {
+        (initializeSeat<I>(), ...);
+    }
+
+    // One pass over the seats in order; stops at the first turn that ends the game
+    template <size_t... I>
+    void playCycle(std::index_sequence<I...>) {
+        (void)((I >= firstSeat && turn<I>()) || ...);
+    }
+
+    template <size_t I>
+    void notifySeat(uint64_t player, const Card& c) {
+        using T = Strategy<I>;
+        AllocScope scope(allocIds[I], StrategyCallback::ObserveMove);
+        seat<I>().T::observeMove(player, c);
+    }
+
+    template <size_t... I>
+    void notifyMove(uint64_t player, const Card& c, std::index_sequence<I...>) {
+        (notifySeat<I>(player, c), ...);
+    }
+
+    // Returns true when the game is over
+    template <size_t I>
+    bool turn() {
+        using T = Strategy<I>;
+        auto& hand = hands[I];
+        int idx;
+        {
+            AllocScope scope(allocIds[I], StrategyCallback::SelectCardToPlay);
+            idx = seat<I>().T::selectCardToPlay(hand, table);
+        }
+
+        if (idx >= 0 && static_cast<size_t>(idx) < hand.size() && isPlayable(hand[idx], table)) {
+            Card played = hand[idx];
+            tableNodes.put(table, played.suit, played.rank);
+            notifyMove(I, played, std::index_sequence_for<S...>{});
+            hand.erase(hand.begin() + idx);
+            passed[I] = false;
+            if (hand.empty()) gameOver = true;
+        } else {
+            AllocScope scope(allocIds[I], StrategyCallback::ObservePass);
+            seat<I>().T::observePass(I);
+            passed[I] = true;
+            gameOver = std::all_of(passed.begin(), passed.end(), [](bool p) { return p; });
+        }
+        return gameOver;
+    }
+};
+
+} // namespace sevens
@@ -1,11 +1,22 @@
 #include "StrategyLoader.hpp"
+#include "StrategyRegistry.hpp"
+#include "OpeningBook.hpp"
 #include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
 #include <stdexcept>
 #include <iostream>
 
 namespace sevens {
 
-std::shared_ptr<PlayerStrategy> StrategyLoader::loadFromLibrary(const std::string& libraryPath) {
+/**
+ * Ouvre la bibliothèque et récupère createStrategy (obligatoire) et seedStrategy (optionnel).
+ */
+static void* openStrategyLibrary(const std::string& libraryPath, CreateStrategyFn& create, SeedStrategyFn& seed) {
     std::cout << "[StrategyLoader] Tentative de chargement : " << libraryPath << std::endl;
 
     // Ouvrir la bibliothèque partagée
@@ -18,8 +29,7 @@ std::shared_ptr<PlayerStrategy> StrategyLoader::loadFromLibrary(const std::strin
     dlerror(); // Réinitialiser les erreurs précédentes
 
     // Récupérer le symbole de création de stratégie
-    using CreateStrategyFn = PlayerStrategy* (*)();
-    CreateStrategyFn create = reinterpret_cast<CreateStrategyFn>(dlsym(handle, "createStrategy"));
+    create = reinterpret_cast<CreateStrategyFn>(dlsym(handle, "createStrategy"));
 
     const char* error = dlerror();
     if (error != nullptr) {
@@ -27,6 +37,18 @@ std::shared_ptr<PlayerStrategy> StrategyLoader::loadFromLibrary(const std::strin
         throw std::runtime_error("Erreur lors du chargement de createStrategy : " + std::string(error));
     }
 
+    // Symbole optionnel : absent des anciennes stratégies, qui restent alors non reproductibles
+    seed = reinterpret_cast<SeedStrategyFn>(dlsym(handle, "seedStrategy"));
+    dlerror();
+
+    return handle;
+}
+
+std::shared_ptr<PlayerStrategy> StrategyLoader::loadFromLibrary(const std::string& libraryPath) {
+    CreateStrategyFn create = nullptr;
+    SeedStrategyFn seed = nullptr;
+    void* handle = openStrategyLibrary(libraryPath, create, seed);
+
     // Créer et retourner la stratégie
     PlayerStrategy* strategy = create();
     if (!strategy) {
@@ -38,4 +60,203 @@ std::shared_ptr<PlayerStrategy> StrategyLoader::loadFromLibrary(const std::strin
     return std::shared_ptr<PlayerStrategy>(strategy);
 }
 
+std::shared_ptr<PlayerStrategy> StrategyLoader::load(const std::string& spec) {
+    const std::string prefix = kBuiltinPrefix;
+    if (spec.compare(0, prefix.size(), prefix) == 0) {
+        return StrategyRegistry::create(spec.substr(prefix.size()));
+    }
+    return loadFromLibrary(spec);
+}
+
+bool StrategyLoader::isStrategySpec(const std::string& arg) {
+    return arg.find(".so") != std::string::npos || arg.rfind(kBuiltinPrefix, 0) == 0;
+}
+
+// -----------------------------------------------------------------------------
+// StrategyFactory
+// -----------------------------------------------------------------------------
+
+/**
+ * What the copies of a factory share: the current build, and for a watched .so the file
+ * as it was when that build was loaded and as it was at the last look.
+ */
+struct StrategyFactory::Watched {
+    std::mutex mutex;
+    std::shared_ptr<const Build> build;
+    std::string book;                         // opening book given to every new build
+    bool on = false;
+    bool loading = false;                     // one thread loads, the others keep the current build
+    std::chrono::steady_clock::time_point nextLook;
+    std::string loaded;                       // fileState() of the file behind the build
+    std::string seen;                         // fileState() at the last look
+};
+
+namespace {
+
+// Size, inode and modification time of the file ("" when it cannot be read)
+std::string fileState(const std::string& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) return "";
+    return std::to_string(st.st_size) + ':' + std::to_string(st.st_ino) + ':' +
+           std::to_string(st.st_mtim.tv_sec) + '.' + std::to_string(st.st_mtim.tv_nsec);
+}
+
+} // namespace
+
+StrategyFactory::StrategyFactory(const std::string& spec, bool watched)
+    : spec_(spec), state(std::make_shared<Watched>()) {
+    const std::string prefix = StrategyLoader::kBuiltinPrefix;
+    if (spec.compare(0, prefix.size(), prefix) == 0) {
+        std::shared_ptr<Build> build(new Build());
+        build->spec = spec;
+        build->builtin = spec.substr(prefix.size());
+        build->batchFn = StrategyRegistry::batch(build->builtin);
+        state->build = build;
+        seedable_ = true;
+    } else {
+        state->on = watched;
+        state->nextLook = std::chrono::steady_clock::now();
+        state->loaded = fileState(spec);
+        state->build = loadBuild(spec, 0, watched);
+        seedable_ = (state->build->seedFn != nullptr);
+        if (!seedable_) {
+            std::cout << "[StrategyLoader] " << spec << " n'exporte pas seedStrategy : "
+                         "ses parties ne seront pas reproductibles" << std::endl;
+        }
+    }
+    name_ = create(0)->getName();
+}
+
+/**
+ * Opens a build of the .so strategy. A watched one is opened from a private copy of the
+ * file, removed as soon as it is mapped: dlopen would hand back the library already
+ * loaded under the same name, and the file can then be rewritten in place while games
+ * still run on the build. The copy is numbered for the whole process, so two strategies
+ * with the same file name in different directories get distinct copies.
+ */
+std::shared_ptr<StrategyFactory::Build> StrategyFactory::loadBuild(const std::string& spec, uint64_t id, bool copy) {
+    std::shared_ptr<Build> build(new Build());
+    build->spec = spec;
+    build->id = id;
+
+    std::string open = spec;
+    if (copy) {
+        namespace fs = std::filesystem;
+        static std::atomic<uint64_t> copies{0};
+        open = (fs::temp_directory_path() / ("sevens-" + std::to_string(::getpid()) + "-" + std::to_string(copies++) +
+                                             "-build" + std::to_string(id) + "-" +
+                                             fs::path(spec).filename().string())).string();
+        fs::copy_file(spec, open, fs::copy_options::overwrite_existing);
+    }
+    try {
+        build->handle = openStrategyLibrary(open, build->createFn, build->seedFn);
+    } catch (...) {
+        if (copy) ::unlink(open.c_str());
+        throw;
+    }
+    if (copy) ::unlink(open.c_str());
+    build->bookFn = reinterpret_cast<UseOpeningBookFn>(dlsym(build->handle, "useOpeningBook"));
+    build->batchFn = reinterpret_cast<SelectCardsBatchFn>(dlsym(build->handle, "selectCardsBatch"));
+    dlerror();
+    return build;
+}
+
+// The build in use stays loaded until the end of the process, as without reloads
+StrategyFactory::Build::~Build() {
+    if (!handle || !retired) return;
+    std::cout << "[StrategyLoader] " << spec << " : build " << id << " déchargé" << std::endl;
+    dlclose(handle);
+}
+
+std::shared_ptr<PlayerStrategy> StrategyFactory::Build::create(uint64_t seed) const {
+    if (!builtin.empty()) return StrategyRegistry::create(builtin, seed);
+
+    PlayerStrategy* strategy = createFn();
+    if (!strategy) {
+        throw std::runtime_error("Échec de la création de la stratégie depuis " + spec);
+    }
+    if (seedFn) seedFn(strategy, seed);
+
+    // The instance keeps its library loaded: its destructor and vtable live there
+    std::shared_ptr<const Build> self = shared_from_this();
+    return std::shared_ptr<PlayerStrategy>(strategy, [self](PlayerStrategy* s) { delete s; });
+}
+
+void StrategyFactory::Build::seed(PlayerStrategy& strategy, uint64_t seed) const {
+    if (!builtin.empty()) {
+        StrategyRegistry::seed(builtin, strategy, seed);
+    } else if (seedFn) {
+        seedFn(&strategy, seed);
+    }
+}
+
+/**
+ * When watched, looks at the file at most every kWatchSeconds. A file that changed since
+ * the current build and has not changed since the previous look is loaded as the next
+ * build, outside the lock: meanwhile the other threads keep getting the current one. A
+ * build that cannot be loaded (broken .so) is reported and skipped until the file
+ * changes again.
+ */
+std::shared_ptr<const StrategyFactory::Build> StrategyFactory::current() const {
+    Watched& w = *state;
+    std::unique_lock<std::mutex> lock(w.mutex);
+    if (!w.on || w.loading) return w.build;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now < w.nextLook) return w.build;
+    w.nextLook = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                           std::chrono::duration<double>(kWatchSeconds));
+
+    const std::string file = fileState(spec_);
+    const bool settled = file == w.seen;
+    w.seen = file;
+    if (file.empty() || file == w.loaded || !settled) return w.build;
+
+    w.loading = true;
+    w.loaded = file;
+    const uint64_t id = w.build->id + 1;
+    const std::string book = w.book;
+    lock.unlock();
+
+    std::shared_ptr<Build> build;
+    try {
+        build = loadBuild(spec_, id, true);
+        if (!book.empty() && build->bookFn) build->bookFn(book.c_str());
+        build->create(0);   // a library that cannot create its strategy is not used
+        std::cout << "[StrategyLoader] " << spec_ << " modifié : build " << id
+                  << " pour les nouveaux matchs (les matchs en cours finissent sur le build " << id - 1 << ")"
+                  << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "[StrategyLoader] " << spec_ << " modifié mais pas rechargé : " << e.what() << std::endl;
+        build.reset();
+    }
+
+    lock.lock();
+    w.loading = false;
+    if (build) {
+        w.build->retired = true;
+        w.build = build;
+    }
+    return w.build;
+}
+
+bool StrategyFactory::useOpeningBook(const std::string& path) const {
+    std::shared_ptr<const Build> build = current();
+    if (!build->builtin.empty()) {
+        OpeningBook::activate(path);   // the builtin strategies share this binary's book
+        return true;
+    }
+    if (!build->bookFn) {
+        std::cout << "[StrategyLoader] " << spec_ << " n'exporte pas useOpeningBook : livre d'ouvertures ignoré"
+                  << std::endl;
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->book = path;
+    }
+    build->bookFn(path.c_str());
+    return true;
+}
+
 } // namespace sevens
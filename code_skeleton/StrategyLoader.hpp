@@ -1,6 +1,7 @@
 #pragma once
 
 #include "PlayerStrategy.hpp"
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -13,6 +14,104 @@ class StrategyLoader {
 public:
     // Déclaration seulement — l'implémentation est dans StrategyLoader.cpp
     static std::shared_ptr<PlayerStrategy> loadFromLibrary(const std::string& libraryPath);
+
+    // "builtin:<Name>" → stratégie compilée dans le binaire (StrategyRegistry),
+    // sinon chemin d'une bibliothèque .so
+    static std::shared_ptr<PlayerStrategy> load(const std::string& spec);
+
+    // true si l'argument désigne une stratégie (.so ou builtin:) — utilisé par main
+    static bool isStrategySpec(const std::string& arg);
+
+    static constexpr const char* kBuiltinPrefix = "builtin:";
+};
+
+/**
+ * Loads one strategy (builtin:<Name> or .so path) once and creates as many independent
+ * instances as needed, e.g. one per match in the parallel runners.
+ * When the strategy exports seedStrategy (all shipped ones do), create(seed) is reproducible.
+ *
+ * Hot reload (watched): a .so rebuilt during a long run is loaded again, next to the
+ * previous build, and the instances created from then on come from the new one. Every
+ * instance keeps the build it was created from, so games in progress finish on it; the
+ * old library is closed once its last instance is gone. Each build is opened from a
+ * private copy of the file, so a build can be written over the path in use.
+ */
+class StrategyFactory {
+public:
+    /**
+     * One loaded version of the strategy. Instances created from it hold it: the library
+     * stays mapped until the factory has a newer build and the last of them is destroyed.
+     */
+    class Build : public std::enable_shared_from_this<Build> {
+    public:
+        ~Build();   // closes the library of a build replaced by a reload
+
+        Build(const Build&) = delete;
+        Build& operator=(const Build&) = delete;
+
+        std::shared_ptr<PlayerStrategy> create(uint64_t seed) const;
+
+        // Seeds again an instance created from this build (no effect without seedStrategy)
+        void seed(PlayerStrategy& strategy, uint64_t seed) const;
+
+        // selectCardsBatch export (builtin or .so), nullptr when the strategy only has selectCardToPlay
+        SelectCardsBatchFn batch() const { return batchFn; }
+
+        // 0 = loaded at start, then 1, 2, ... one per reload (the build column of the results)
+        uint64_t number() const { return id; }
+
+    private:
+        friend class StrategyFactory;
+        Build() = default;
+
+        std::string spec;
+        std::string builtin;                  // registry name for builtin:<Name>
+        uint64_t id = 0;
+        void* handle = nullptr;               // .so entry points
+        CreateStrategyFn createFn = nullptr;
+        SeedStrategyFn seedFn = nullptr;
+        UseOpeningBookFn bookFn = nullptr;
+        SelectCardsBatchFn batchFn = nullptr;
+        mutable std::atomic<bool> retired{false};   // a newer build has replaced it
+    };
+
+    // How often a watched factory looks at the file; a change is loaded once the file has
+    // stayed the same for one more look (the linker may still be writing it)
+    static constexpr double kWatchSeconds = 1.0;
+
+    // watched: reload the .so when it changes (no effect on builtin strategies)
+    explicit StrategyFactory(const std::string& spec, bool watched = false);
+
+    // Build the next instances come from (checks the file first when watched); a runner takes
+    // it once per match so that all the seats of a match play the same build. Copies of the
+    // factory share the builds.
+    std::shared_ptr<const Build> current() const;
+
+    std::shared_ptr<PlayerStrategy> create(uint64_t seed) const { return current()->create(seed); }
+
+    // Build::seed of the current build: for instances of a factory that is not watched
+    void seed(PlayerStrategy& strategy, uint64_t seed) const { current()->seed(strategy, seed); }
+
+    // Opening book (OpeningBook.hpp) for the instances created from now on, "" = none.
+    // False when a .so strategy does not export useOpeningBook.
+    bool useOpeningBook(const std::string& path) const;
+
+    const std::string& spec() const { return spec_; }
+    const std::string& name() const { return name_; }   // getName() of the strategy
+    bool seedable() const { return seedable_; }
+
+    // selectCardsBatch of the current build
+    SelectCardsBatchFn batch() const { return current()->batch(); }
+
+private:
+    struct Watched;                       // current build and file state, shared by the copies
+
+    std::string spec_;
+    std::string name_;
+    bool seedable_ = false;
+    std::shared_ptr<Watched> state;
+
+    static std::shared_ptr<Build> loadBuild(const std::string& spec, uint64_t id, bool copy);
 };
 
 } // namespace sevens
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "StrategyRegistry.hpp"
+#include "BuiltinStrategies.hpp"
+
+#include <map>
+#include <stdexcept>
+
+namespace sevens {
+
+namespace {
+
+using Factory = std::shared_ptr<PlayerStrategy> (*)(bool seeded, uint64_t seed);
+
+template <typename S>
+std::shared_ptr<PlayerStrategy> makeBuiltin(bool seeded, uint64_t seed) {
+    auto strategy = std::make_shared<S>();
+    if (seeded) strategy->seed(seed);
+    return strategy;
+}
+
+// seedStrategy of a builtin, on an instance created by makeBuiltin<S>
+template <typename S>
+void seedBuiltin(PlayerStrategy* strategy, uint64_t seed) {
+    static_cast<S*>(strategy)->seed(seed);
+}
+
+struct Builtin {
+    Factory create;
+    SelectCardsBatchFn batch;   // nullptr = selectCardToPlay only
+    SeedStrategyFn seed;
+};
+
+const std::map<std::string, Builtin>& factories() {
+    static const std::map<std::string, Builtin> table = {
+        {"RandomAgressiveStrategy", {&makeBuiltin<RandomAgressiveStrategy>, nullptr, &seedBuiltin<RandomAgressiveStrategy>}},
+        {"PrudentStrategy",         {&makeBuiltin<PrudentStrategy>, nullptr, &seedBuiltin<PrudentStrategy>}},
+        {"CalculativeStrategy",     {&makeBuiltin<CalculativeStrategy>, nullptr, &seedBuiltin<CalculativeStrategy>}},
+        {"Sentinel7",               {&makeBuiltin<Sentinel7>, nullptr, &seedBuiltin<Sentinel7>}},
+        {"LearnedStrategy",         {&makeBuiltin<LearnedStrategy>, &LearnedStrategy::selectCardsBatch, &seedBuiltin<LearnedStrategy>}},
+        {"CfrStrategy",             {&makeBuiltin<CfrStrategy>, nullptr, &seedBuiltin<CfrStrategy>}},
+        {"MonteCarloStrategy",      {&makeBuiltin<MonteCarloStrategy>, nullptr, &seedBuiltin<MonteCarloStrategy>}},
+    };
+    return table;
+}
+
+const Builtin& lookup(const std::string& name) {
+    auto it = factories().find(name);
+    if (it == factories().end()) {
+        throw std::runtime_error("Unknown builtin strategy : " + name);
+    }
+    return it->second;
+}
+
+} // namespace
+
+bool StrategyRegistry::contains(const std::string& name) {
+    return factories().count(name) > 0;
+}
+
+std::shared_ptr<PlayerStrategy> StrategyRegistry::create(const std::string& name) {
+    return lookup(name).create(false, 0);
+}
+
+std::shared_ptr<PlayerStrategy> StrategyRegistry::create(const std::string& name, uint64_t seed) {
+    return lookup(name).create(true, seed);
+}
+
+void StrategyRegistry::seed(const std::string& name, PlayerStrategy& strategy, uint64_t seed) {
+    lookup(name).seed(&strategy, seed);
+}
+
+SelectCardsBatchFn StrategyRegistry::batch(const std::string& name) {
+    return lookup(name).batch;
+}
+
+std::vector<std::string> StrategyRegistry::names() {
+    std::vector<std::string> out;
+    for (const auto& [name, factory] : factories()) out.push_back(name);
+    return out;
+}
+
+} // namespace sevens
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "PlayerStrategy.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Registry of the strategies compiled into the binary
+ * (RandomAgressiveStrategy, PrudentStrategy, CalculativeStrategy, Sentinel7, LearnedStrategy,
+ * CfrStrategy, MonteCarloStrategy).
+ * On the command line they are selected with "builtin:<Name>", see StrategyLoader::load.
+ */
+class StrategyRegistry {
+public:
+    static bool contains(const std::string& name);
+
+    // Throws std::runtime_error for an unknown name
+    static std::shared_ptr<PlayerStrategy> create(const std::string& name);
+
+    // Same, with the strategy's random generator seeded (reproducible runs)
+    static std::shared_ptr<PlayerStrategy> create(const std::string& name, uint64_t seed);
+
+    // Seeds again an instance created by create(name, ...)
+    static void seed(const std::string& name, PlayerStrategy& strategy, uint64_t seed);
+
+    // Batched decisions of the strategy (see SelectCardsBatchFn), nullptr when it has none
+    static SelectCardsBatchFn batch(const std::string& name);
+
+    static std::vector<std::string> names();
+};
+
+} // namespace sevens
@@ -0,0 +1,79 @@
+#include "Symmetry.hpp"
+
+namespace sevens {
+
+namespace {
+
+// Row of one suit in a card mask (bit rank - 1)
+inline uint64_t row(uint64_t cards, int suit) {
+    return (cards >> (13 * suit)) & 0x1FFF;
+}
+
+// Compares two suits by content: table row first, then the row of each hand in seat order
+int compareSuits(int a, int b, uint64_t table, const uint64_t* hands, unsigned players) {
+    uint64_t x = row(table, a), y = row(table, b);
+    if (x != y) return x < y ? -1 : 1;
+    for (unsigned p = 0; p < players; ++p) {
+        x = row(hands[p], a);
+        y = row(hands[p], b);
+        if (x != y) return x < y ? -1 : 1;
+    }
+    return 0;
+}
+
+// splitmix64 finalizer
+inline uint64_t mix(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+SuitPermutation SuitSymmetry::canonicalPermutation(uint64_t table, const uint64_t* hands, unsigned players,
+                                                   unsigned freeSuits) {
+    // Movable suits, sorted by content (insertion sort, 4 keys at most)
+    int slots[4];
+    int order[4];
+    int n = 0;
+    for (int s = 0; s < 4; ++s) {
+        if (!((freeSuits >> s) & 1)) continue;
+        slots[n] = s;
+        int i = n++;
+        while (i > 0 && compareSuits(s, order[i - 1], table, hands, players) < 0) {
+            order[i] = order[i - 1];
+            --i;
+        }
+        order[i] = s;
+    }
+
+    // The smallest content goes to the lowest movable suit, and so on
+    SuitPermutation perm;
+    for (int i = 0; i < n; ++i) perm.to[order[i]] = slots[i];
+    return perm;
+}
+
+SuitPermutation SuitSymmetry::canonicalize(uint64_t& table, uint64_t* hands, unsigned players, unsigned freeSuits) {
+    SuitPermutation perm = canonicalPermutation(table, hands, players, freeSuits);
+    table = perm.apply(table);
+    for (unsigned p = 0; p < players; ++p) hands[p] = perm.apply(hands[p]);
+    return perm;
+}
+
+Position SuitSymmetry::canonical(const Position& p, unsigned freeSuits) {
+    Position c = p;
+    canonicalize(c.table, c.hands.data(), static_cast<unsigned>(c.hands.size()), freeSuits);
+    return c;
+}
+
+uint64_t SuitSymmetry::hash(uint64_t table, const uint64_t* hands, unsigned players, unsigned freeSuits,
+                            uint64_t extra) {
+    SuitPermutation perm = canonicalPermutation(table, hands, players, freeSuits);
+    uint64_t h = mix(mix(players) ^ extra);
+    h = mix(h ^ perm.apply(table));
+    for (unsigned p = 0; p < players; ++p) h = mix(h ^ perm.apply(hands[p]));
+    return h;
+}
+
+} // namespace sevens
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Suit symmetry of the 52-card game.
+ *
+ * The rules treat the four suits alike; only the opening (7♦ on the table) singles out
+ * diamonds. Two deals that differ by a permutation of spades, hearts and clubs are the same
+ * deal, and two positions that differ by any permutation of the suits (the table is part of
+ * the position) are the same position. canonicalize() picks one representative per class:
+ * the movable suits are sorted by their content (table row, then each hand's row), so the
+ * work is a sort of at most four keys, not a search over the 24 permutations.
+ *
+ * Cards are masks with bit suit * 13 + rank - 1 (the card id used everywhere else).
+ */
+struct SuitPermutation {
+    std::array<int, 4> to{{0, 1, 2, 3}};   // original suit s becomes suit to[s]
+
+    uint64_t apply(uint64_t cards) const {
+        uint64_t out = 0;
+        for (int s = 0; s < 4; ++s) out |= ((cards >> (13 * s)) & 0x1FFF) << (13 * to[s]);
+        return out;
+    }
+};
+
+/**
+ * A perfect-information position (or a deal: table = 7♦ only).
+ */
+struct Position {
+    uint64_t table = 0;            // cards on the table
+    std::vector<uint64_t> hands;   // one mask per player
+};
+
+class SuitSymmetry {
+public:
+    // Bit s set = suit s may be permuted
+    static constexpr unsigned kDealSuits = 0b1011;       // spades, hearts, clubs (7♦ opening)
+    static constexpr unsigned kPositionSuits = 0b1111;   // all of them, the table tells them apart
+
+    // Permutation that maps (table, hands) to its canonical representative
+    static SuitPermutation canonicalPermutation(uint64_t table, const uint64_t* hands, unsigned players,
+                                                unsigned freeSuits);
+
+    // In place; returns the permutation that was applied
+    static SuitPermutation canonicalize(uint64_t& table, uint64_t* hands, unsigned players, unsigned freeSuits);
+    static Position canonical(const Position& p, unsigned freeSuits);
+
+    /**
+     * Hash of the canonical representative: equal for every symmetric variant, and stable
+     * (same value on every machine and every run, unlike std::hash), so it can be stored.
+     * extra: anything else that identifies the position (player to move, passes, ...).
+     */
+    static uint64_t hash(uint64_t table, const uint64_t* hands, unsigned players, unsigned freeSuits,
+                         uint64_t extra = 0);
+    static uint64_t hash(const Position& p, unsigned freeSuits, uint64_t extra = 0) {
+        return hash(p.table, p.hands.data(), static_cast<unsigned>(p.hands.size()), freeSuits, extra);
+    }
+};
+
+} // namespace sevens
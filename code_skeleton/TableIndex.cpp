@@ -0,0 +1,85 @@
+#include "TableIndex.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace sevens {
+
+SuitStates::SuitStates(unsigned startRow) : startRow(startRow & 0x1FFF), index(1 << 13, kUnreachable) {
+    // Every row a round can reach from the start row (a 7, or a neighbour of the row)
+    std::vector<bool> seen(1 << 13, false);
+    std::vector<uint16_t> todo{static_cast<uint16_t>(this->startRow)};
+    seen[this->startRow] = true;
+    while (!todo.empty()) {
+        const unsigned row = todo.back();
+        todo.pop_back();
+        rows.push_back(static_cast<uint16_t>(row));
+        for (unsigned next = ((row << 1) | (row >> 1) | 0x40) & 0x1FFF & ~row; next; next &= next - 1) {
+            const unsigned grown = row | (next & (0u - next));
+            if (seen[grown]) continue;
+            seen[grown] = true;
+            todo.push_back(static_cast<uint16_t>(grown));
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    for (size_t i = 0; i < rows.size(); ++i) index[rows[i]] = static_cast<uint16_t>(i);
+}
+
+TableIndex::TableIndex() {
+    build({0, 0, 1u << 6, 0});
+}
+
+TableIndex::TableIndex(RulesConfig rules) {
+    rules.validate();
+    std::vector<unsigned> startRows(rules.suits(), 0);
+    for (const Card& c : rules.startCards) startRows[c.suit] |= 1u << (c.rank - 1);
+    build(startRows);
+}
+
+void TableIndex::build(const std::vector<unsigned>& startRows) {
+    for (unsigned row : startRows) {
+        auto same = std::find_if(classes.begin(), classes.end(), [&](const SuitStates& c) { return c.start() == row; });
+        suitClass.push_back(static_cast<unsigned>(same - classes.begin()));
+        if (same == classes.end()) classes.emplace_back(row);
+    }
+
+    fits = true;
+    tables = 1;
+    for (unsigned s = 0; s < suits(); ++s) {
+        const uint64_t n = suit(s).size();
+        if (tables > std::numeric_limits<uint64_t>::max() / n) {
+            fits = false;
+            tables = 0;
+            break;
+        }
+        tables *= n;
+    }
+}
+
+uint64_t TableIndex::deckSize(unsigned d) const {
+    uint64_t n = 1;
+    for (unsigned s = d * RulesConfig::kSuitsPerDeck; s < (d + 1) * RulesConfig::kSuitsPerDeck; ++s) n *= suit(s).size();
+    return n;
+}
+
+uint64_t TableIndex::rankSuits(const uint64_t* words, unsigned first, unsigned count) const {
+    uint64_t index = 0;
+    for (unsigned s = first + count; s-- > first;) {
+        const SuitStates& states = suit(s);
+        const unsigned state = states.rank(static_cast<unsigned>(words[s / 4] >> (13 * (s % 4))));
+        if (state == SuitStates::kUnreachable) return kUnreachable;
+        index = index * states.size() + state;
+    }
+    return index;
+}
+
+void TableIndex::unrankSuits(uint64_t index, uint64_t* words, unsigned first, unsigned count) const {
+    for (unsigned s = first; s < first + count; ++s) {
+        const SuitStates& states = suit(s);
+        const uint64_t row = states.unrank(static_cast<unsigned>(index % states.size()));
+        index /= states.size();
+        words[s / 4] = (words[s / 4] & ~(uint64_t(0x1FFF) << (13 * (s % 4)))) | row << (13 * (s % 4));
+    }
+}
+
+} // namespace sevens
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "VariantGame.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Reachable states of one suit of the table, numbered densely.
+ *
+ * A row is the ranks of the suit on the table (bit rank - 1). From the start cards of
+ * the suit, a row only grows by a 7 or by a neighbour of a card already on it, so with
+ * the usual 7 opening a suit is either closed or one run around its 7: 50 states (49
+ * when the 7 is a start card). States are numbered by increasing row value, which keeps
+ * the order SuitSymmetry sorts suits by.
+ */
+class SuitStates {
+public:
+    static constexpr unsigned kUnreachable = 0xFFFF;
+
+    explicit SuitStates(unsigned startRow = 0);
+
+    unsigned size() const { return static_cast<unsigned>(rows.size()); }
+    unsigned start() const { return startRow; }
+
+    // Dense number of a row, kUnreachable when no round can lay it out
+    unsigned rank(unsigned row) const { return index[row & 0x1FFF]; }
+    unsigned unrank(unsigned state) const { return rows[state]; }
+
+private:
+    unsigned startRow;
+    std::vector<uint16_t> rows;    // ascending
+    std::vector<uint16_t> index;   // row → state, 8192 entries
+};
+
+/**
+ * Dense numbering of whole tables: mixed radix of the suit states, suit 0 the lowest
+ * digit. Tables are read as CardSet words (suit s on bits (s % 4) * 13 of word s / 4),
+ * so the 52-card game passes its one card mask.
+ *
+ * The standard game (four suits, 7♦ on the table) has 50^3 * 49 = 6 125 000 tables, so
+ * a cache or a tablebase keyed by the table is a flat array. With more decks the count
+ * outgrows 64 bits from three decks on (dense() is false): rankDeck() numbers the
+ * tables deck by deck (at most 50^4 each) and the caller combines them.
+ */
+class TableIndex {
+public:
+    static constexpr uint64_t kUnreachable = ~0ull;
+
+    // The 52-card game: 7♦ on the table
+    TableIndex();
+    // A variant; throws std::invalid_argument as RulesConfig::validate()
+    explicit TableIndex(RulesConfig rules);
+
+    unsigned suits() const { return static_cast<unsigned>(suitClass.size()); }
+    const SuitStates& suit(unsigned s) const { return classes[suitClass[s]]; }
+
+    // True when every table has a 64-bit number; size() is then the number of tables
+    bool dense() const { return fits; }
+    uint64_t size() const { return tables; }
+
+    // kUnreachable when a suit holds a row no round can lay out
+    uint64_t rank(const uint64_t* words) const { return rankSuits(words, 0, suits()); }
+    void unrank(uint64_t index, uint64_t* words) const { unrankSuits(index, words, 0, suits()); }
+
+    // Same numbering restricted to the four suits of deck d (always fits)
+    uint64_t rankDeck(const uint64_t* words, unsigned d) const {
+        return rankSuits(words, d * RulesConfig::kSuitsPerDeck, RulesConfig::kSuitsPerDeck);
+    }
+    void unrankDeck(uint64_t index, uint64_t* words, unsigned d) const {
+        unrankSuits(index, words, d * RulesConfig::kSuitsPerDeck, RulesConfig::kSuitsPerDeck);
+    }
+    uint64_t deckSize(unsigned d) const;
+
+private:
+    uint64_t rankSuits(const uint64_t* words, unsigned first, unsigned count) const;
+    void unrankSuits(uint64_t index, uint64_t* words, unsigned first, unsigned count) const;
+    void build(const std::vector<unsigned>& startRows);
+
+    std::vector<SuitStates> classes;   // one per distinct start row
+    std::vector<unsigned> suitClass;
+    uint64_t tables = 0;
+    bool fits = false;
+};
+
+} // namespace sevens
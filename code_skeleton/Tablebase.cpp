@@ -0,0 +1,352 @@
+#include "Tablebase.hpp"
+#include "Symmetry.hpp"
+#include "TableIndex.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace sevens {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'V', 'N', 'S', 'T', 'B', 'A', 'S'};
+constexpr uint64_t kDeck = (1ull << 52) - 1;
+constexpr uint64_t kAces = 1ull | 1ull << 13 | 1ull << 26 | 1ull << 39;
+constexpr uint64_t kKings = kAces << 12;
+constexpr uint64_t kSevens = kAces << 6;
+constexpr unsigned kPass = 63;
+
+template <typename T>
+void put(unsigned char* at, T v) {
+    for (size_t i = 0; i < sizeof(T); ++i) at[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+template <typename T>
+T get(const unsigned char* at) {
+    T v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) v |= static_cast<T>(at[i]) << (8 * i);
+    return v;
+}
+
+// Same rule as CardSet::playableOn, on the 52-card word
+inline uint64_t playableOn(uint64_t table) {
+    const uint64_t next = ((table << 1) & ~kAces) | ((table >> 1) & ~kKings);
+    return (next | kSevens) & ~table & kDeck;
+}
+
+// Number of a canonical table (rows sorted, so the suit states q0 <= q1 <= q2 <= q3) among
+// the C(53, 4) multisets of four suit states: combinatorial number system
+inline uint64_t tableShape(const unsigned* q) {
+    const uint64_t c1 = q[1] + 1, c2 = q[2] + 2, c3 = q[3] + 3;
+    return q[0] + c1 * (c1 - 1) / 2 + c2 * (c2 - 1) * (c2 - 2) / 6 + c3 * (c3 - 1) * (c3 - 2) * (c3 - 3) / 24;
+}
+
+// Suit states of the 52-card game as the tablebase sees them: any suit may be closed,
+// the canonical form moves suits around
+const SuitStates& suitStates() {
+    static const SuitStates states(0);
+    return states;
+}
+
+constexpr uint64_t kShapes = 53ull * 52 * 51 * 50 / 24;
+
+// Entries of a table with n cards left: one per owner of each card and count of passes
+inline uint64_t entriesFor(unsigned n, unsigned players, unsigned maxCards) {
+    if (n < players || n > maxCards) return 0;
+    uint64_t e = players;
+    for (unsigned i = 0; i < n; ++i) e *= players;
+    return e;
+}
+
+/**
+ * Entry of a canonical position within its table: owners of the cards left, by increasing
+ * card id, as base-players digits, then the passes.
+ */
+inline uint64_t entryOf(uint64_t held, const uint64_t* hands, unsigned players, unsigned passes) {
+    uint64_t owners = 0, digit = 1;
+    for (; held; held &= held - 1) {
+        const uint64_t bit = held & (0 - held);
+        unsigned p = 0;
+        while (!(hands[p] & bit)) ++p;
+        owners += p * digit;
+        digit *= players;
+    }
+    return owners * players + passes;
+}
+
+/**
+ * Canonical form of a position seen from the mover: suits sorted (SuitSymmetry), table
+ * shape and entry within it. False when a suit cannot be laid out by a round.
+ */
+inline bool locate(uint64_t* hands, unsigned players, unsigned passes, SuitPermutation& perm, uint64_t& shape,
+                   uint64_t& entry) {
+    uint64_t held = 0;
+    for (unsigned p = 0; p < players; ++p) held |= hands[p];
+    uint64_t onTable = kDeck & ~held;
+    perm = SuitSymmetry::canonicalize(onTable, hands, players, SuitSymmetry::kPositionSuits);
+    unsigned q[4];
+    for (int s = 0; s < 4; ++s) {
+        q[s] = suitStates().rank(static_cast<unsigned>(onTable >> (13 * s)));
+        if (q[s] == SuitStates::kUnreachable) return false;
+    }
+    shape = tableShape(q);
+    entry = entryOf(kDeck & ~onTable, hands, players, passes);
+    return true;
+}
+
+/**
+ * Memoized max^n search, straight into the flat array of the tablebase. Positions are seen
+ * from the mover (hands[0]); the value of a child, seen from the next seat, is rotated back
+ * by one nibble. Entry 0 = not solved (a solved position always leaves cards to someone).
+ */
+class Solver {
+public:
+    Solver(unsigned players, unsigned maxCards)
+        : nP(players), mask16((1u << (4 * players)) - 1), offsets(kShapes + 1, 0) {
+        // Size of every table shape, from its four suit states
+        const SuitStates& states = suitStates();
+        for (unsigned a = 0; a < states.size(); ++a)
+        for (unsigned b = a; b < states.size(); ++b)
+        for (unsigned c = b; c < states.size(); ++c)
+        for (unsigned d = c; d < states.size(); ++d) {
+            const unsigned q[4] = {a, b, c, d};
+            const unsigned onTable = __builtin_popcount(states.unrank(a)) + __builtin_popcount(states.unrank(b)) +
+                                     __builtin_popcount(states.unrank(c)) + __builtin_popcount(states.unrank(d));
+            offsets[tableShape(q) + 1] = entriesFor(52 - onTable, players, maxCards);
+        }
+        for (uint64_t t = 0; t < kShapes; ++t) offsets[t + 1] += offsets[t];
+        values.assign(offsets[kShapes], 0);
+    }
+
+    uint32_t solve(std::array<uint64_t, 4> hands, unsigned passes) {
+        SuitPermutation perm;
+        uint64_t shape = 0, entry = 0;
+        if (!locate(hands.data(), nP, passes, perm, shape, entry)) {
+            throw std::runtime_error("Tablebase : position hors des états de table atteignables");
+        }
+        uint32_t& value = values[offsets[shape] + entry];
+        if (value) return value;
+
+        uint64_t held = 0;
+        for (unsigned p = 0; p < nP; ++p) held |= hands[p];
+        const uint64_t onTable = kDeck & ~held;
+
+        uint32_t best = 0;
+        int bestOwn = 16, bestOthers = -1;
+        auto consider = [&](uint32_t outcome, unsigned card) {
+            const int own = outcome & 0xF;
+            int others = 0;
+            for (unsigned p = 1; p < nP; ++p) others += (outcome >> (4 * p)) & 0xF;
+            if (own < bestOwn || (own == bestOwn && (others > bestOthers ||
+                                                      (others == bestOthers && outcome > (best & 0xFFFF))))) {
+                bestOwn = own;
+                bestOthers = others;
+                best = outcome | card << 16;
+            }
+        };
+
+        std::array<uint64_t, 4> next{};
+        for (unsigned p = 1; p < nP; ++p) next[p - 1] = hands[p];
+
+        for (uint64_t playable = hands[0] & playableOn(onTable); playable; playable &= playable - 1) {
+            const unsigned card = static_cast<unsigned>(__builtin_ctzll(playable));
+            next[nP - 1] = hands[0] & ~(1ull << card);
+            consider(next[nP - 1] ? fromChild(solve(next, 0)) : finalCounts(next), card);
+        }
+
+        next[nP - 1] = hands[0];
+        consider(passes + 1 == nP ? finalCounts(next) : fromChild(solve(next, passes + 1)), kPass);
+
+        value = best;   // values never grows, the reference is still good
+        return best;
+    }
+
+    const std::vector<uint64_t>& shapeOffsets() const { return offsets; }
+    const std::vector<uint32_t>& entries() const { return values; }
+
+private:
+    // Outcome of a child (seen from seat 1) seen from the mover
+    uint32_t fromChild(uint32_t child) const {
+        const uint32_t outcome = child & 0xFFFF;
+        return ((outcome << 4) | (outcome >> (4 * (nP - 1)))) & mask16;
+    }
+
+    // Round over: cards left, `next` being the hands from seat 1 on (mover last)
+    uint32_t finalCounts(const std::array<uint64_t, 4>& next) const {
+        uint32_t outcome = static_cast<uint32_t>(__builtin_popcountll(next[nP - 1]));
+        for (unsigned p = 1; p < nP; ++p) outcome |= static_cast<uint32_t>(__builtin_popcountll(next[p - 1])) << (4 * p);
+        return outcome;
+    }
+
+    unsigned nP;
+    uint32_t mask16;
+    std::vector<uint64_t> offsets;   // first entry of every table shape
+    std::vector<uint32_t> values;
+};
+
+} // namespace
+
+Tablebase::Tablebase(const std::string& path) : file(path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Tablebase introuvable : " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kHeaderSize) {
+        ::close(fd);
+        throw std::runtime_error("Tablebase invalide : " + path);
+    }
+    mapSize = static_cast<size_t>(st.st_size);
+    map = ::mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        map = nullptr;
+        throw std::runtime_error("Impossible de projeter la tablebase en mémoire : " + path);
+    }
+
+    const unsigned char* h = static_cast<const unsigned char*>(map);
+    auto fail = [&](const std::string& why) {
+        ::munmap(map, mapSize);
+        map = nullptr;
+        throw std::runtime_error("Tablebase " + path + " : " + why);
+    };
+    if (std::memcmp(h, kMagic, sizeof(kMagic)) != 0) fail("ce n'est pas une tablebase");
+    if (get<uint32_t>(h + 8) != kVersion) fail("version inconnue");
+    nPlayers = get<uint32_t>(h + 12);
+    cardLimit = get<uint32_t>(h + 16);
+    const uint64_t shapes = get<uint64_t>(h + 24);
+    const uint64_t slots = get<uint64_t>(h + 32);
+    entries = get<uint64_t>(h + 40);
+    if (nPlayers < 2 || nPlayers > kMaxPlayers) fail("nombre de joueurs invalide");
+    if (cardLimit > kMaxCards) fail("nombre de cartes invalide");
+    if (get<uint32_t>(h + 20) != kEntrySize) fail("taille d'entrée invalide");
+    if (shapes != kShapes || entries > slots) fail("index invalide");
+    if ((mapSize - kHeaderSize) / 8 < shapes + 1 ||
+        (mapSize - kHeaderSize - (shapes + 1) * 8) / kEntrySize < slots) fail("fichier tronqué");
+
+    offsets = h + kHeaderSize;
+    values = offsets + (shapes + 1) * 8;
+    // Probes jump anywhere in the file
+    ::madvise(map, mapSize, MADV_RANDOM);
+}
+
+Tablebase::~Tablebase() {
+    if (map) ::munmap(map, mapSize);
+}
+
+bool Tablebase::probe(const uint64_t* hands, unsigned toMove, unsigned passes, Outcome& out) const {
+    if (toMove >= nPlayers || passes >= nPlayers) return false;
+    std::array<uint64_t, kMaxPlayers> seen{};
+    unsigned left = 0;
+    for (unsigned p = 0; p < nPlayers; ++p) {
+        seen[p] = hands[(toMove + p) % nPlayers] & kDeck;
+        if (!seen[p]) return false;
+        left += __builtin_popcountll(seen[p]);
+    }
+    if (left > cardLimit) return false;
+
+    SuitPermutation perm;
+    uint64_t shape = 0, entry = 0;
+    if (!locate(seen.data(), nPlayers, passes, perm, shape, entry)) return false;
+    const uint32_t value = get<uint32_t>(values + (get<uint64_t>(offsets + shape * 8) + entry) * kEntrySize);
+    if (!value) return false;
+
+    out.cardsLeft.fill(0);
+    for (unsigned p = 0; p < nPlayers; ++p) out.cardsLeft[(toMove + p) % nPlayers] = (value >> (4 * p)) & 0xF;
+    const unsigned card = (value >> 16) & 0x3F;
+    out.card = -1;
+    if (card != kPass) {
+        for (int s = 0; s < 4; ++s) {
+            if (perm.to[s] == static_cast<int>(card / 13)) out.card = s * 13 + static_cast<int>(card % 13);
+        }
+    }
+    return true;
+}
+
+uint64_t Tablebase::generate(const std::string& path, unsigned players, unsigned maxCards) {
+    if (players < 2 || players > kMaxPlayers) {
+        throw std::invalid_argument("Nombre de joueurs invalide (2 à 4) : " + std::to_string(players));
+    }
+    if (maxCards < players || maxCards > kMaxCards) {
+        throw std::invalid_argument("Nombre de cartes invalide (" + std::to_string(players) + " à 15) : " +
+                                    std::to_string(maxCards));
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Impossible d'écrire la tablebase : " + path);
+
+    // Every canonical table (suit states in order) with players .. maxCards cards left,
+    // every way to deal them with no empty hand, every count of passes; the search fills
+    // in whatever these positions lead to
+    Solver solver(players, maxCards);
+    const SuitStates& states = suitStates();
+    std::vector<int> cards;
+    std::vector<unsigned> owner;
+    for (unsigned a = 0; a < states.size(); ++a)
+    for (unsigned b = a; b < states.size(); ++b)
+    for (unsigned c = b; c < states.size(); ++c)
+    for (unsigned d = c; d < states.size(); ++d) {
+        const uint64_t onTable = uint64_t(states.unrank(a)) | uint64_t(states.unrank(b)) << 13 |
+                                 uint64_t(states.unrank(c)) << 26 | uint64_t(states.unrank(d)) << 39;
+        const uint64_t held = kDeck & ~onTable;
+        if (!entriesFor(__builtin_popcountll(held), players, maxCards)) continue;
+        cards.clear();
+        for (uint64_t w = held; w; w &= w - 1) cards.push_back(__builtin_ctzll(w));
+        owner.assign(cards.size(), 0);
+
+        while (true) {
+            std::array<uint64_t, 4> hands{};
+            for (size_t i = 0; i < cards.size(); ++i) hands[owner[i]] |= 1ull << cards[i];
+            bool dealt = true;
+            for (unsigned p = 0; p < players; ++p) dealt = dealt && hands[p];
+            if (dealt) {
+                for (unsigned passes = 0; passes < players; ++passes) solver.solve(hands, passes);
+            }
+
+            size_t i = 0;
+            while (i < owner.size() && ++owner[i] == players) owner[i++] = 0;
+            if (i == owner.size()) break;
+        }
+    }
+
+    const std::vector<uint64_t>& shapeOffsets = solver.shapeOffsets();
+    const std::vector<uint32_t>& values = solver.entries();
+    const uint64_t solved = static_cast<uint64_t>(values.size() - std::count(values.begin(), values.end(), 0u));
+
+    unsigned char header[kHeaderSize] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    put<uint32_t>(header + 8, kVersion);
+    put<uint32_t>(header + 12, players);
+    put<uint32_t>(header + 16, maxCards);
+    put<uint32_t>(header + 20, static_cast<uint32_t>(kEntrySize));
+    put<uint64_t>(header + 24, kShapes);
+    put<uint64_t>(header + 32, values.size());
+    put<uint64_t>(header + 40, solved);
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    // Written by chunks of 64k fields
+    std::vector<unsigned char> chunk;
+    for (size_t i = 0; i < shapeOffsets.size(); i += 65536) {
+        const size_t n = std::min<size_t>(65536, shapeOffsets.size() - i);
+        chunk.resize(n * 8);
+        for (size_t k = 0; k < n; ++k) put<uint64_t>(&chunk[k * 8], shapeOffsets[i + k]);
+        out.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+    }
+    for (size_t i = 0; i < values.size(); i += 65536) {
+        const size_t n = std::min<size_t>(65536, values.size() - i);
+        chunk.resize(n * kEntrySize);
+        for (size_t k = 0; k < n; ++k) put<uint32_t>(&chunk[k * kEntrySize], values[i + k]);
+        out.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+    }
+    out.flush();
+    if (!out) throw std::runtime_error("Impossible d'écrire la tablebase : " + path);
+    return solved;
+}
+
+} // namespace sevens
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace sevens {
+
+/**
+ * Endgame tablebase: exact outcome of every perfect-information position of the 52-card
+ * game with at most K cards left in the hands, for 2 to 4 players.
+ *
+ * A position is the hands (the table is every other card), the player to move and the
+ * passes in a row since the last card played. Its outcome is the max^n value of the
+ * round: every player, at its turn, plays the card (or passes) that leaves it the fewest
+ * cards at the end, ties broken towards the most cards left to the others, then towards
+ * the largest outcome word (so the value never depends on the order of the moves).
+ * Passing is always allowed, as in MyGameMapper; the round ends when a hand is empty or
+ * every player passed in a row.
+ *
+ * Positions are stored once per class: seats rotated so that the player to move is seat 0,
+ * suits canonicalized (SuitSymmetry, all four suits), which sorts the suit states of the
+ * table (TableIndex.hpp). A canonical table is then one of the C(53, 4) multisets of four
+ * suit states, and a position is a flat array index: no hashing, no collisions. The file
+ * is read in place from a read-only mapping, shared by every process that opens it:
+ *
+ *   0   header   "SVNSTBAS", u32 version, u32 players, u32 max cards, u32 entry size,
+ *                u64 table shapes, u64 entries, u64 positions solved (padded to 64 bytes)
+ *   64  offsets  (shapes + 1) x u64, first entry of each table shape (by multiset rank)
+ *       entries  u32 per (owner of each card left by increasing id, base players; passes):
+ *                  bits  0..15  cards left at the end, one nibble per seat from the mover
+ *                  bits 16..21  best card (canonical suits), 63 = pass
+ *                  0 = not a position (an empty hand, or a non-canonical order of equal suits)
+ */
+class Tablebase {
+public:
+    static constexpr uint32_t kVersion = 2;
+    static constexpr unsigned kMaxPlayers = 4;
+    static constexpr unsigned kMaxCards = 15;   // cards left fit a nibble
+    static constexpr size_t kHeaderSize = 64;
+    static constexpr size_t kEntrySize = 4;
+
+    struct Outcome {
+        std::array<uint8_t, kMaxPlayers> cardsLeft{};   // by seat, at the end of the round
+        int card = -1;                                  // best card id for the mover, -1 = pass
+    };
+
+    // Maps the file read-only; throws std::runtime_error when it is not a valid tablebase
+    explicit Tablebase(const std::string& path);
+    ~Tablebase();
+
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    unsigned players() const { return nPlayers; }
+    unsigned maxCards() const { return cardLimit; }
+    uint64_t size() const { return entries; }
+
+    /**
+     * Constant-time lookup: hands[players()] masks (bit = card id), seat to move, passes
+     * in a row (0 .. players() - 1). False when the position is not covered (more than
+     * maxCards() cards left, an empty hand, a table no round can reach).
+     */
+    bool probe(const uint64_t* hands, unsigned toMove, unsigned passes, Outcome& out) const;
+
+    /**
+     * Solves every position with `players` players (2..4) and players .. maxCards cards
+     * left (at most 15) and writes the table. Returns the number of positions written.
+     */
+    static uint64_t generate(const std::string& path, unsigned players, unsigned maxCards);
+
+private:
+    std::string file;
+    void* map = nullptr;
+    size_t mapSize = 0;
+    const unsigned char* offsets = nullptr;
+    const unsigned char* values = nullptr;
+    uint64_t entries = 0;
+    unsigned nPlayers = 0;
+    unsigned cardLimit = 0;
+};
+
+} // namespace sevens
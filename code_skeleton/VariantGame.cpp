@@ -0,0 +1,97 @@
+#include "VariantGame.hpp"
+
+#include <charconv>
+#include <sstream>
+#include <stdexcept>
+
+namespace sevens {
+
+void RulesConfig::validate() {
+    if (decks < 1 || decks > kMaxDecks) {
+        throw std::invalid_argument("Nombre de jeux de cartes invalide (1 à 4) : " + std::to_string(decks));
+    }
+    if (players < 2 || players > kMaxPlayers) {
+        throw std::invalid_argument("Nombre de joueurs invalide (2 à 16) : " + std::to_string(players));
+    }
+    if (startCards.empty()) {
+        for (unsigned d = 0; d < decks; ++d) startCards.push_back(Card{static_cast<int>(d * kSuitsPerDeck + 2), 7});
+    }
+    for (size_t i = 0; i < startCards.size(); ++i) {
+        const Card& c = startCards[i];
+        if (c.suit < 0 || c.suit >= static_cast<int>(suits()) || c.rank < 1 || c.rank > static_cast<int>(kRanks)) {
+            throw std::invalid_argument("Carte de départ hors du jeu : " + std::to_string(c.rank) + ":" +
+                                        std::to_string(c.suit));
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (startCards[j].suit == c.suit && startCards[j].rank == c.rank) {
+                throw std::invalid_argument("Carte de départ en double : " + std::to_string(c.rank) + ":" +
+                                            std::to_string(c.suit));
+            }
+        }
+    }
+    if (startCards.size() >= cards()) throw std::invalid_argument("Aucune carte à distribuer");
+}
+
+std::vector<Card> RulesConfig::parseCards(const std::string& text) {
+    std::vector<Card> cards;
+    std::stringstream ss(text);
+    std::string item;
+    // Whole field or nothing: "7:2x" or "7:" are refused
+    auto number = [](const char* first, const char* last, int& value) {
+        auto [end, ec] = std::from_chars(first, last, value);
+        return first != last && ec == std::errc() && end == last;
+    };
+    while (std::getline(ss, item, ',')) {
+        const size_t colon = item.find(':');
+        const char* text = item.data();
+        int rank = 0, suit = 0;
+        if (colon == std::string::npos || !number(text, text + colon, rank) ||
+            !number(text + colon + 1, text + item.size(), suit)) {
+            throw std::invalid_argument("Carte invalide (rang:couleur attendu, ex. 7:2) : " + item);
+        }
+        cards.push_back(Card{suit, rank});
+    }
+    return cards;
+}
+
+namespace {
+
+template <unsigned Decks>
+VariantTally playRounds(const RulesConfig& rules, std::vector<std::shared_ptr<PlayerStrategy>> strategies,
+                        uint64_t rounds, uint64_t seed) {
+    VariantGame<Decks> game(rules);
+    StrategySeats<Decks> seats(std::move(strategies));
+    std::mt19937_64 rng(seed);
+
+    VariantTally tally;
+    tally.wins.assign(rules.players, 0);
+    tally.cardsLeft.assign(rules.players, 0);
+    for (uint64_t r = 0; r < rounds; ++r) {
+        const std::vector<uint64_t>& left = game.play(seats, rng);
+        const uint64_t best = *std::min_element(left.begin(), left.end());
+        for (size_t p = 0; p < left.size(); ++p) {
+            tally.cardsLeft[p] += left[p];
+            if (left[p] == best) tally.wins[p]++;
+        }
+        tally.rounds++;
+    }
+    return tally;
+}
+
+} // namespace
+
+VariantTally playVariantRounds(const RulesConfig& rules, std::vector<std::shared_ptr<PlayerStrategy>> strategies,
+                               uint64_t rounds, uint64_t seed) {
+    if (strategies.size() != rules.players) {
+        throw std::invalid_argument("Il faut une stratégie par joueur");
+    }
+    switch (rules.decks) {
+        case 1: return playRounds<1>(rules, std::move(strategies), rounds, seed);
+        case 2: return playRounds<2>(rules, std::move(strategies), rounds, seed);
+        case 3: return playRounds<3>(rules, std::move(strategies), rounds, seed);
+        case 4: return playRounds<4>(rules, std::move(strategies), rounds, seed);
+    }
+    throw std::invalid_argument("Nombre de jeux de cartes invalide (1 à 4) : " + std::to_string(rules.decks));
+}
+
+} // namespace sevens
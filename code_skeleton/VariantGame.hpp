@@ -0,0 +1,293 @@
+#pragma once
+
+#include "PlayerStrategy.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Rules of a Sevens variant: several combined decks, up to 16 players, any start cards.
+ *
+ * Deck d brings its own four suits, numbered 4d .. 4d+3 (suit 4d+2 = diamonds of deck d),
+ * so every card of the combined pack is still a unique (suit, rank) and the table keeps
+ * one row per suit, exactly like the 52-card game. The classic game is
+ * { decks = 1, players = 2..8, startCards = { 7♦ } }.
+ */
+struct RulesConfig {
+    static constexpr unsigned kSuitsPerDeck = 4;
+    static constexpr unsigned kRanks = 13;
+    static constexpr unsigned kMaxDecks = 4;
+    static constexpr unsigned kMaxPlayers = 16;
+
+    unsigned decks = 1;
+    unsigned players = 4;
+    std::vector<Card> startCards;   // empty = the 7♦ of every deck
+
+    unsigned suits() const { return decks * kSuitsPerDeck; }
+    unsigned cards() const { return suits() * kRanks; }
+
+    // Fills the default start cards; throws std::invalid_argument on an impossible variant
+    void validate();
+
+    // "7:2,7:6" → 7 of suit 2 and 7 of suit 6 ; throws std::invalid_argument
+    static std::vector<Card> parseCards(const std::string& text);
+};
+
+/**
+ * Set of cards of a variant with Decks decks: one 64-bit word per deck, suit s of the
+ * deck on bits (s % 4) * 13 .. (s % 4) * 13 + 12 of word s / 4 (bit rank - 1).
+ * The whole pack of a deck is 52 bits, so every rule test is a handful of word
+ * operations and the cost grows linearly with the number of decks.
+ */
+template <unsigned Decks>
+class CardSet {
+public:
+    static_assert(Decks >= 1 && Decks <= RulesConfig::kMaxDecks, "1 to 4 decks");
+    static constexpr unsigned kCards = Decks * RulesConfig::kSuitsPerDeck * RulesConfig::kRanks;
+
+    static constexpr uint64_t kDeckMask = (1ull << 52) - 1;
+    static constexpr uint64_t kAces = 1ull | 1ull << 13 | 1ull << 26 | 1ull << 39;
+    static constexpr uint64_t kKings = kAces << 12;
+    static constexpr uint64_t kSevens = kAces << 6;
+
+    // Card id: deck * 52 + (suit % 4) * 13 + rank - 1, i.e. suit * 13 + rank - 1
+    static int id(const Card& c) { return c.suit * 13 + c.rank - 1; }
+    static Card card(int id) { return Card{id / 13, id % 13 + 1}; }
+
+    bool test(int id) const { return (words[id / 52] >> (id % 52)) & 1; }
+    void set(int id) { words[id / 52] |= 1ull << (id % 52); }
+    void reset(int id) { words[id / 52] &= ~(1ull << (id % 52)); }
+    void clear() { words.fill(0); }
+
+    // Raw 52-bit word of deck d (same layout as the card ids of the 52-card game)
+    uint64_t word(unsigned d) const { return words[d]; }
+
+    bool empty() const {
+        uint64_t any = 0;
+        for (uint64_t w : words) any |= w;
+        return any == 0;
+    }
+
+    unsigned count() const {
+        unsigned n = 0;
+        for (uint64_t w : words) n += __builtin_popcountll(w);
+        return n;
+    }
+
+    CardSet operator&(const CardSet& o) const {
+        CardSet r;
+        for (unsigned d = 0; d < Decks; ++d) r.words[d] = words[d] & o.words[d];
+        return r;
+    }
+
+    /**
+     * Cards that may be played on this table: the 7s not on it yet, and the neighbours
+     * of the cards on it (an ace or a king never borrows from the next suit).
+     */
+    CardSet playableOn() const {
+        CardSet r;
+        for (unsigned d = 0; d < Decks; ++d) {
+            const uint64_t t = words[d];
+            const uint64_t next = ((t << 1) & ~kAces) | ((t >> 1) & ~kKings);
+            r.words[d] = (next | kSevens) & ~t & kDeckMask;
+        }
+        return r;
+    }
+
+    // Calls f(id) for every card, by increasing id
+    template <typename F>
+    void forEach(F&& f) const {
+        for (unsigned d = 0; d < Decks; ++d) {
+            for (uint64_t w = words[d]; w; w &= w - 1) f(static_cast<int>(d * 52 + __builtin_ctzll(w)));
+        }
+    }
+
+    // The k-th card (0-based, by increasing id); k < count()
+    int nth(unsigned k) const {
+        for (unsigned d = 0; d < Decks; ++d) {
+            unsigned n = __builtin_popcountll(words[d]);
+            if (k >= n) { k -= n; continue; }
+            uint64_t w = words[d];
+            while (k--) w &= w - 1;
+            return static_cast<int>(d * 52 + __builtin_ctzll(w));
+        }
+        return -1;
+    }
+
+private:
+    std::array<uint64_t, Decks> words{};
+};
+
+/**
+ * One round of a variant, on bitsets. Who plays what is left to a Seats policy:
+ *
+ *   void begin(const std::vector<CardSet<Decks>>& hands, const CardSet<Decks>& table);
+ *   int  choose(uint64_t player, const CardSet<Decks>& hand, const CardSet<Decks>& playable);
+ *        (card id, or -1 to pass; an illegal card counts as a pass; only called when
+ *         the hand holds a playable card, otherwise the player passes directly)
+ *   void played(uint64_t player, int card);
+ *   void passed(uint64_t player);
+ *
+ * Dealing and turn order are those of MyGameMapper::play_round: shuffled pack dealt from
+ * a random player, start cards put on the table, the player after the dealer starts, and
+ * the round ends when a hand is empty or every player passed in a row.
+ */
+template <unsigned Decks>
+class VariantGame {
+public:
+    using Set = CardSet<Decks>;
+
+    explicit VariantGame(const RulesConfig& rules) : rules(rules), hands(rules.players) {
+        for (const Card& c : rules.startCards) opening.set(Set::id(c));
+        for (int id = 0; id < static_cast<int>(rules.cards()); ++id) {
+            if (!opening.test(id)) pack.push_back(static_cast<uint16_t>(id));
+        }
+        left.resize(rules.players);
+    }
+
+    /**
+     * Plays one round; returns the cards left per player (valid until the next round).
+     */
+    template <typename Seats, typename Rng>
+    const std::vector<uint64_t>& play(Seats& seats, Rng& rng) {
+        const uint64_t nP = rules.players;
+        std::shuffle(pack.begin(), pack.end(), rng);
+        const uint64_t dealer = rng() % nP;
+        for (Set& h : hands) h.clear();
+        for (size_t i = 0; i < pack.size(); ++i) hands[(dealer + i) % nP].set(pack[i]);
+        table = opening;
+        seats.begin(hands, table);
+
+        uint64_t player = (dealer + 1) % nP;
+        uint64_t passesInARow = 0;
+        while (passesInARow < nP) {
+            Set& hand = hands[player];
+            const Set playable = hand & table.playableOn();
+            int card = playable.empty() ? -1 : seats.choose(player, hand, playable);
+            if (card >= 0 && card < static_cast<int>(Set::kCards) && playable.test(card)) {
+                hand.reset(card);
+                table.set(card);
+                seats.played(player, card);
+                passesInARow = 0;
+                if (hand.empty()) break;
+            } else {
+                seats.passed(player);
+                ++passesInARow;
+            }
+            player = (player + 1) % nP;
+        }
+
+        for (uint64_t p = 0; p < nP; ++p) left[p] = hands[p].count();
+        return left;
+    }
+
+    const RulesConfig& config() const { return rules; }
+
+private:
+    RulesConfig rules;
+    Set opening;
+    Set table;
+    std::vector<uint16_t> pack;   // card ids dealt to the players
+    std::vector<Set> hands;
+    std::vector<uint64_t> left;
+};
+
+/**
+ * Seats policy without strategies: every player plays its first (or a random) legal card.
+ * Measures the engine itself (sevens_bench scale/...).
+ */
+template <unsigned Decks>
+struct FirstCardSeats {
+    void begin(const std::vector<CardSet<Decks>>&, const CardSet<Decks>&) {}
+    int choose(uint64_t, const CardSet<Decks>&, const CardSet<Decks>& playable) { return playable.nth(0); }
+    void played(uint64_t, int) {}
+    void passed(uint64_t) {}
+};
+
+template <unsigned Decks>
+struct RandomCardSeats {
+    std::mt19937_64 rng;
+    explicit RandomCardSeats(uint64_t seed) : rng(seed) {}
+    void begin(const std::vector<CardSet<Decks>>&, const CardSet<Decks>&) {}
+    int choose(uint64_t, const CardSet<Decks>&, const CardSet<Decks>& playable) {
+        return playable.nth(static_cast<unsigned>(rng() % playable.count()));
+    }
+    void played(uint64_t, int) {}
+    void passed(uint64_t) {}
+};
+
+/**
+ * Seats policy for PlayerStrategy objects: keeps the std::vector<Card> hands and the
+ * TableLayout of the strategy API in step with the bitsets and forwards the
+ * notifications the way MyGameMapper does (every strategy sees each move, only the
+ * passing player sees its pass).
+ */
+template <unsigned Decks>
+class StrategySeats {
+public:
+    explicit StrategySeats(std::vector<std::shared_ptr<PlayerStrategy>> seats) : seats(std::move(seats)) {}
+
+    void begin(const std::vector<CardSet<Decks>>& dealt, const CardSet<Decks>& opening) {
+        hands.resize(seats.size());
+        for (size_t p = 0; p < seats.size(); ++p) {
+            hands[p].clear();
+            dealt[p].forEach([&](int id) { hands[p].push_back(CardSet<Decks>::card(id)); });
+        }
+        for (unsigned suit = 0; suit < Decks * RulesConfig::kSuitsPerDeck; ++suit) {
+            auto& ranks = table[suit];
+            for (uint64_t rank = 1; rank <= RulesConfig::kRanks; ++rank) ranks[rank] = false;
+        }
+        opening.forEach([&](int id) {
+            Card c = CardSet<Decks>::card(id);
+            table[c.suit][c.rank] = true;
+        });
+        for (size_t p = 0; p < seats.size(); ++p) seats[p]->initialize(p);
+    }
+
+    int choose(uint64_t player, const CardSet<Decks>&, const CardSet<Decks>&) {
+        const std::vector<Card>& hand = hands[player];
+        int idx = seats[player]->selectCardToPlay(hand, table);
+        if (idx < 0 || static_cast<size_t>(idx) >= hand.size()) return -1;
+        return CardSet<Decks>::id(hand[idx]);
+    }
+
+    void played(uint64_t player, int id) {
+        const Card c = CardSet<Decks>::card(id);
+        std::vector<Card>& hand = hands[player];
+        hand.erase(std::find_if(hand.begin(), hand.end(), [&](const Card& h) {
+            return h.suit == c.suit && h.rank == c.rank;
+        }));
+        table[c.suit][c.rank] = true;
+        for (size_t p = 0; p < seats.size(); ++p) seats[p]->observeMove(player, c);
+    }
+
+    void passed(uint64_t player) { seats[player]->observePass(player); }
+
+private:
+    std::vector<std::shared_ptr<PlayerStrategy>> seats;
+    std::vector<std::vector<Card>> hands;
+    TableLayout table;
+};
+
+/**
+ * Plays `rounds` rounds of a variant with one strategy per seat (strategies.size() ==
+ * rules.players) and returns, per seat, the rounds won (fewest cards left, ties shared)
+ * and the total of cards left. The deck count picks the CardSet width at run time.
+ */
+struct VariantTally {
+    std::vector<uint64_t> wins;
+    std::vector<uint64_t> cardsLeft;
+    uint64_t rounds = 0;
+};
+
+VariantTally playVariantRounds(const RulesConfig& rules, std::vector<std::shared_ptr<PlayerStrategy>> strategies,
+                               uint64_t rounds, uint64_t seed);
+
+} // namespace sevens
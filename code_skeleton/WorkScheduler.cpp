@@ -0,0 +1,106 @@
+#include "WorkScheduler.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace sevens {
+
+WorkScheduler::WorkScheduler(uint64_t first, uint64_t last, unsigned threads)
+    : last(last), threads(threadCount(threads, last > first ? last - first : 0)),
+      deques(new Deque[this->threads]), shared(first) {}
+
+WorkScheduler::~WorkScheduler() = default;
+
+unsigned WorkScheduler::threadCount(unsigned requested, uint64_t tasks) {
+    unsigned n = requested ? requested : std::max(1u, std::thread::hardware_concurrency());
+    return static_cast<unsigned>(std::min<uint64_t>(n, std::max<uint64_t>(1, tasks)));
+}
+
+bool WorkScheduler::Tasks::next(uint64_t& index) {
+    if (scheduler.stopped.load(std::memory_order_relaxed)) return false;
+    Deque& own = scheduler.deques[id];
+    do {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.front < own.back) {
+            index = own.front++;
+            return true;
+        }
+    } while (scheduler.refill(id) || scheduler.steal(id));
+    return false;
+}
+
+// Guided chunk of the shared range into the (empty) deque of worker id
+bool WorkScheduler::refill(unsigned id) {
+    Deque& own = deques[id];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    uint64_t front = shared.load(std::memory_order_relaxed);
+    uint64_t chunk;
+    do {
+        if (front >= last) return false;
+        chunk = std::min(kMaxChunk, std::max<uint64_t>(1, (last - front) / (4 * threads)));
+    } while (!shared.compare_exchange_weak(front, front + chunk, std::memory_order_relaxed));
+    own.front = front;
+    own.back = front + chunk;
+    return true;
+}
+
+// Back half of the largest deque of the other workers (all of it when one task is left)
+bool WorkScheduler::steal(unsigned id) {
+    while (!stopped.load(std::memory_order_relaxed)) {
+        unsigned victim = id;
+        uint64_t most = 0;
+        for (unsigned k = 1; k < threads; ++k) {
+            const unsigned v = (id + k) % threads;
+            std::lock_guard<std::mutex> lock(deques[v].mutex);
+            if (deques[v].back - deques[v].front > most) {
+                most = deques[v].back - deques[v].front;
+                victim = v;
+            }
+        }
+        if (victim == id) return false;
+
+        uint64_t front, back;
+        {
+            std::lock_guard<std::mutex> lock(deques[victim].mutex);
+            Deque& d = deques[victim];
+            if (d.front >= d.back) continue;   // played or stolen meanwhile: look again
+            front = d.front + (d.back - d.front) / 2;
+            back = d.back;
+            d.back = front;
+        }
+        // Nobody steals from an empty deque, so ours can be filled outside the victim's lock
+        std::lock_guard<std::mutex> lock(deques[id].mutex);
+        deques[id].front = front;
+        deques[id].back = back;
+        stolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkScheduler::run(const std::function<void(Tasks&)>& body) {
+    std::mutex failMutex;
+    std::exception_ptr failure;
+
+    auto worker = [&](unsigned id) {
+        try {
+            Tasks tasks(*this, id);
+            body(tasks);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failMutex);
+            if (!failure) failure = std::current_exception();
+            stopped.store(true);   // the other workers stop at their next task
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+
+    if (failure) std::rethrow_exception(failure);
+}
+
+} // namespace sevens
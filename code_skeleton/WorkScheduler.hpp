@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace sevens {
+
+/**
+ * Work-stealing scheduler of the parallel runners (batch, distributed worker, self-play,
+ * opening book, exploitability): tasks are the indices [first, last) of games, shards or
+ * deals, handed to a fixed set of worker threads.
+ *
+ * The cost of a task varies a lot (a table of RandomAgressive finishes in microseconds, one
+ * of search strategies in seconds), so the indices are not split up front:
+ *   - every worker owns a deque, a contiguous range of indices it plays from the front;
+ *   - an empty worker takes a chunk from the front of the shared range, of guided size
+ *     (remaining / (4 * threads), between 1 and kMaxChunk): big chunks early, single
+ *     tasks near the end, and tasks handed out roughly in index order (the batch folds
+ *     matches in order and keeps the ones finished early waiting);
+ *   - once the shared range is empty, it steals the back half of the largest deque left,
+ *     so a chunk stuck behind a slow game is split again until every worker is busy to
+ *     the last task.
+ * A task is only ever in one place (shared range, a deque, or being played), so each index
+ * is played once. The deques are guarded by one mutex per worker: a lock costs far less
+ * than the shortest game, and the owner is the only one taking it but for the steals.
+ *
+ * run() plays the calling thread as worker 0. When the body throws, the other workers stop
+ * at their next task and the first exception is rethrown once they have all returned.
+ */
+class WorkScheduler {
+public:
+    static constexpr uint64_t kMaxChunk = 64;
+
+    class Tasks {
+    public:
+        // Next task of this worker; false when there is none left anywhere (or after a failure)
+        bool next(uint64_t& index);
+
+        unsigned worker() const { return id; }
+
+    private:
+        friend class WorkScheduler;
+        Tasks(WorkScheduler& scheduler, unsigned id) : scheduler(scheduler), id(id) {}
+
+        WorkScheduler& scheduler;
+        unsigned id;
+    };
+
+    // threads = 0 → std::thread::hardware_concurrency(); never more threads than tasks
+    WorkScheduler(uint64_t first, uint64_t last, unsigned threads);
+    ~WorkScheduler();
+
+    WorkScheduler(const WorkScheduler&) = delete;
+    WorkScheduler& operator=(const WorkScheduler&) = delete;
+
+    // Runs body once per worker; body loops on tasks.next() and keeps its own per-worker state
+    void run(const std::function<void(Tasks&)>& body);
+
+    unsigned threadCount() const { return threads; }
+    uint64_t steals() const { return stolen.load(std::memory_order_relaxed); }
+
+    // Threads a run of `tasks` tasks uses (0 = std::thread::hardware_concurrency())
+    static unsigned threadCount(unsigned requested, uint64_t tasks);
+
+private:
+    struct alignas(64) Deque {
+        std::mutex mutex;
+        uint64_t front = 0;
+        uint64_t back = 0;            // [front, back) left to play
+    };
+
+    bool refill(unsigned id);
+    bool steal(unsigned id);
+
+    uint64_t last;
+    unsigned threads;
+    std::unique_ptr<Deque[]> deques;
+    std::atomic<uint64_t> shared;     // front of the range not handed out yet
+    std::atomic<bool> stopped{false};
+    std::atomic<uint64_t> stolen{0};
+};
+
+} // namespace sevens
@@ -3,33 +3,163 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <chrono>
+#include <algorithm>
+#include <tuple>
+#include <stdexcept>
 
 // Inclure les fichiers de ton framework
 #include "MyGameMapper.hpp"
 #include "StrategyLoader.hpp"
+#include "StaticGame.hpp"
+#include "BuiltinStrategies.hpp"
+#include "MatchRunner.hpp"
+#include "Checkpoint.hpp"
+#include "CommandLine.hpp"
+#include "ResultsWriter.hpp"
+#include "Metrics.hpp"
+#include "Distributed.hpp"
+#include "VariantGame.hpp"
+#include "DealCorpus.hpp"
+#include "Tablebase.hpp"
+#include "OpeningBook.hpp"
+#include "SelfPlay.hpp"
+#include "PolicyTrainer.hpp"
+#include "CfrPolicy.hpp"
+#include "Exploitability.hpp"
+
+// -----------------------------------------------------------------------------
+// Mode STATIC : moteur composé à la compilation (StaticGame), stratégies intégrées
+// -----------------------------------------------------------------------------
+template <typename... S>
+static void runStaticGames(uint64_t games, uint64_t seed) {
+    sevens::StaticGame<S...> game(seed);
+    std::vector<uint64_t> wins(sizeof...(S), 0);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t g = 0; g < games; ++g) {
+        auto left = game.play();
+        uint64_t best = *std::min_element(left.begin(), left.end());
+        for (size_t i = 0; i < left.size(); ++i) if (left[i] == best) wins[i]++;
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::vector<std::string> names;
+    std::apply([&](auto&... strat) { (names.push_back(strat.getName()), ...); }, game.strategies());
+    for (size_t i = 0; i < names.size(); ++i) {
+        std::cout << "J" << i << " → " << names[i] << " | Wins: " << wins[i]
+                  << " | Win Rate: " << 100.0 * wins[i] / games << "%\n";
+    }
+    std::cout << games << " games in " << secs << " s (" << games / secs << " games/s)\n";
+}
+
+// Seatings available in static mode (the README line-ups)
+static bool runStaticPreset(const std::string& preset, uint64_t games, uint64_t seed) {
+    using namespace sevens;
+    if (preset == "random4")
+        runStaticGames<RandomAgressiveStrategy, RandomAgressiveStrategy,
+                       RandomAgressiveStrategy, RandomAgressiveStrategy>(games, seed);
+    else if (preset == "sentinel-random")
+        runStaticGames<Sentinel7, RandomAgressiveStrategy, RandomAgressiveStrategy>(games, seed);
+    else if (preset == "sentinel-prudent")
+        runStaticGames<Sentinel7, PrudentStrategy, PrudentStrategy>(games, seed);
+    else if (preset == "sentinel-calculative")
+        runStaticGames<Sentinel7, CalculativeStrategy, CalculativeStrategy>(games, seed);
+    else if (preset == "mixed4")
+        runStaticGames<Sentinel7, PrudentStrategy, CalculativeStrategy, RandomAgressiveStrategy>(games, seed);
+    else
+        return false;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Fichiers deck & table des modes classiques : corpus de donnes (mode gencorpus) et
+// table de départ (cartes rang:couleur) ; "-" garde le comportement par défaut
+// -----------------------------------------------------------------------------
+static std::unique_ptr<sevens::DealCorpus> useDeckAndTable(sevens::MyGameMapper& game, const std::string& deckFile,
+                                                           const std::string& tableFile) {
+    if (!tableFile.empty() && tableFile != "-") game.set_table_file(tableFile);
+    std::unique_ptr<sevens::DealCorpus> corpus;
+    if (!deckFile.empty() && deckFile != "-") {
+        corpus.reset(new sevens::DealCorpus(deckFile));
+        game.use_deals(corpus.get());
+        std::cout << "[main] " << corpus->size() << " fixed deals from " << deckFile << '\n';
+    }
+    return corpus;
+}
+
+// Usage of a mode (after "./sevens_game "), also printed when its command line is malformed
+static const char* usage(const std::string& mode) {
+    if (mode == "internal") return "internal [players] [deals.svd|- table.txt|-]\n";
+    if (mode == "demo") return "demo [players] [deals.svd|- table.txt|-]\n";
+    if (mode == "competition") return "competition strat1.so strat2.so [...]\n";
+    if (mode == "tournament") return "tournament strat1.so strat2.so [...]\n";
+    if (mode == "static") return "static "
+           "[random4|sentinel-random|sentinel-prudent|sentinel-calculative|mixed4] "
+           "[games] [seed]\n";
+    if (mode == "batch") return "batch [--matches N] [--threads T] [--seed S] "
+           "[--max-score P] [--fixed-seats] [--deals corpus.svd] [--book opening.svb] "
+           "[--results out.svr|out.csv|out.jsonl] "
+           "[--metrics-file F] [--metrics-port N] [--metrics-interval S] [--decision-budget-ms B] "
+           "[--checkpoint F [--checkpoint-every S] [--resume]] [--interleave K | --ponder] [--hot-reload] "
+           "strat1.so strat2.so [...]\n";
+    if (mode == "coordinator") return "coordinator --seed S [--matches N] [--max-score P] "
+           "[--fixed-seats] [--deals corpus.svd] [--book opening.svb] [--port 7777] [--bind 127.0.0.1] [--unit-size 64] "
+           "[--unit-timeout 300] strat1.so strat2.so [...]\n";
+    if (mode == "worker") return "worker [--host 127.0.0.1] [--port 7777] [--threads T] [--connect-timeout 30]\n";
+    if (mode == "gencorpus") return "gencorpus deals.svd [--deals N] [--players P] [--seed S] "
+           "[--table-cards K] [--unique]\n";
+    if (mode == "tablebase") return "tablebase endgame.svt [--players 2-4] [--cards K]\n";
+    if (mode == "book") return "book opening.svb [--players P] [--deals N] [--depth D] "
+           "[--threads T] [--seed S] [--min-samples M] strat1.so [strat2.so ...]\n"
+           "       (seat p plays strategy p % number of strategies)\n";
+    if (mode == "selfplay") return "selfplay out/prefix [--players P] [--games N] "
+           "[--shard-games G] [--threads T] [--seed S] [--fixed-seats] strat1.so [strat2.so ...]\n"
+           "       (writes out/prefix-00000.svs, out/prefix-00001.svs, ...)\n";
+    if (mode == "train") return "train model.svm [--hidden H] [--epochs E] [--lr R] "
+           "[--quantize] [--strategy K] [--seed S] shard.svs [shard.svs ...]\n"
+           "       (--hidden 0: linear model; --strategy K: imitate the K-th selfplay strategy only)\n";
+    if (mode == "cfr") return "cfr policy.svc [--players P] [--iterations N] [--threads T] "
+           "[--seed S] [--table-bits B] [--window W] [--prune-after N] [--no-prune]\n"
+           "       (2^B information sets of 64 bytes are allocated up front)\n";
+    if (mode == "exploit") return "exploit [--players P] [--deals N] [--samples K] [--threads T] "
+           "[--seed S] strat1.so [strat2.so ...]\n"
+           "       (seat p plays strategy p % number of strategies; one seat per deal best-responds)\n";
+    if (mode == "variant") return "variant [--decks 1-4] [--players 2-16] "
+           "[--start 7:2,7:6] [--rounds N] [--seed S] strat1.so [strat2.so ...]\n"
+           "       (seat p plays strategy p % number of strategies)\n";
+    if (mode == "export") return "export results.svr [--format csv|jsonl] [--column name]\n";
+    return "[internal|demo|competition|tournament|static|batch|export|coordinator|worker|variant|gencorpus|"
+           "tablebase|book|selfplay|train|cfr|exploit] [args...]\n";
+}
 
 // -----------------------------------------------------------------------------
 // MAIN
 // -----------------------------------------------------------------------------
-int main(int argc, char* argv[]) {
+static int run(int argc, char* argv[]) {
     if (argc < 2) {
         std::cout << "Usage: ./sevens_game "
-                     "[internal|demo|competition|tournament] "
-                     "[args...] [deck.txt table.txt]\n";
+                     "[internal|demo|competition|tournament|static|batch|export|coordinator|worker|variant|gencorpus|tablebase|book|selfplay|train|cfr|exploit] "
+                     "[args...] [deals.svd|- table.txt|-]\n"
+                     "       strategies are .so paths or builtin:<Name> "
+                     "(RandomAgressiveStrategy, PrudentStrategy, CalculativeStrategy, Sentinel7,\n"
+                     "       LearnedStrategy, CfrStrategy, MonteCarloStrategy)\n";
         return 1;
     }
 
     std::string mode = argv[1];
 
     // -------------------------------------------------------------------------
-    // (Optionnel) fichiers deck & table – toujours présents dans la ligne de
-    // commande d’origine, bien qu’ils ne soient pas utilisés par MyGameMapper.
+    // (Optionnel) fichiers deck & table en fin de ligne de commande : corpus de
+    // donnes fixes (DealCorpus, voir gencorpus) et table de départ, "-" = défaut.
     // -------------------------------------------------------------------------
     std::string deckFile  = "";
     std::string tableFile = "";
-    if (argc >= 4 &&
-        std::string(argv[argc - 2]).find(".so") == std::string::npos &&
-        std::string(argv[argc - 1]).find(".so") == std::string::npos)
+    bool classicMode = (mode == "internal" || mode == "demo" ||
+                        mode == "competition" || mode == "tournament");
+    if (argc >= 4 && classicMode &&
+        !sevens::StrategyLoader::isStrategySpec(argv[argc - 2]) &&
+        !sevens::StrategyLoader::isStrategySpec(argv[argc - 1]))
     {
         deckFile  = argv[argc - 2];
         tableFile = argv[argc - 1];
@@ -47,6 +177,7 @@ int main(int argc, char* argv[]) {
         sevens::MyGameMapper game;
         std::vector<std::shared_ptr<sevens::PlayerStrategy>> strategies;
 
+        auto corpus = useDeckAndTable(game, deckFile, tableFile);
         game.read_cards();  // lit le paquet standard
         game.read_game();   // place 7♦ au centre
 
@@ -71,6 +202,7 @@ int main(int argc, char* argv[]) {
         sevens::MyGameMapper game;
         std::vector<std::shared_ptr<sevens::PlayerStrategy>> strategies;
 
+        auto corpus = useDeckAndTable(game, deckFile, tableFile);
         game.read_cards();
         game.read_game();
 
@@ -92,7 +224,7 @@ int main(int argc, char* argv[]) {
     // -------------------------------------------------------------------------
     else if (mode == "competition") {
         if (argc < 4) {
-            std::cerr << "[main] Usage: ./sevens_game competition strat1.so strat2.so [...]\n";
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
             return 1;
         }
 
@@ -101,12 +233,13 @@ int main(int argc, char* argv[]) {
         sevens::MyGameMapper game;
         std::vector<std::shared_ptr<sevens::PlayerStrategy>> strategies;
 
+        auto corpus = useDeckAndTable(game, deckFile, tableFile);
         game.read_cards();
         game.read_game();
 
         for (int i = 2; i < argc; ++i) {
             std::string path = argv[i];
-            auto strat = sevens::StrategyLoader::loadFromLibrary(path);
+            auto strat = sevens::StrategyLoader::load(path);
             strat->initialize(i - 2);
             game.registerStrategy(i - 2, strat);
             strategies.push_back(strat);
@@ -120,7 +253,7 @@ int main(int argc, char* argv[]) {
     // -------------------------------------------------------------------------
     else if (mode == "tournament") {
         if (argc < 4) {
-            std::cerr << "[main] Usage: ./sevens_game tournament strat1.so strat2.so [...]\n";
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
             return 1;
         }
 
@@ -129,12 +262,13 @@ int main(int argc, char* argv[]) {
         sevens::MyGameMapper game;
         std::vector<std::shared_ptr<sevens::PlayerStrategy>> strategies;
 
+        auto corpus = useDeckAndTable(game, deckFile, tableFile);
         game.read_cards();
         game.read_game();
 
         for (int i = 2; i < argc; ++i) {
             std::string path = argv[i];
-            auto strat = sevens::StrategyLoader::loadFromLibrary(path);
+            auto strat = sevens::StrategyLoader::load(path);
             strat->initialize(i - 2);
             game.registerStrategy(i - 2, strat);
             strategies.push_back(strat);
@@ -145,6 +279,401 @@ int main(int argc, char* argv[]) {
         game.compute_multiple_rounds_to_score(strategies.size(), 50);
     }
 
+    // -------------------------------------------------------------------------
+    // STATIC (StaticGame, stratégies compilées dans le binaire)  ──────────────
+    // -------------------------------------------------------------------------
+    else if (mode == "static") {
+        std::string preset = (argc >= 3) ? argv[2] : "mixed4";
+        uint64_t games = (argc >= 4) ? sevens::CommandLine::parseU64(argv[3], "games") : 10000;
+        uint64_t seed  = (argc >= 5) ? sevens::CommandLine::parseU64(argv[4], "seed")
+                                     : std::chrono::steady_clock::now().time_since_epoch().count();
+
+        std::cout << "[main] Static mode → " << preset << ", " << games << " games\n";
+        if (!runStaticPreset(preset, games, seed)) {
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
+            return 1;
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // BATCH (nombreux matchs jusqu’à 50 pts, en parallèle et sans affichage)  ─
+    // -------------------------------------------------------------------------
+    else if (mode == "batch") {
+        sevens::CommandLine cli(argc, argv, 2, {"matches", "max-score", "threads", "seed", "deals", "book", "results", "checkpoint",
+                                           "checkpoint-every", "interleave", "metrics-file", "metrics-port",
+                                           "metrics-interval", "decision-budget-ms"},
+                                {"fixed-seats", "resume", "ponder", "hot-reload"});
+        if (cli.args().size() < 2) {
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
+            return 1;
+        }
+
+        sevens::MatchRunnerConfig cfg;
+        cfg.specs = cli.args();
+        cfg.matches = cli.getU64("matches", 1000);
+        cfg.maxScore = cli.getU64("max-score", 50);
+        cfg.threads = static_cast<unsigned>(cli.getU64("threads", 0));
+        cfg.seed = cli.getU64("seed", std::chrono::steady_clock::now().time_since_epoch().count());
+        cfg.rotateSeats = !cli.has("fixed-seats");
+        cfg.deals = cli.get("deals", "");
+        cfg.book = cli.get("book", "");
+        cfg.checkpoint = cli.get("checkpoint", "");
+        cfg.checkpointSeconds = cli.getDouble("checkpoint-every", 60.0);
+        cfg.resume = cli.has("resume");
+        cfg.interleave = static_cast<unsigned>(cli.getU64("interleave", 0));
+        cfg.ponder = cli.has("ponder");
+        cfg.hotReload = cli.has("hot-reload");
+        if (cfg.ponder && cfg.interleave) {
+            std::cerr << "[main] --ponder plays one match at a time per thread: not with --interleave\n";
+            return 1;
+        }
+        if (cfg.resume && cfg.checkpoint.empty()) {
+            std::cerr << "[main] --resume needs --checkpoint FILE\n";
+            return 1;
+        }
+        if (cfg.resume && !cli.has("seed")) {
+            std::cerr << "[main] --resume needs the --seed of the interrupted run\n";
+            return 1;
+        }
+
+        std::cout << "[main] Batch mode → " << cfg.matches << " matches to " << cfg.maxScore
+                  << " points, seed " << cfg.seed << '\n';
+
+        sevens::MatchRunner runner(cfg);
+
+        // Résultats partie par partie, écrits en arrière-plan (format d'après l'extension)
+        std::unique_ptr<sevens::ResultsWriter> results;
+        if (cli.has("results")) {
+            std::string path = cli.get("results", "");
+            // Reprise : le fichier est ramené à la taille enregistrée par le checkpoint
+            uint64_t keep = sevens::ResultsWriter::kNewFile;
+            if (cfg.resume) keep = sevens::Checkpoint::load(cfg.checkpoint, runner.config(), runner.aggregator().initialState()).resultsBytes;
+            results.reset(new sevens::ResultsWriter(path, runner.strategyNames(), sevens::formatFromPath(path), keep));
+            runner.setResults(results.get());
+        }
+
+        // Métriques en direct (fichier Prometheus et/ou http://127.0.0.1:port/)
+        std::unique_ptr<sevens::RunMetrics> metrics;
+        std::unique_ptr<sevens::MetricsExporter> exporter;
+        if (cli.has("metrics-file") || cli.has("metrics-port")) {
+            uint64_t budgetNs = static_cast<uint64_t>(cli.getDouble("decision-budget-ms", 100.0) * 1e6);
+            metrics.reset(new sevens::RunMetrics(runner.threadCount(), runner.strategyNames(),
+                                                 cfg.matches, std::max<uint64_t>(budgetNs, 1)));
+            runner.setMetrics(metrics.get());
+
+            sevens::MetricsExporter::Config mcfg;
+            mcfg.file = cli.get("metrics-file", "");
+            mcfg.port = static_cast<int>(cli.getU64("metrics-port", 0));
+            mcfg.intervalSeconds = cli.getDouble("metrics-interval", 5.0);
+            exporter.reset(new sevens::MetricsExporter(*metrics, mcfg));
+        }
+
+        sevens::MatchReport report = runner.run();
+        exporter.reset();   // dernière publication
+        if (results) {
+            results->close();
+            std::cout << "[main] " << results->rowsWritten() << " rows written to " << cli.get("results", "") << '\n';
+        }
+        sevens::MatchRunner::print(report, std::cout);
+    }
+
+    // -------------------------------------------------------------------------
+    // COORDINATOR / WORKER (batch réparti sur plusieurs processus via TCP)  ───
+    // -------------------------------------------------------------------------
+    else if (mode == "coordinator") {
+        sevens::CommandLine cli(argc, argv, 2, {"matches", "max-score", "seed", "deals", "book", "bind", "port", "unit-size",
+                                           "unit-timeout"},
+                                {"fixed-seats"});
+        if (cli.args().size() < 2 || !cli.has("seed")) {
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
+            return 1;
+        }
+
+        sevens::CoordinatorConfig cfg;
+        cfg.run.specs = cli.args();
+        cfg.run.matches = cli.getU64("matches", 1000);
+        cfg.run.maxScore = cli.getU64("max-score", 50);
+        cfg.run.seed = cli.getU64("seed", 0);
+        cfg.run.rotateSeats = !cli.has("fixed-seats");
+        cfg.run.deals = cli.get("deals", "");
+        cfg.run.book = cli.get("book", "");
+        cfg.bind = cli.get("bind", "127.0.0.1");
+        cfg.port = static_cast<int>(cli.getU64("port", 7777));
+        cfg.unitSize = cli.getU64("unit-size", 64);
+        cfg.unitTimeoutSeconds = cli.getDouble("unit-timeout", 300.0);
+
+        sevens::Coordinator coordinator(cfg);
+        sevens::MatchRunner::print(coordinator.run(), std::cout);
+    }
+
+    else if (mode == "worker") {
+        sevens::CommandLine cli(argc, argv, 2, {"host", "port", "threads", "connect-timeout"});
+        sevens::RemoteWorkerConfig cfg;
+        cfg.host = cli.get("host", "127.0.0.1");
+        cfg.port = static_cast<int>(cli.getU64("port", 7777));
+        cfg.threads = static_cast<unsigned>(cli.getU64("threads", 0));
+        cfg.connectTimeoutSeconds = cli.getDouble("connect-timeout", 30.0);
+
+        uint64_t played = sevens::RemoteWorker::run(cfg);
+        std::cout << "[main] Worker done, " << played << " matches played\n";
+    }
+
+    // -------------------------------------------------------------------------
+    // GENCORPUS (donnes fixes, mappées en mémoire par batch / les modes classiques)
+    // -------------------------------------------------------------------------
+    else if (mode == "gencorpus") {
+        sevens::CommandLine cli(argc, argv, 2, {"deals", "players", "seed", "table-cards"}, {"unique"});
+        if (cli.args().size() != 1) {
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
+            return 1;
+        }
+        uint64_t deals = cli.getU64("deals", 1000000);
+        unsigned players = static_cast<unsigned>(cli.getU64("players", 4));
+        uint64_t seed = cli.getU64("seed", std::chrono::steady_clock::now().time_since_epoch().count());
+        unsigned tableCards = static_cast<unsigned>(cli.getU64("table-cards", 0));
+
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t redrawn = sevens::DealCorpus::generate(cli.args()[0], deals, players, seed, tableCards,
+                                                        cli.has("unique"));
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "[main] " << deals << " deals for " << players << " players (seed " << seed << ") written to "
+                  << cli.args()[0] << " in " << secs << " s\n";
+        if (cli.has("unique")) std::cout << "[main] " << redrawn << " deals equivalent up to suit symmetry drawn again\n";
+    }
+
+    // -------------------------------------------------------------------------
+    // TABLEBASE (fins de partie résolues, mappées en mémoire par les solveurs)  ─
+    // -------------------------------------------------------------------------
+    else if (mode == "tablebase") {
+        sevens::CommandLine cli(argc, argv, 2, {"players", "cards"});
+        if (cli.args().size() != 1) {
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
+            return 1;
+        }
+        unsigned players = static_cast<unsigned>(cli.getU64("players", 3));
+        unsigned cards = static_cast<unsigned>(cli.getU64("cards", 8));
+
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t positions = sevens::Tablebase::generate(cli.args()[0], players, cards);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "[main] " << positions << " positions for " << players << " players, up to " << cards
+                  << " cards left, written to " << cli.args()[0] << " in " << secs << " s\n";
+    }
+
+    // -------------------------------------------------------------------------
+    // BOOK (livre d'ouvertures appris par simulation, voir batch --book)  ──────
+    // -------------------------------------------------------------------------
+    else if (mode == "book") {
+        sevens::CommandLine cli(argc, argv, 2, {"players", "deals", "depth", "threads", "seed", "min-samples"});
+        if (cli.args().size() < 2) {
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
+            return 1;
+        }
+        sevens::OpeningBookConfig cfg;
+        cfg.specs.assign(cli.args().begin() + 1, cli.args().end());
+        cfg.players = static_cast<unsigned>(cli.getU64("players", 4));
+        cfg.deals = cli.getU64("deals", 100000);
+        cfg.depth = static_cast<unsigned>(cli.getU64("depth", 1));
+        cfg.threads = static_cast<unsigned>(cli.getU64("threads", 0));
+        cfg.seed = cli.getU64("seed", std::chrono::steady_clock::now().time_since_epoch().count());
+        cfg.minSamples = cli.getU64("min-samples", 8);
+
+        auto t0 = std::chrono::steady_clock::now();
+        sevens::OpeningBookStats stats = sevens::buildOpeningBook(cli.args()[0], cfg);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "[main] " << stats.decisions << " decisions sampled, " << stats.rollouts << " rollouts, "
+                  << stats.keys << " keys answered, written to " << cli.args()[0] << " in " << secs << " s\n";
+    }
+
+    // -------------------------------------------------------------------------
+    // SELFPLAY (données d'entraînement : une ligne par décision, en fragments)  ─
+    // -------------------------------------------------------------------------
+    else if (mode == "selfplay") {
+        sevens::CommandLine cli(argc, argv, 2, {"players", "games", "shard-games", "threads", "seed"}, {"fixed-seats"});
+        if (cli.args().size() < 2) {
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
+            return 1;
+        }
+        sevens::SelfPlayConfig cfg;
+        cfg.specs.assign(cli.args().begin() + 1, cli.args().end());
+        cfg.players = static_cast<unsigned>(cli.getU64("players", 4));
+        cfg.games = cli.getU64("games", 1000000);
+        cfg.shardGames = cli.getU64("shard-games", 16384);
+        cfg.threads = static_cast<unsigned>(cli.getU64("threads", 0));
+        cfg.seed = cli.getU64("seed", std::chrono::steady_clock::now().time_since_epoch().count());
+        cfg.fixedSeats = cli.has("fixed-seats");
+
+        auto t0 = std::chrono::steady_clock::now();
+        sevens::SelfPlayStats stats = sevens::runSelfPlay(cli.args()[0], cfg);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "[main] " << stats.games << " games, " << stats.records << " decisions in " << stats.shards
+                  << " shard(s) " << cli.args()[0] << "-*.svs (seed " << cfg.seed << ") in " << secs << " s ("
+                  << stats.records / secs << " decisions/s)\n";
+    }
+
+    // -------------------------------------------------------------------------
+    // TRAIN (politique apprise sur les fragments de self-play, voir LearnedStrategy) ─
+    // -------------------------------------------------------------------------
+    else if (mode == "train") {
+        sevens::CommandLine cli(argc, argv, 2, {"hidden", "epochs", "lr", "strategy", "seed"}, {"quantize"});
+        if (cli.args().size() < 2) {
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
+            return 1;
+        }
+        sevens::PolicyTrainerConfig cfg;
+        cfg.hidden = static_cast<unsigned>(cli.getU64("hidden", 32));
+        cfg.epochs = static_cast<unsigned>(cli.getU64("epochs", 4));
+        cfg.learningRate = cli.getDouble("lr", 0.05);
+        cfg.quantize = cli.has("quantize");
+        cfg.strategy = cli.has("strategy") ? static_cast<int>(cli.getU64("strategy", 0)) : -1;
+        cfg.seed = cli.getU64("seed", std::chrono::steady_clock::now().time_since_epoch().count());
+        std::vector<std::string> shards(cli.args().begin() + 1, cli.args().end());
+
+        auto t0 = std::chrono::steady_clock::now();
+        sevens::PolicyTrainerStats stats;
+        sevens::PolicyModel model = sevens::trainPolicy(shards, cfg, stats, [&](const sevens::PolicyEpoch& e) {
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            std::cout << "[main] epoch " << e.epoch << ": loss " << e.loss << ", validation loss "
+                      << e.validationLoss << ", accuracy " << 100.0 * e.validationAccuracy << " % (" << secs << " s)\n";
+        });
+        model.save(cli.args()[0]);
+        std::cout << "[main] " << (cfg.hidden ? "MLP " + std::to_string(cfg.hidden) : std::string("linear"))
+                  << (cfg.quantize ? " int8" : "") << " model trained on " << stats.training << " decisions ("
+                  << stats.validation << " held out, accuracy " << 100.0 * stats.accuracy << " %), written to "
+                  << cli.args()[0] << '\n';
+    }
+
+    // -------------------------------------------------------------------------
+    // CFR (Monte Carlo CFR sur une abstraction du jeu, voir CfrStrategy)  ──────
+    // -------------------------------------------------------------------------
+    else if (mode == "cfr") {
+        sevens::CommandLine cli(argc, argv, 2, {"players", "iterations", "threads", "seed", "table-bits", "window", "prune-after"},
+                                {"no-prune"});
+        if (cli.args().size() != 1) {
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
+            return 1;
+        }
+        sevens::CfrConfig cfg;
+        cfg.players = static_cast<unsigned>(cli.getU64("players", 4));
+        cfg.iterations = cli.getU64("iterations", 1000000);
+        cfg.threads = static_cast<unsigned>(cli.getU64("threads", 0));
+        cfg.seed = cli.getU64("seed", std::chrono::steady_clock::now().time_since_epoch().count());
+        cfg.tableBits = static_cast<unsigned>(cli.getU64("table-bits", 22));
+        cfg.window = static_cast<unsigned>(cli.getU64("window", 3));
+        cfg.prune = !cli.has("no-prune");
+        cfg.pruneAfter = cli.getU64("prune-after", 100000);
+
+        auto t0 = std::chrono::steady_clock::now();
+        sevens::CfrStats stats = sevens::trainCfr(cli.args()[0], cfg);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "[main] " << stats.iterations << " iterations, " << stats.nodes << " decisions in " << secs
+                  << " s (" << stats.iterations / secs << " iterations/s), " << stats.informationSets
+                  << " information sets (" << stats.overflow << " visits over capacity), " << stats.written
+                  << " written to " << cli.args()[0] << '\n';
+    }
+
+    // -------------------------------------------------------------------------
+    // EXPLOIT (gain d'une meilleure réponse échantillonnée contre les stratégies) ─
+    // -------------------------------------------------------------------------
+    else if (mode == "exploit") {
+        sevens::CommandLine cli(argc, argv, 2, {"players", "deals", "samples", "threads", "seed"});
+        if (cli.args().empty()) {
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
+            return 1;
+        }
+        sevens::ExploitConfig cfg;
+        cfg.specs = cli.args();
+        cfg.players = static_cast<unsigned>(cli.getU64("players", 4));
+        cfg.deals = cli.getU64("deals", 1000);
+        cfg.samples = static_cast<unsigned>(cli.getU64("samples", 8));
+        cfg.threads = static_cast<unsigned>(cli.getU64("threads", 0));
+        cfg.seed = cli.getU64("seed", std::chrono::steady_clock::now().time_since_epoch().count());
+
+        auto t0 = std::chrono::steady_clock::now();
+        sevens::ExploitReport r = sevens::evaluateExploitability(cfg);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "[main] " << r.deals << " deals, " << r.decisions << " decisions, " << r.rollouts
+                  << " rollouts in " << secs << " s (seed " << cfg.seed << ")\n"
+                  << "[main] cards left in the responding seat: " << r.baselineLeft << " as is, " << r.responseLeft
+                  << " best-responding\n"
+                  << "[main] exploitability: " << r.gain << " cards per round, 95% interval [" << r.gainLow << ", "
+                  << r.gainHigh << "]; round wins " << 100.0 * r.baselineWins << " % -> " << 100.0 * r.responseWins
+                  << " %\n";
+    }
+
+    // -------------------------------------------------------------------------
+    // VARIANT (plusieurs jeux de cartes, jusqu'à 16 joueurs, cartes de départ)  ─
+    // -------------------------------------------------------------------------
+    else if (mode == "variant") {
+        sevens::CommandLine cli(argc, argv, 2, {"decks", "players", "start", "rounds", "seed"});
+        if (cli.args().empty()) {
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
+            return 1;
+        }
+
+        sevens::RulesConfig rules;
+        rules.decks = static_cast<unsigned>(cli.getU64("decks", 1));
+        rules.players = static_cast<unsigned>(cli.getU64("players", 4));
+        if (cli.has("start")) rules.startCards = sevens::RulesConfig::parseCards(cli.get("start", ""));
+        rules.validate();
+        uint64_t rounds = cli.getU64("rounds", 1000);
+        uint64_t seed = cli.getU64("seed", std::chrono::steady_clock::now().time_since_epoch().count());
+
+        std::vector<sevens::StrategyFactory> factories;
+        for (const std::string& spec : cli.args()) factories.emplace_back(spec);
+        std::vector<std::shared_ptr<sevens::PlayerStrategy>> seats;
+        for (unsigned p = 0; p < rules.players; ++p) {
+            seats.push_back(factories[p % factories.size()].create(
+                sevens::MatchRunner::deriveSeed(seed, 0, 1 + p)));
+        }
+
+        std::cout << "[main] Variant mode → " << rules.decks << " deck(s), " << rules.players << " players, "
+                  << rules.startCards.size() << " start card(s), " << rounds << " rounds, seed " << seed << '\n';
+
+        auto t0 = std::chrono::steady_clock::now();
+        sevens::VariantTally tally = sevens::playVariantRounds(rules, seats, rounds, seed);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        for (size_t f = 0; f < factories.size(); ++f) {
+            uint64_t wins = 0, left = 0, seatRounds = 0;
+            for (size_t p = f; p < rules.players; p += factories.size()) {
+                wins += tally.wins[p];
+                left += tally.cardsLeft[p];
+                seatRounds += tally.rounds;
+            }
+            if (!seatRounds) continue;
+            std::cout << factories[f].name() << " | Seats: " << seatRounds / tally.rounds
+                      << " | Win Rate: " << 100.0 * wins / seatRounds << "%"
+                      << " | Avg cards left: " << static_cast<double>(left) / seatRounds << '\n';
+        }
+        std::cout << tally.rounds << " rounds in " << secs << " s (" << tally.rounds / secs << " rounds/s)\n";
+    }
+
+    // -------------------------------------------------------------------------
+    // EXPORT (fichier colonnaire → CSV / JSON lines, ou une seule colonne)  ───
+    // -------------------------------------------------------------------------
+    else if (mode == "export") {
+        sevens::CommandLine cli(argc, argv, 2, {"format", "column"});
+        if (cli.args().size() != 1) {
+            std::cerr << "[main] Usage: ./sevens_game " << usage(mode);
+            return 1;
+        }
+
+        sevens::ResultsReader reader(cli.args()[0]);
+        if (cli.has("column")) {
+            sevens::ResultColumn column;
+            if (!sevens::parseColumn(cli.get("column", ""), column)) {
+                std::cerr << "[main] Unknown column: " << cli.get("column", "") << '\n';
+                return 1;
+            }
+            for (uint64_t v : reader.column(column)) std::cout << v << '\n';
+        } else {
+            auto format = cli.get("format", "csv") == "jsonl" ? sevens::ResultsFormat::Jsonl
+                                                               : sevens::ResultsFormat::Csv;
+            sevens::ResultsReader::writeText(std::cout, format, reader.rows(), reader.strategies(), true);
+        }
+    }
+
     // -------------------------------------------------------------------------
     // MODE INCONNU  ────────────────────────────────────────────────────────────
     // -------------------------------------------------------------------------
@@ -154,3 +683,14 @@ int main(int argc, char* argv[]) {
 
     return 0;
 }
+
+// A malformed command line (unknown option, bad number...) stops with the usage of the mode
+int main(int argc, char* argv[]) {
+    try {
+        return run(argc, argv);
+    } catch (const std::logic_error& e) {
+        std::cerr << "[main] " << e.what() << '\n'
+                  << "[main] Usage: ./sevens_game " << usage(argc >= 2 ? argv[1] : "");
+        return 1;
+    }
+}